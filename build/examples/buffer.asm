@@ -0,0 +1,1557 @@
+BITS 64
+%define EVM_STACK_CAPACITY 1024
+%define EVM_RET_STACK_CAPACITY 1024
+%define EVM_WORD_SIZE 8
+%define EVM_MEMORY_CAPACITY 640000
+%define STDOUT 1
+%define SYS_EXIT 60
+%define SYS_WRITE 1
+%define EVM_SIZE 689216
+%define stack (evm + 0)
+%define stack_size (evm + 8192)
+%define memory (evm + 49200)
+segment .text
+global _start
+_start:
+	mov r15, stack
+	mov r14, stack
+	mov r13, frames
+	mov rsi, memory_init
+	mov rdi, memory
+	mov rcx, 57
+	rep movsb
+	jmp inst_241
+
+;; swap8:
+inst_0:
+	;; arg_get 1
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_1:
+	;; read8
+	add rax, memory
+	movzx eax, BYTE [rax]
+inst_2:
+	;; arg_get 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_3:
+	;; read8
+	add rax, memory
+	movzx eax, BYTE [rax]
+inst_4:
+	;; arg_get 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_5:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_6:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_7:
+	;; arg_get 0
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_8:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_9:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_10:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_11:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_12:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; reverse:
+inst_13:
+	;; arg_get 0
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_14:
+	;; push 2
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x2
+inst_15:
+	;; divi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rbx, -1
+	jne divide_15
+	neg rax
+	jmp divide_done_15
+divide_15:
+	cqo
+	idiv rbx
+divide_done_15:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; reverse_loop:
+inst_16:
+	;; local_get 0
+	mov rax, [r14 + EVM_WORD_SIZE * 0]
+inst_17:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_18:
+	;; eqi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	sete al
+	movzx rax, al
+inst_19:
+	;; jmp_if 40
+	test rax, rax
+	jnz inst_40
+inst_20:
+	;; arg_get 1
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_21:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_22:
+	;; arg_get 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_23:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_24:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_25:
+	;; minusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_26:
+	;; call
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_0
+inst_27:
+	;; local_get 0
+	mov rax, [r14 + EVM_WORD_SIZE * 0]
+inst_28:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_29:
+	;; minusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_30:
+	;; local_set 0
+	mov [r14 + EVM_WORD_SIZE * 0], rax
+inst_31:
+	;; arg_get 0
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_32:
+	;; push 2
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x2
+inst_33:
+	;; minusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_34:
+	;; arg_set 0
+	mov [r14 - EVM_WORD_SIZE * (0 + 1)], rax
+inst_35:
+	;; arg_get 1
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_36:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_37:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_38:
+	;; arg_set 1
+	mov [r14 - EVM_WORD_SIZE * (1 + 1)], rax
+inst_39:
+	;; jmp
+	jmp inst_16
+
+;; reverse_loop_end:
+inst_40:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_41:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_42:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_43:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; fabs:
+inst_44:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_45:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_46:
+	;; gef
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm0, xmm1
+	setae al
+	movzx rax, al
+inst_47:
+	;; jmp_if 50
+	test rax, rax
+	jnz inst_50
+inst_48:
+	;; push 9223372036854775808
+	mov rax, 0x8000000000000000
+inst_49:
+	;; xor
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rax, rbx
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; fabs_skip_negation@inline_fabs.0:
+inst_50:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; frac:
+inst_51:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_52:
+	;; f2i
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_53:
+	;; i2f
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_54:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_55:
+	;; ret
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; floor:
+inst_56:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_57:
+	;; f2i
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_58:
+	;; i2f
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_59:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_60:
+	;; swap 2
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_61:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_62:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_63:
+	;; lef
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	setae al
+	movzx rax, al
+inst_64:
+	;; jmp_if 67
+	test rax, rax
+	jnz inst_67
+inst_65:
+	;; push 4607182418800017408
+	mov rax, 0x3ff0000000000000
+inst_66:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; floor_skip_dec@inline_floor.0:
+inst_67:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; b:
+inst_68:
+	;; push 4607182418800017408
+	mov rax, 0x3ff0000000000000
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; b_loop_begin:
+inst_69:
+	;; arg_get 0
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_70:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_71:
+	;; lei
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	setle al
+	movzx rax, al
+inst_72:
+	;; jmp_if 80
+	test rax, rax
+	jnz inst_80
+inst_73:
+	;; push 4591870180066957722
+	mov rax, 0x3fb999999999999a
+inst_74:
+	;; multf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_75:
+	;; arg_get 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_76:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_77:
+	;; minusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_78:
+	;; arg_set 0
+	mov [r14 - EVM_WORD_SIZE * (0 + 1)], rax
+inst_79:
+	;; jmp
+	jmp inst_69
+
+;; b_loop_end:
+inst_80:
+	;; arg_set 0
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	mov [r14 - EVM_WORD_SIZE * (0 + 1)], rax
+inst_81:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; print_frac:
+inst_82:
+	;; push 10
+	mov rax, 0xa
+inst_83:
+	;; call
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_68
+inst_84:
+	;; push 4611686018427387904
+	mov rax, 0x4000000000000000
+inst_85:
+	;; divf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	divsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; print_frac_loop_begin:
+inst_86:
+	;; dup 1
+	mov rax, [r15 - EVM_WORD_SIZE * (1 + 1)]
+inst_87:
+	;; push 4621819117588971520
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x4024000000000000
+inst_88:
+	;; multf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_89:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_90:
+	;; f2i
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_91:
+	;; i2f
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_92:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_93:
+	;; swap 2
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_94:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_95:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_96:
+	;; lef
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	setae al
+	movzx rax, al
+inst_97:
+	;; jmp_if 100
+	test rax, rax
+	jnz inst_100
+inst_98:
+	;; push 4607182418800017408
+	mov rax, 0x3ff0000000000000
+inst_99:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; floor_skip_dec@inline_floor.1:
+inst_100:
+	;; swap 2
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_101:
+	;; push 4621819117588971520
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x4024000000000000
+inst_102:
+	;; multf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_103:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_104:
+	;; f2i
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_105:
+	;; i2f
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_106:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_107:
+	;; swap 2
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_108:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_109:
+	;; push 4621819117588971520
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x4024000000000000
+inst_110:
+	;; multf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_111:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_112:
+	;; dup 2
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, rbx
+inst_113:
+	;; dup 2
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, rbx
+inst_114:
+	;; ltf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	seta al
+	movzx rax, al
+inst_115:
+	;; jmp_if 133
+	test rax, rax
+	jnz inst_133
+inst_116:
+	;; dup 2
+	mov rax, [r15 - EVM_WORD_SIZE * (2 + 1)]
+inst_117:
+	;; dup 2
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, rbx
+inst_118:
+	;; push 4607182418800017408
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x3ff0000000000000
+inst_119:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_120:
+	;; minusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_121:
+	;; gtf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm0, xmm1
+	seta al
+	movzx rax, al
+inst_122:
+	;; jmp_if 133
+	test rax, rax
+	jnz inst_133
+inst_123:
+	;; f2i
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_124:
+	;; push 48
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x30
+inst_125:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_126:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_127:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_128:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_129:
+	;; push 0
+	mov rax, 0x0
+inst_130:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_131:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_132:
+	;; jmp
+	jmp inst_86
+
+;; print_frac_loop_end:
+inst_133:
+	;; dup 2
+	mov rax, [r15 - EVM_WORD_SIZE * (2 + 1)]
+inst_134:
+	;; push 4602678819172646912
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x3fe0000000000000
+inst_135:
+	;; lef
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	setae al
+	movzx rax, al
+inst_136:
+	;; jmp_if 139
+	test rax, rax
+	jnz inst_139
+inst_137:
+	;; push 4607182418800017408
+	mov rax, 0x3ff0000000000000
+inst_138:
+	;; plusf
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	addsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; print_frac_skip_inc:
+inst_139:
+	;; f2i
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_140:
+	;; push 48
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x30
+inst_141:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_142:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_143:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_144:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_145:
+	;; push 0
+	mov rax, 0x0
+inst_146:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_147:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_148:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_149:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_150:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; print_positive:
+inst_151:
+	;; push 0
+	mov rax, 0x0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; print_positive_loop:
+inst_152:
+	;; dup 1
+	mov rax, [r15 - EVM_WORD_SIZE * (1 + 1)]
+inst_153:
+	;; push 10
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0xa
+inst_154:
+	;; modu
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rdx, rdx
+	div rbx
+	mov rax, rdx
+inst_155:
+	;; push 48
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x30
+inst_156:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_157:
+	;; dup 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, rbx
+inst_158:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_159:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_160:
+	;; push 1
+	mov rax, 0x1
+inst_161:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_162:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_163:
+	;; push 10
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0xa
+inst_164:
+	;; divu
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rdx, rdx
+	div rbx
+inst_165:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_166:
+	;; dup 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, rbx
+inst_167:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_168:
+	;; equ
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	sete al
+	movzx rax, al
+inst_169:
+	;; not
+	test rax, rax
+	setz al
+	movzx rax, al
+inst_170:
+	;; jmp_if 152
+	test rax, rax
+	jnz inst_152
+inst_171:
+	;; push 0
+	mov rax, 0x0
+inst_172:
+	;; minusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_173:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_174:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_175:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_176:
+	;; call
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_13
+inst_177:
+	;; push 0
+	mov rax, 0x0
+inst_178:
+	;; swap 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_179:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_180:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_181:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; dump_f64:
+inst_182:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_183:
+	;; push 9223372036854775808
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x8000000000000000
+inst_184:
+	;; andb
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	and rax, rbx
+inst_185:
+	;; not
+	test rax, rax
+	setz al
+	movzx rax, al
+inst_186:
+	;; jmp_if 195
+	test rax, rax
+	jnz inst_195
+inst_187:
+	;; push 9223372036854775808
+	mov rax, 0x8000000000000000
+inst_188:
+	;; xor
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rax, rbx
+inst_189:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_190:
+	;; push 45
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x2d
+inst_191:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_192:
+	;; push 0
+	mov rax, 0x0
+inst_193:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_194:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+
+;; dump_f64_skip_negative:
+inst_195:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_196:
+	;; f2i
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_197:
+	;; call
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_151
+inst_198:
+	;; push 0
+	mov rax, 0x0
+inst_199:
+	;; push 46
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x2e
+inst_200:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_201:
+	;; push 0
+	mov rax, 0x0
+inst_202:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_203:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_204:
+	;; call
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_51
+inst_205:
+	;; call
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_82
+inst_206:
+	;; push 0
+	mov rax, 0x0
+inst_207:
+	;; push 10
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0xa
+inst_208:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_209:
+	;; push 0
+	mov rax, 0x0
+inst_210:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_211:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_212:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; dump_i64:
+inst_213:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_214:
+	;; push 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x0
+inst_215:
+	;; gei
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	setge al
+	movzx rax, al
+inst_216:
+	;; jmp_if 225
+	test rax, rax
+	jnz inst_225
+inst_217:
+	;; push 0
+	mov rax, 0x0
+inst_218:
+	;; push 45
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x2d
+inst_219:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_220:
+	;; push 0
+	mov rax, 0x0
+inst_221:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_222:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_223:
+	;; push 18446744073709551615
+	mov rax, 0xffffffffffffffff
+inst_224:
+	;; multi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	imul rax, rbx
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; dump_i64_skip_negation:
+inst_225:
+	;; call
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_151
+inst_226:
+	;; push 0
+	mov rax, 0x0
+inst_227:
+	;; push 10
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0xa
+inst_228:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_229:
+	;; push 0
+	mov rax, 0x0
+inst_230:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_231:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_232:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; dump_u64:
+inst_233:
+	;; call
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_151
+inst_234:
+	;; push 0
+	mov rax, 0x0
+inst_235:
+	;; push 10
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0xa
+inst_236:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_237:
+	;; push 0
+	mov rax, 0x0
+inst_238:
+	;; push 1
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1
+inst_239:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_240:
+	;; ret
+	cmp r13, frames
+	jbe stack_underflow
+	sub r13, EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+
+;; main:
+inst_241:
+	;; push 0
+	mov rax, 0x0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+
+;; fill:
+inst_242:
+	;; dup 0
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_243:
+	;; push 30
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1e
+inst_244:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_245:
+	;; dup 1
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, rbx
+inst_246:
+	;; push 97
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x61
+inst_247:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_248:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_249:
+	;; push 1
+	mov rax, 0x1
+inst_250:
+	;; plusi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_251:
+	;; dup 0
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+inst_252:
+	;; push 26
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1a
+inst_253:
+	;; eqi
+	mov rbx, rax
+	sub r15, EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	sete al
+	movzx rax, al
+inst_254:
+	;; jmp_if_not 242
+	test rax, rax
+	jz inst_242
+inst_255:
+	;; drop
+	sub r15, EVM_WORD_SIZE
+inst_256:
+	;; push 56
+	mov rax, 0x38
+inst_257:
+	;; push 10
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0xa
+inst_258:
+	;; write8
+	sub r15, EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, memory
+	mov BYTE [rsi], al
+inst_259:
+	;; push 26
+	mov rax, 0x1a
+inst_260:
+	;; call
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	cmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, EVM_WORD_SIZE
+	mov r14, r15
+	call inst_233
+inst_261:
+	;; push 30
+	mov rax, 0x1e
+inst_262:
+	;; push 27
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	mov rax, 0x1b
+inst_263:
+	mov [r15], rax
+	add r15, EVM_WORD_SIZE
+	;; native write
+	sub r15, EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, STDOUT
+	mov rax, SYS_WRITE
+	syscall
+inst_264:
+	;; halt
+	mov rax, SYS_EXIT
+	mov rdi, 0
+	syscall
+illegal_inst_access:
+	mov rax, SYS_EXIT
+	mov rdi, 4
+	syscall
+stack_overflow:
+	mov rax, SYS_EXIT
+	mov rdi, 1
+	syscall
+stack_underflow:
+	mov rax, SYS_EXIT
+	mov rdi, 2
+	syscall
+segment .data
+memory_init:
+	db 42, 42, 42, 42, 42,
+	db 42, 42, 42, 42, 42,
+	db 42, 42, 42, 42, 42,
+	db 42, 42, 42, 42, 42,
+	db 42, 42, 42, 42, 42,
+	db 42, 42, 42, 42, 42,
+	db 0, 0, 0, 0, 0,
+	db 0, 0, 0, 0, 0,
+	db 0, 0, 0, 0, 0,
+	db 0, 0, 0, 0, 0,
+	db 0, 0, 0, 0, 0,
+	db 0, 0,
+segment .bss
+frames: resq EVM_RET_STACK_CAPACITY
+alignb 8
+evm: resb EVM_SIZE
+section .note.GNU-stack noalloc noexec nowrite progbits
@@ -0,0 +1,914 @@
+// NOTE: generated by easm2c from examples/bits.easm
+// NOTE: -DEVM_EXTERN_IMPLEMENTATION to link src/evm.c compiled on its own instead
+#ifndef EVM_EXTERN_IMPLEMENTATION
+#define EVM_IMPLEMENTATION
+#endif // EVM_EXTERN_IMPLEMENTATION
+#include "evm.h"
+
+static EVM evm = { 0 };
+static inline int64_t f2i(double x) {
+	return x >= -9223372036854775808.0 && x < 9223372036854775808.0 ? (int64_t) x : INT64_MIN;
+}
+static const uint8_t memory_init[30] = {
+	42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+	42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42, 42,
+};
+
+static Err run(void) {
+	Word *const stack = evm.stack;
+	uint64_t sp = 0;
+	uint64_t fp = 0;
+	Inst_Addr rets[EVM_RET_STACK_CAPACITY];
+	uint64_t fps[EVM_RET_STACK_CAPACITY];
+	uint64_t rp = 0;
+	Err err = ERR_OK;
+	goto inst_241;
+	{
+	}
+inst_0:;
+	{
+	// arg_get 1
+	if (1ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t0 = stack[fp - 1 - 1];
+	// read8
+	if (t0.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	Word t1 = { .as_u64 = 0 };
+	memcpy(&t1, &evm.memory[t0.as_u64], 1);
+	// arg_get 0
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t1;
+	sp += 1;
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t2 = stack[fp - 1 - 0];
+	// read8
+	if (t2.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	Word t3 = { .as_u64 = 0 };
+	memcpy(&t3, &evm.memory[t2.as_u64], 1);
+	// arg_get 1
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t3;
+	sp += 1;
+	if (1ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t4 = stack[fp - 1 - 1];
+	// swap 1
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t5 = stack[sp - 1];
+	// write8
+	if (t4.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t4.as_u64], &t5, 1);
+	// arg_get 0
+	sp -= 1;
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t6 = stack[fp - 1 - 0];
+	// swap 1
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t7 = stack[sp - 1];
+	// write8
+	if (t6.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t6.as_u64], &t7, 1);
+	// drop
+	// drop
+	// ret
+	if (sp < 3) return ERR_STACK_UNDERFLOW;
+	sp -= 3;
+	goto ret;
+	}
+inst_13:;
+	{
+	// arg_get 0
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t8 = stack[fp - 1 - 0];
+	// push 2
+	Word t9 = { .as_u64 = 0x2ULL };
+	// divi
+	if (t9.as_i64 == 0) return ERR_DIV_BY_ZERO;
+	Word t10 = { .as_u64 = t9.as_i64 == -1 ? 0 - t8.as_u64 : (uint64_t) (t8.as_i64 / t9.as_i64) };
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t10;
+	sp += 1;
+	}
+inst_16:;
+	{
+	// local_get 0
+	if (fp >= sp || 0ULL >= sp - fp) return ERR_ILLEGAL_OPERAND;
+	Word t11 = stack[fp + 0];
+	// push 0
+	Word t12 = { .as_u64 = 0x0ULL };
+	// eqi
+	Word t13 = { .as_u64 = t11.as_i64 == t12.as_i64 };
+	// jmp_if 40
+	if (t13.as_u64) goto inst_40;
+	// arg_get 1
+	if (1ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t14 = stack[fp - 1 - 1];
+	// dup 0
+	// arg_get 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t14;
+	stack[sp - 0 + 1] = t14;
+	sp += 2;
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t15 = stack[fp - 1 - 0];
+	// plusi
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t16 = stack[sp - 1];
+	Word t17 = { .as_u64 = t16.as_u64 + t15.as_u64 };
+	// push 1
+	Word t18 = { .as_u64 = 0x1ULL };
+	// minusi
+	Word t19 = { .as_u64 = t17.as_u64 - t18.as_u64 };
+	// call 0
+	stack[sp - 1 + 0] = t19;
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 27;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_0;
+	}
+inst_27:;
+	{
+	// local_get 0
+	if (fp >= sp || 0ULL >= sp - fp) return ERR_ILLEGAL_OPERAND;
+	Word t20 = stack[fp + 0];
+	// push 1
+	Word t21 = { .as_u64 = 0x1ULL };
+	// minusi
+	Word t22 = { .as_u64 = t20.as_u64 - t21.as_u64 };
+	// local_set 0
+	if (fp >= sp || 0ULL >= sp - fp) return ERR_ILLEGAL_OPERAND;
+	stack[fp + 0] = t22;
+	// arg_get 0
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t23 = stack[fp - 1 - 0];
+	// push 2
+	Word t24 = { .as_u64 = 0x2ULL };
+	// minusi
+	Word t25 = { .as_u64 = t23.as_u64 - t24.as_u64 };
+	// arg_set 0
+	if (0ULL >= fp || fp - 1 - 0ULL >= sp) return ERR_ILLEGAL_OPERAND;
+	stack[fp - 1 - 0] = t25;
+	// arg_get 1
+	if (1ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t26 = stack[fp - 1 - 1];
+	// push 1
+	Word t27 = { .as_u64 = 0x1ULL };
+	// plusi
+	Word t28 = { .as_u64 = t26.as_u64 + t27.as_u64 };
+	// arg_set 1
+	if (1ULL >= fp || fp - 1 - 1ULL >= sp) return ERR_ILLEGAL_OPERAND;
+	stack[fp - 1 - 1] = t28;
+	// jmp 16
+	goto inst_16;
+	}
+inst_40:;
+	{
+	// drop
+	// drop
+	// drop
+	// ret
+	if (sp < 3) return ERR_STACK_UNDERFLOW;
+	sp -= 3;
+	goto ret;
+	}
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t29 = stack[sp - 1];
+	// push 0
+	Word t30 = { .as_u64 = 0x0ULL };
+	// gef
+	Word t31 = { .as_u64 = t29.as_f64 >= t30.as_f64 };
+	// jmp_if 50
+	stack[sp - 1 + 0] = t29;
+	if (t31.as_u64) goto inst_50;
+	// push 9223372036854775808
+	Word t32 = { .as_u64 = 0x8000000000000000ULL };
+	// xor
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t33 = stack[sp - 1];
+	Word t34 = { .as_u64 = t33.as_u64 ^ t32.as_u64 };
+	stack[sp - 1 + 0] = t34;
+	}
+inst_50:;
+	{
+	// ret
+	goto ret;
+	}
+inst_51:;
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t35 = stack[sp - 1];
+	// f2i
+	Word t36 = { .as_i64 = f2i(t35.as_f64) };
+	// i2f
+	Word t37 = { .as_f64 = (double) t36.as_i64 };
+	// minusf
+	Word t38 = { .as_f64 = t35.as_f64 - t37.as_f64 };
+	// ret
+	stack[sp - 1 + 0] = t38;
+	goto ret;
+	}
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t39 = stack[sp - 1];
+	// f2i
+	Word t40 = { .as_i64 = f2i(t39.as_f64) };
+	// i2f
+	Word t41 = { .as_f64 = (double) t40.as_i64 };
+	// dup 0
+	// swap 2
+	// minusf
+	Word t42 = { .as_f64 = t41.as_f64 - t39.as_f64 };
+	// push 0
+	Word t43 = { .as_u64 = 0x0ULL };
+	// lef
+	Word t44 = { .as_u64 = t42.as_f64 <= t43.as_f64 };
+	// jmp_if 67
+	stack[sp - 1 + 0] = t41;
+	if (t44.as_u64) goto inst_67;
+	// push 4607182418800017408
+	Word t45 = { .as_u64 = 0x3ff0000000000000ULL };
+	// minusf
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t46 = stack[sp - 1];
+	Word t47 = { .as_f64 = t46.as_f64 - t45.as_f64 };
+	stack[sp - 1 + 0] = t47;
+	}
+inst_67:;
+	{
+	// ret
+	goto ret;
+	}
+inst_68:;
+	{
+	// push 4607182418800017408
+	Word t48 = { .as_u64 = 0x3ff0000000000000ULL };
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t48;
+	sp += 1;
+	}
+inst_69:;
+	{
+	// arg_get 0
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t49 = stack[fp - 1 - 0];
+	// push 0
+	Word t50 = { .as_u64 = 0x0ULL };
+	// lei
+	Word t51 = { .as_u64 = t49.as_i64 <= t50.as_i64 };
+	// jmp_if 80
+	if (t51.as_u64) goto inst_80;
+	// push 4591870180066957722
+	Word t52 = { .as_u64 = 0x3fb999999999999aULL };
+	// multf
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t53 = stack[sp - 1];
+	Word t54 = { .as_f64 = t53.as_f64 * t52.as_f64 };
+	// arg_get 0
+	stack[sp - 1 + 0] = t54;
+	if (0ULL >= fp) return ERR_ILLEGAL_OPERAND;
+	Word t55 = stack[fp - 1 - 0];
+	// push 1
+	Word t56 = { .as_u64 = 0x1ULL };
+	// minusi
+	Word t57 = { .as_u64 = t55.as_u64 - t56.as_u64 };
+	// arg_set 0
+	if (0ULL >= fp || fp - 1 - 0ULL >= sp) return ERR_ILLEGAL_OPERAND;
+	stack[fp - 1 - 0] = t57;
+	// jmp 69
+	goto inst_69;
+	}
+inst_80:;
+	{
+	// arg_set 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t58 = stack[sp - 1];
+	sp -= 1;
+	if (0ULL >= fp || fp - 1 - 0ULL >= sp) return ERR_ILLEGAL_OPERAND;
+	stack[fp - 1 - 0] = t58;
+	// ret
+	goto ret;
+	}
+inst_82:;
+	{
+	// push 10
+	Word t59 = { .as_u64 = 0xaULL };
+	// call 68
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t59;
+	sp += 1;
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 84;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_68;
+	}
+inst_84:;
+	{
+	// push 4611686018427387904
+	Word t60 = { .as_u64 = 0x4000000000000000ULL };
+	// divf
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t61 = stack[sp - 1];
+	Word t62 = { .as_f64 = t61.as_f64 / t60.as_f64 };
+	stack[sp - 1 + 0] = t62;
+	}
+inst_86:;
+	{
+	// dup 1
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t63 = stack[sp - 1];
+	if (sp < 2) return ERR_STACK_UNDERFLOW;
+	Word t64 = stack[sp - 2];
+	// push 4621819117588971520
+	Word t65 = { .as_u64 = 0x4024000000000000ULL };
+	// multf
+	Word t66 = { .as_f64 = t64.as_f64 * t65.as_f64 };
+	// dup 0
+	// f2i
+	Word t67 = { .as_i64 = f2i(t66.as_f64) };
+	// i2f
+	Word t68 = { .as_f64 = (double) t67.as_i64 };
+	// dup 0
+	// swap 2
+	// minusf
+	Word t69 = { .as_f64 = t68.as_f64 - t66.as_f64 };
+	// push 0
+	Word t70 = { .as_u64 = 0x0ULL };
+	// lef
+	Word t71 = { .as_u64 = t69.as_f64 <= t70.as_f64 };
+	// jmp_if 100
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 2 + 0] = t64;
+	stack[sp - 2 + 1] = t63;
+	stack[sp - 2 + 2] = t68;
+	sp += 1;
+	if (t71.as_u64) goto inst_100;
+	// push 4607182418800017408
+	Word t72 = { .as_u64 = 0x3ff0000000000000ULL };
+	// minusf
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t73 = stack[sp - 1];
+	Word t74 = { .as_f64 = t73.as_f64 - t72.as_f64 };
+	stack[sp - 1 + 0] = t74;
+	}
+inst_100:;
+	{
+	// swap 2
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t75 = stack[sp - 1];
+	if (sp < 2) return ERR_STACK_UNDERFLOW;
+	Word t76 = stack[sp - 2];
+	if (sp < 3) return ERR_STACK_UNDERFLOW;
+	Word t77 = stack[sp - 3];
+	// push 4621819117588971520
+	Word t78 = { .as_u64 = 0x4024000000000000ULL };
+	// multf
+	Word t79 = { .as_f64 = t77.as_f64 * t78.as_f64 };
+	// dup 0
+	// f2i
+	Word t80 = { .as_i64 = f2i(t79.as_f64) };
+	// i2f
+	Word t81 = { .as_f64 = (double) t80.as_i64 };
+	// minusf
+	Word t82 = { .as_f64 = t79.as_f64 - t81.as_f64 };
+	// swap 2
+	// swap 1
+	// push 4621819117588971520
+	Word t83 = { .as_u64 = 0x4024000000000000ULL };
+	// multf
+	Word t84 = { .as_f64 = t76.as_f64 * t83.as_f64 };
+	// swap 1
+	// dup 2
+	// dup 2
+	// ltf
+	Word t85 = { .as_u64 = t82.as_f64 < t84.as_f64 };
+	// jmp_if 133
+	stack[sp - 3 + 0] = t82;
+	stack[sp - 3 + 1] = t84;
+	stack[sp - 3 + 2] = t75;
+	if (t85.as_u64) goto inst_133;
+	// dup 2
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t86 = stack[sp - 1];
+	if (sp < 2) return ERR_STACK_UNDERFLOW;
+	Word t87 = stack[sp - 2];
+	if (sp < 3) return ERR_STACK_UNDERFLOW;
+	Word t88 = stack[sp - 3];
+	// dup 2
+	// push 4607182418800017408
+	Word t89 = { .as_u64 = 0x3ff0000000000000ULL };
+	// swap 1
+	// minusf
+	Word t90 = { .as_f64 = t89.as_f64 - t87.as_f64 };
+	// gtf
+	Word t91 = { .as_u64 = t88.as_f64 > t90.as_f64 };
+	// jmp_if 133
+	stack[sp - 3 + 0] = t88;
+	stack[sp - 3 + 1] = t87;
+	stack[sp - 3 + 2] = t86;
+	if (t91.as_u64) goto inst_133;
+	// f2i
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t92 = stack[sp - 1];
+	Word t93 = { .as_i64 = f2i(t92.as_f64) };
+	// push 48
+	Word t94 = { .as_u64 = 0x30ULL };
+	// plusi
+	Word t95 = { .as_u64 = t93.as_u64 + t94.as_u64 };
+	// push 0
+	Word t96 = { .as_u64 = 0x0ULL };
+	// swap 1
+	// write8
+	if (t96.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t96.as_u64], &t95, 1);
+	// push 0
+	Word t97 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t98 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t97;
+	stack[sp - 1 + 1] = t98;
+	sp += 1;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// jmp 86
+	goto inst_86;
+	}
+inst_133:;
+	{
+	// dup 2
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t99 = stack[sp - 1];
+	if (sp < 2) return ERR_STACK_UNDERFLOW;
+	Word t100 = stack[sp - 2];
+	if (sp < 3) return ERR_STACK_UNDERFLOW;
+	Word t101 = stack[sp - 3];
+	// push 4602678819172646912
+	Word t102 = { .as_u64 = 0x3fe0000000000000ULL };
+	// lef
+	Word t103 = { .as_u64 = t101.as_f64 <= t102.as_f64 };
+	// jmp_if 139
+	stack[sp - 3 + 0] = t101;
+	stack[sp - 3 + 1] = t100;
+	stack[sp - 3 + 2] = t99;
+	if (t103.as_u64) goto inst_139;
+	// push 4607182418800017408
+	Word t104 = { .as_u64 = 0x3ff0000000000000ULL };
+	// plusf
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t105 = stack[sp - 1];
+	Word t106 = { .as_f64 = t105.as_f64 + t104.as_f64 };
+	stack[sp - 1 + 0] = t106;
+	}
+inst_139:;
+	{
+	// f2i
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t107 = stack[sp - 1];
+	Word t108 = { .as_i64 = f2i(t107.as_f64) };
+	// push 48
+	Word t109 = { .as_u64 = 0x30ULL };
+	// plusi
+	Word t110 = { .as_u64 = t108.as_u64 + t109.as_u64 };
+	// push 0
+	Word t111 = { .as_u64 = 0x0ULL };
+	// swap 1
+	// write8
+	if (t111.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t111.as_u64], &t110, 1);
+	// push 0
+	Word t112 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t113 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t112;
+	stack[sp - 1 + 1] = t113;
+	sp += 1;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// drop
+	// drop
+	// ret
+	if (sp < 2) return ERR_STACK_UNDERFLOW;
+	sp -= 2;
+	goto ret;
+	}
+inst_151:;
+	{
+	// push 0
+	Word t114 = { .as_u64 = 0x0ULL };
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t114;
+	sp += 1;
+	}
+inst_152:;
+	{
+	// dup 1
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t115 = stack[sp - 1];
+	if (sp < 2) return ERR_STACK_UNDERFLOW;
+	Word t116 = stack[sp - 2];
+	// push 10
+	Word t117 = { .as_u64 = 0xaULL };
+	// modu
+	if (t117.as_u64 == 0) return ERR_DIV_BY_ZERO;
+	Word t118 = { .as_u64 = t116.as_u64 % t117.as_u64 };
+	// push 48
+	Word t119 = { .as_u64 = 0x30ULL };
+	// plusi
+	Word t120 = { .as_u64 = t118.as_u64 + t119.as_u64 };
+	// dup 1
+	// swap 1
+	// write8
+	if (t115.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t115.as_u64], &t120, 1);
+	// push 1
+	Word t121 = { .as_u64 = 0x1ULL };
+	// plusi
+	Word t122 = { .as_u64 = t115.as_u64 + t121.as_u64 };
+	// swap 1
+	// push 10
+	Word t123 = { .as_u64 = 0xaULL };
+	// divu
+	if (t123.as_u64 == 0) return ERR_DIV_BY_ZERO;
+	Word t124 = { .as_u64 = t116.as_u64 / t123.as_u64 };
+	// swap 1
+	// dup 1
+	// push 0
+	Word t125 = { .as_u64 = 0x0ULL };
+	// equ
+	Word t126 = { .as_u64 = t124.as_u64 == t125.as_u64 };
+	// not
+	Word t127 = { .as_u64 = !t126.as_u64 };
+	// jmp_if 152
+	stack[sp - 2 + 0] = t124;
+	stack[sp - 2 + 1] = t122;
+	if (t127.as_u64) goto inst_152;
+	// push 0
+	Word t128 = { .as_u64 = 0x0ULL };
+	// minusi
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t129 = stack[sp - 1];
+	Word t130 = { .as_u64 = t129.as_u64 - t128.as_u64 };
+	// dup 0
+	// push 0
+	Word t131 = { .as_u64 = 0x0ULL };
+	// swap 1
+	// call 13
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t130;
+	stack[sp - 1 + 1] = t131;
+	stack[sp - 1 + 2] = t130;
+	sp += 2;
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 177;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_13;
+	}
+inst_177:;
+	{
+	// push 0
+	Word t132 = { .as_u64 = 0x0ULL };
+	// swap 1
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t133 = stack[sp - 1];
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t132;
+	stack[sp - 1 + 1] = t133;
+	sp += 1;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// drop
+	// ret
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	sp -= 1;
+	goto ret;
+	}
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t134 = stack[sp - 1];
+	// push 9223372036854775808
+	Word t135 = { .as_u64 = 0x8000000000000000ULL };
+	// andb
+	Word t136 = { .as_u64 = t134.as_u64 & t135.as_u64 };
+	// not
+	Word t137 = { .as_u64 = !t136.as_u64 };
+	// jmp_if 195
+	stack[sp - 1 + 0] = t134;
+	if (t137.as_u64) goto inst_195;
+	// push 9223372036854775808
+	Word t138 = { .as_u64 = 0x8000000000000000ULL };
+	// xor
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t139 = stack[sp - 1];
+	Word t140 = { .as_u64 = t139.as_u64 ^ t138.as_u64 };
+	// push 0
+	Word t141 = { .as_u64 = 0x0ULL };
+	// push 45
+	Word t142 = { .as_u64 = 0x2dULL };
+	// write8
+	if (t141.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t141.as_u64], &t142, 1);
+	// push 0
+	Word t143 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t144 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t140;
+	stack[sp - 1 + 1] = t143;
+	stack[sp - 1 + 2] = t144;
+	sp += 2;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	}
+inst_195:;
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t145 = stack[sp - 1];
+	// f2i
+	Word t146 = { .as_i64 = f2i(t145.as_f64) };
+	// call 151
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t145;
+	stack[sp - 1 + 1] = t146;
+	sp += 1;
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 198;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_151;
+	}
+inst_198:;
+	{
+	// push 0
+	Word t147 = { .as_u64 = 0x0ULL };
+	// push 46
+	Word t148 = { .as_u64 = 0x2eULL };
+	// write8
+	if (t147.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t147.as_u64], &t148, 1);
+	// push 0
+	Word t149 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t150 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t149;
+	stack[sp - 0 + 1] = t150;
+	sp += 2;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// call 51
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 205;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_51;
+	}
+inst_205:;
+	{
+	// call 82
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 206;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_82;
+	}
+inst_206:;
+	{
+	// push 0
+	Word t151 = { .as_u64 = 0x0ULL };
+	// push 10
+	Word t152 = { .as_u64 = 0xaULL };
+	// write8
+	if (t151.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t151.as_u64], &t152, 1);
+	// push 0
+	Word t153 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t154 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t153;
+	stack[sp - 0 + 1] = t154;
+	sp += 2;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// ret
+	goto ret;
+	}
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t155 = stack[sp - 1];
+	// push 0
+	Word t156 = { .as_u64 = 0x0ULL };
+	// gei
+	Word t157 = { .as_u64 = t155.as_i64 >= t156.as_i64 };
+	// jmp_if 225
+	stack[sp - 1 + 0] = t155;
+	if (t157.as_u64) goto inst_225;
+	// push 0
+	Word t158 = { .as_u64 = 0x0ULL };
+	// push 45
+	Word t159 = { .as_u64 = 0x2dULL };
+	// write8
+	if (t158.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t158.as_u64], &t159, 1);
+	// push 0
+	Word t160 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t161 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t160;
+	stack[sp - 0 + 1] = t161;
+	sp += 2;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// push 18446744073709551615
+	Word t162 = { .as_u64 = 0xffffffffffffffffULL };
+	// multi
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t163 = stack[sp - 1];
+	Word t164 = { .as_i64 = t163.as_i64 * t162.as_i64 };
+	stack[sp - 1 + 0] = t164;
+	}
+inst_225:;
+	{
+	// call 151
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 226;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_151;
+	}
+inst_226:;
+	{
+	// push 0
+	Word t165 = { .as_u64 = 0x0ULL };
+	// push 10
+	Word t166 = { .as_u64 = 0xaULL };
+	// write8
+	if (t165.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t165.as_u64], &t166, 1);
+	// push 0
+	Word t167 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t168 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t167;
+	stack[sp - 0 + 1] = t168;
+	sp += 2;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// ret
+	goto ret;
+	}
+inst_233:;
+	{
+	// call 151
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 234;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_151;
+	}
+inst_234:;
+	{
+	// push 0
+	Word t169 = { .as_u64 = 0x0ULL };
+	// push 10
+	Word t170 = { .as_u64 = 0xaULL };
+	// write8
+	if (t169.as_u64 >= EVM_MEMORY_CAPACITY - 0) return ERR_ILLEGAL_MEMORY_ACCESS;
+	memcpy(&evm.memory[t169.as_u64], &t170, 1);
+	// push 0
+	Word t171 = { .as_u64 = 0x0ULL };
+	// push 1
+	Word t172 = { .as_u64 = 0x1ULL };
+	// native 0
+	if (sp > EVM_STACK_CAPACITY - 2) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t171;
+	stack[sp - 0 + 1] = t172;
+	sp += 2;
+	evm.stack_size = sp;
+	err = evm_write(&evm);
+	if (err != ERR_OK) return err;
+	sp = evm.stack_size;
+	// ret
+	goto ret;
+	}
+inst_241:;
+	{
+	// push 69420
+	Word t173 = { .as_u64 = 0x10f2cULL };
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 0 + 0] = t173;
+	sp += 1;
+	}
+inst_242:;
+	{
+	// dup 0
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t174 = stack[sp - 1];
+	// push 1
+	Word t175 = { .as_u64 = 0x1ULL };
+	// andb
+	Word t176 = { .as_u64 = t174.as_u64 & t175.as_u64 };
+	// call 233
+	if (sp > EVM_STACK_CAPACITY - 1) return ERR_STACK_OVERFLOW;
+	stack[sp - 1 + 0] = t174;
+	stack[sp - 1 + 1] = t176;
+	sp += 1;
+	if (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	rets[rp] = 246;
+	fps[rp] = fp;
+	rp += 1;
+	fp = sp;
+	goto inst_233;
+	}
+inst_246:;
+	{
+	// push 1
+	Word t177 = { .as_u64 = 0x1ULL };
+	// shr
+	if (sp < 1) return ERR_STACK_UNDERFLOW;
+	Word t178 = stack[sp - 1];
+	Word t179 = { .as_u64 = t178.as_u64 >> t177.as_u64 };
+	// dup 0
+	// push 0
+	Word t180 = { .as_u64 = 0x0ULL };
+	// eqi
+	Word t181 = { .as_u64 = t179.as_i64 == t180.as_i64 };
+	// not
+	Word t182 = { .as_u64 = !t181.as_u64 };
+	// jmp_if 242
+	stack[sp - 1 + 0] = t179;
+	if (t182.as_u64) goto inst_242;
+	// halt
+	return ERR_OK;
+	}
+	return ERR_ILLEGAL_INST_ACCESS;
+ret:
+	if (rp == 0) return ERR_STACK_UNDERFLOW;
+	rp -= 1;
+	fp = fps[rp];
+	switch (rets[rp]) {
+		case 27: goto inst_27;
+		case 84: goto inst_84;
+		case 177: goto inst_177;
+		case 198: goto inst_198;
+		case 205: goto inst_205;
+		case 206: goto inst_206;
+		case 226: goto inst_226;
+		case 234: goto inst_234;
+		case 246: goto inst_246;
+	}
+	return ERR_ILLEGAL_INST_ACCESS;
+}
+
+int main(void) {
+	memcpy(evm.memory, memory_init, sizeof(memory_init));
+	const Err err = run();
+	if (err != ERR_OK) {
+		fprintf(stderr, "ERROR: %s\n", err_as_cstr(err));
+		return (int) err;
+	}
+	return 0;
+}
@@ -0,0 +1,1148 @@
+.intel_syntax noprefix
+.set EVM_STACK_CAPACITY, 1024
+.set EVM_RET_STACK_CAPACITY, 1024
+.set EVM_WORD_SIZE, 8
+.set EVM_MEMORY_CAPACITY, 640000
+.set STDOUT, 1
+.set SYS_EXIT, 60
+.set SYS_WRITE, 1
+.set EVM_SIZE, 689216
+.set stack, (evm + 0)
+.set stack_size, (evm + 8192)
+.set memory, (evm + 49200)
+.text
+.globl _start
+_start:
+	mov r15, OFFSET stack
+	mov r14, OFFSET stack
+	mov r13, OFFSET frames
+	mov rsi, OFFSET memory_init
+	mov rdi, OFFSET memory
+	mov rcx, 30
+	rep movsb
+	jmp inst_241
+inst_0:
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_1:
+	add rax, OFFSET memory
+	movzx eax, BYTE PTR [rax]
+inst_2:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_3:
+	add rax, OFFSET memory
+	movzx eax, BYTE PTR [rax]
+inst_4:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_5:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_6:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_7:
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_8:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_9:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_10:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_11:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_12:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_13:
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_14:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x2
+inst_15:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rbx, -1
+	jne divide_15
+	neg rax
+	jmp divide_done_15
+divide_15:
+	cqo
+	idiv rbx
+divide_done_15:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_16:
+	mov rax, [r14 + EVM_WORD_SIZE * 0]
+inst_17:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_18:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	sete al
+	movzx rax, al
+inst_19:
+	test rax, rax
+	jnz inst_40
+inst_20:
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_21:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_22:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_23:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_24:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_25:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_26:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_0
+inst_27:
+	mov rax, [r14 + EVM_WORD_SIZE * 0]
+inst_28:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_29:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_30:
+	mov [r14 + EVM_WORD_SIZE * 0], rax
+inst_31:
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_32:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x2
+inst_33:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_34:
+	mov [r14 - EVM_WORD_SIZE * (0 + 1)], rax
+inst_35:
+	mov rax, [r14 - EVM_WORD_SIZE * (1 + 1)]
+inst_36:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_37:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_38:
+	mov [r14 - EVM_WORD_SIZE * (1 + 1)], rax
+inst_39:
+	jmp inst_16
+inst_40:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_41:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_42:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_43:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_44:
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_45:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_46:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm0, xmm1
+	setae al
+	movzx rax, al
+inst_47:
+	test rax, rax
+	jnz inst_50
+inst_48:
+	mov rax, 0x8000000000000000
+inst_49:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rax, rbx
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_50:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_51:
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_52:
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_53:
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_54:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_55:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_56:
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_57:
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_58:
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_59:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_60:
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_61:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_62:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_63:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	setae al
+	movzx rax, al
+inst_64:
+	test rax, rax
+	jnz inst_67
+inst_65:
+	mov rax, 0x3ff0000000000000
+inst_66:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_67:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_68:
+	mov rax, 0x3ff0000000000000
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_69:
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_70:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_71:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	setle al
+	movzx rax, al
+inst_72:
+	test rax, rax
+	jnz inst_80
+inst_73:
+	mov rax, 0x3fb999999999999a
+inst_74:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_75:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r14 - EVM_WORD_SIZE * (0 + 1)]
+inst_76:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_77:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_78:
+	mov [r14 - EVM_WORD_SIZE * (0 + 1)], rax
+inst_79:
+	jmp inst_69
+inst_80:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	mov [r14 - EVM_WORD_SIZE * (0 + 1)], rax
+inst_81:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_82:
+	mov rax, 0xa
+inst_83:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_68
+inst_84:
+	mov rax, 0x4000000000000000
+inst_85:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	divsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_86:
+	mov rax, [r15 - EVM_WORD_SIZE * (1 + 1)]
+inst_87:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x4024000000000000
+inst_88:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_89:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_90:
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_91:
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_92:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_93:
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_94:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_95:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_96:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	setae al
+	movzx rax, al
+inst_97:
+	test rax, rax
+	jnz inst_100
+inst_98:
+	mov rax, 0x3ff0000000000000
+inst_99:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_100:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_101:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x4024000000000000
+inst_102:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_103:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_104:
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_105:
+	cvtsi2sd xmm0, rax
+	movq rax, xmm0
+inst_106:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_107:
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15 - EVM_WORD_SIZE * 2], rax
+	mov rax, rbx
+inst_108:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_109:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x4024000000000000
+inst_110:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	mulsd xmm0, xmm1
+	movq rax, xmm0
+inst_111:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_112:
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, rbx
+inst_113:
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, rbx
+inst_114:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	seta al
+	movzx rax, al
+inst_115:
+	test rax, rax
+	jnz inst_133
+inst_116:
+	mov rax, [r15 - EVM_WORD_SIZE * (2 + 1)]
+inst_117:
+	mov rbx, [r15 - EVM_WORD_SIZE * 2]
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, rbx
+inst_118:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x3ff0000000000000
+inst_119:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_120:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	subsd xmm0, xmm1
+	movq rax, xmm0
+inst_121:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm0, xmm1
+	seta al
+	movzx rax, al
+inst_122:
+	test rax, rax
+	jnz inst_133
+inst_123:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_124:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x30
+inst_125:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_126:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_127:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_128:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_129:
+	mov rax, 0x0
+inst_130:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_131:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_132:
+	jmp inst_86
+inst_133:
+	mov rax, [r15 - EVM_WORD_SIZE * (2 + 1)]
+inst_134:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x3fe0000000000000
+inst_135:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	ucomisd xmm1, xmm0
+	setae al
+	movzx rax, al
+inst_136:
+	test rax, rax
+	jnz inst_139
+inst_137:
+	mov rax, 0x3ff0000000000000
+inst_138:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	movq xmm1, rbx
+	addsd xmm0, xmm1
+	movq rax, xmm0
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_139:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_140:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x30
+inst_141:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_142:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_143:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_144:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_145:
+	mov rax, 0x0
+inst_146:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_147:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_148:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_149:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_150:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_151:
+	mov rax, 0x0
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_152:
+	mov rax, [r15 - EVM_WORD_SIZE * (1 + 1)]
+inst_153:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0xa
+inst_154:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rdx, rdx
+	div rbx
+	mov rax, rdx
+inst_155:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x30
+inst_156:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_157:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, rbx
+inst_158:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_159:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_160:
+	mov rax, 0x1
+inst_161:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	add rax, rbx
+inst_162:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_163:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0xa
+inst_164:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rdx, rdx
+	div rbx
+inst_165:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_166:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, rbx
+inst_167:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_168:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	sete al
+	movzx rax, al
+inst_169:
+	test rax, rax
+	setz al
+	movzx rax, al
+inst_170:
+	test rax, rax
+	jnz inst_152
+inst_171:
+	mov rax, 0x0
+inst_172:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	sub rax, rbx
+inst_173:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_174:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_175:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_176:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_13
+inst_177:
+	mov rax, 0x0
+inst_178:
+	mov rbx, [r15 - EVM_WORD_SIZE * 1]
+	mov [r15 - EVM_WORD_SIZE * 1], rax
+	mov rax, rbx
+inst_179:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_180:
+	sub r15, OFFSET EVM_WORD_SIZE
+inst_181:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_182:
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_183:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x8000000000000000
+inst_184:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	and rax, rbx
+inst_185:
+	test rax, rax
+	setz al
+	movzx rax, al
+inst_186:
+	test rax, rax
+	jnz inst_195
+inst_187:
+	mov rax, 0x8000000000000000
+inst_188:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	xor rax, rbx
+inst_189:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_190:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x2d
+inst_191:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_192:
+	mov rax, 0x0
+inst_193:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_194:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_195:
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_196:
+	movq xmm0, rax
+	cvttsd2si rax, xmm0
+inst_197:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_151
+inst_198:
+	mov rax, 0x0
+inst_199:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x2e
+inst_200:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_201:
+	mov rax, 0x0
+inst_202:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_203:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_204:
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_51
+inst_205:
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_82
+inst_206:
+	mov rax, 0x0
+inst_207:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0xa
+inst_208:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_209:
+	mov rax, 0x0
+inst_210:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_211:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_212:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_213:
+	mov rax, [r15 - EVM_WORD_SIZE * (0 + 1)]
+inst_214:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x0
+inst_215:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	cmp rax, rbx
+	setge al
+	movzx rax, al
+inst_216:
+	test rax, rax
+	jnz inst_225
+inst_217:
+	mov rax, 0x0
+inst_218:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x2d
+inst_219:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_220:
+	mov rax, 0x0
+inst_221:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_222:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_223:
+	mov rax, 0xffffffffffffffff
+inst_224:
+	mov rbx, rax
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rax, [r15]
+	imul rax, rbx
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+inst_225:
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_151
+inst_226:
+	mov rax, 0x0
+inst_227:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0xa
+inst_228:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_229:
+	mov rax, 0x0
+inst_230:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_231:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_232:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_233:
+	cmp r13, OFFSET frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE
+	jae stack_overflow
+	mov [r13], r14
+	add r13, OFFSET EVM_WORD_SIZE
+	mov r14, r15
+	call inst_151
+inst_234:
+	mov rax, 0x0
+inst_235:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0xa
+inst_236:
+	sub r15, OFFSET EVM_WORD_SIZE
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov BYTE PTR [rsi], al
+inst_237:
+	mov rax, 0x0
+inst_238:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x1
+inst_239:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	sub r15, OFFSET EVM_WORD_SIZE * 2
+	mov rsi, [r15]
+	add rsi, OFFSET memory
+	mov rdx, [r15 + EVM_WORD_SIZE]
+	mov rdi, OFFSET STDOUT
+	mov rax, OFFSET SYS_WRITE
+	syscall
+inst_240:
+	cmp r13, OFFSET frames
+	jbe stack_underflow
+	sub r13, OFFSET EVM_WORD_SIZE
+	mov r14, [r13]
+	ret
+inst_241:
+	mov rax, 0x30
+inst_242:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x31
+inst_243:
+	mov [r15], rax
+	add r15, OFFSET EVM_WORD_SIZE
+	mov rax, 0x32
+inst_244:
+	mov rax, OFFSET SYS_EXIT
+	mov rdi, 0
+	syscall
+illegal_inst_access:
+	mov rax, OFFSET SYS_EXIT
+	mov rdi, 4
+	syscall
+stack_overflow:
+	mov rax, OFFSET SYS_EXIT
+	mov rdi, 1
+	syscall
+stack_underflow:
+	mov rax, OFFSET SYS_EXIT
+	mov rdi, 2
+	syscall
+.data
+memory_init:
+.byte 42, 42, 42, 42, 42
+.byte 42, 42, 42, 42, 42
+.byte 42, 42, 42, 42, 42
+.byte 42, 42, 42, 42, 42
+.byte 42, 42, 42, 42, 42
+.byte 42, 42, 42, 42, 42
+.bss
+frames:
+.skip (EVM_RET_STACK_CAPACITY)*8
+.balign 8
+evm:
+.skip (EVM_SIZE)*1
+.section .note.GNU-stack,"",@progbits
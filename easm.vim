@@ -27,6 +27,9 @@ syntax keyword easmKeywords andb orb xor shr shl notb
 syntax keyword easmKeywords read8 read16 read32 read64
 syntax keyword easmKeywords write8 write16 write32 write64
 syntax keyword easmKeywords i2f u2f f2i f2u
+syntax keyword easmKeywords plusi_imm minusi_imm eqi_imm
+syntax keyword easmKeywords jmp_if_not jmp_if_zero jmp_lti
+syntax keyword easmKeywords local_get local_set arg_get arg_set
 
 " Comments
 syntax region easmCommentLine start=";" end="$"   contains=easmTodos
@@ -1,19 +1,39 @@
 #define EBUILD_IMPLEMENTAION
 #include "./ebuild.h"
 
-#define CFLAGS "-pedantic", "-Wall", "-Wextra", "-Werror", "-Wfatal-errors", "-Wswitch-enum", "-Wmissing-prototypes", "-Wconversion", "-Ofast", "-flto", "-march=native", "-pipe", "-fno-strict-aliasing"
+#define EASM_CACHE_DIR ".easm-cache"
+
+#define CFLAGS "-pedantic", "-Wall", "-Wextra", "-Werror", "-Wfatal-errors", "-Wswitch-enum", "-Wmissing-prototypes", "-Wconversion", "-pthread", "-Ofast", "-flto", "-march=native", "-pipe", "-fno-strict-aliasing"
 
 const char *toolchian[] = {
-	"easm", "evmi", "evmr", "deasm", "edbug", "easm2nasm"
+"easm", "evmi", "evmr", "deasm", "edbug", "easm2nasm", "easm2elf", "easm2c", "easmb", "eld"
 };
 
+#define EVM_OBJECT PATH("build", "obj", "evm.o")
+
+// NOTE: a program that has to trap has the Err it stops with in test/examples/<name>.expected.err
+const char *expected_error(const char *example_base) {
+	const char *path = PATH("test", "examples", CONCAT(example_base, ".expected.err"));
+	return IS_FILE(path) ? path : NULL;
+}
+
+// NOTE: the implementation of evm.h is compiled once, every tool links the same object
 void build_toolchain(void) {
+	MKDIRS("build", "obj");
+	if (NEEDS_REBUILD(EVM_OBJECT, PATH("src", "evm.c"))) {
+		CMD("gcc", CFLAGS, "-c", "-o", EVM_OBJECT, PATH("src", "evm.c"));
+	}
+
 	MKDIRS("build", "bin");
 	FOREACH_ARRAY(const char *, tool, toolchian, {
-		CMD("gcc", CFLAGS, "-o",
-			PATH("build", "bin", tool),
-			PATH("src", CONCAT(tool, ".c")));
+		if (NEEDS_REBUILD(PATH("build", "bin", tool), PATH("src", CONCAT(tool, ".c")), EVM_OBJECT)) {
+			JOB(CMD("gcc", CFLAGS, "-o",
+				PATH("build", "bin", tool),
+				PATH("src", CONCAT(tool, ".c")),
+				EVM_OBJECT));
+		}
 	});
+	JOBS_WAIT();
 }
 
 void build_examples(void) {
@@ -24,16 +44,97 @@ void build_examples(void) {
 			assert(n >= 4);
 			if (strcmp(example + n - 4, "easm") == 0) {
 				const char *example_base = NOEXT(example);
-				CMD(PATH("build", "bin", "easm"), "-g",
+				if (NEEDS_REBUILD(PATH("build", "examples", CONCAT(example_base, ".evm")),
+						PATH("examples", example), PATH("build", "bin", "easm"))) {
+					JOB(CMD(PATH("build", "bin", "easm"), "-g", "-cache", EASM_CACHE_DIR,
+						PATH("examples", example),
+						PATH("build", "examples", CONCAT(example_base, ".evm"))));
+				}
+			}
+		}
+	});
+
+}
+
+// NOTE: natives.hasm is assembled once and linked into every program under examples/link
+void build_linked_examples(void) {
+	MKDIRS("build", "examples", "link");
+	if (NEEDS_REBUILD(PATH("build", "examples", "natives.eo"),
+			PATH("examples", "natives.hasm"), PATH("build", "bin", "easm"))) {
+		CMD(PATH("build", "bin", "easm"), "-c", "-cache", EASM_CACHE_DIR,
+			PATH("examples", "natives.hasm"),
+			PATH("build", "examples", "natives.eo"));
+	}
+
+	FOREACH_FILE_IN_DIR(example, PATH("examples", "link"), {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			if (NEEDS_REBUILD(PATH("build", "examples", "link", CONCAT(example_base, ".evm")),
+					PATH("examples", "link", example), PATH("build", "examples", "natives.eo"),
+					PATH("build", "bin", "easm"), PATH("build", "bin", "eld"))) {
+				JOB({
+					CMD(PATH("build", "bin", "easm"), "-c", "-cache", EASM_CACHE_DIR,
+						PATH("examples", "link", example),
+						PATH("build", "examples", "link", CONCAT(example_base, ".eo")));
+					CMD(PATH("build", "bin", "eld"), "-g",
+						"-o", PATH("build", "examples", "link", CONCAT(example_base, ".evm")),
+						PATH("build", "examples", "link", CONCAT(example_base, ".eo")),
+						PATH("build", "examples", "natives.eo"));
+				});
+			}
+		}
+	});
+}
+
+// NOTE: the same examples once more through the optimizer, they have to print exactly the same
+void build_optimized_examples(void) {
+	MKDIRS("build", "examples", "optimized");
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			if (NEEDS_REBUILD(PATH("build", "examples", "optimized", CONCAT(example_base, ".evm")),
+					PATH("examples", example), PATH("build", "bin", "easm"))) {
+				JOB(CMD(PATH("build", "bin", "easm"), "-g", "-O", "-cache", EASM_CACHE_DIR,
 					PATH("examples", example),
-					PATH("build", "examples", CONCAT(example_base, ".evm")));
+					PATH("build", "examples", "optimized", CONCAT(example_base, ".evm"))));
 			}
 		}
 	});
+}
 
+// NOTE: the optimized examples are profiled by evmi and assembled once more with the code
+// laid out by their profile, so they have to be built first
+void build_profiled_examples(void) {
+	MKDIRS("build", "examples", "profiled");
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		// NOTE: a program that traps has no common case to lay the code out for
+		if (ENDS_WITH(example, ".easm") && expected_error(NOEXT(example)) == NULL) {
+			const char *example_base = NOEXT(example);
+			if (NEEDS_REBUILD(PATH("build", "examples", "profiled", CONCAT(example_base, ".evm")),
+					PATH("examples", example),
+					PATH("build", "examples", "optimized", CONCAT(example_base, ".evm")),
+					PATH("build", "bin", "easm"), PATH("build", "bin", "evmi"))) {
+				JOB({
+					// NOTE: the output was checked by the tests already, it only clutters the build log
+					CMD(PATH("build", "bin", "evmi"), "-quiet",
+						"-profile", PATH("build", "examples", "profiled", CONCAT(example_base, ".prof")),
+						PATH("build", "examples", "optimized", CONCAT(example_base, ".evm")));
+					CMD(PATH("build", "bin", "easm"), "-g", "-O",
+						"-profile", PATH("build", "examples", "profiled", CONCAT(example_base, ".prof")),
+						PATH("examples", example),
+						PATH("build", "examples", "profiled", CONCAT(example_base, ".evm")));
+				});
+			}
+		}
+	});
 }
 
 void build_x86_64_example(const char *example) {
+	if (!NEEDS_REBUILD(PATH("build", "examples", CONCAT(example, ".exe")),
+			PATH("examples", CONCAT(example, ".easm")), PATH("build", "bin", "easm2nasm"), EVM_OBJECT)) {
+		return;
+	}
+
     	CMD(PATH("build", "bin", "easm2nasm"),
         	PATH("examples", CONCAT(example, ".easm")),
         	PATH("build", "examples", CONCAT(example, ".asm")));
@@ -43,29 +144,217 @@ void build_x86_64_example(const char *example) {
         	"-o",
         	PATH("build", "examples", CONCAT(example, ".o")));
 
-    	CMD("ld",
+    	// NOTE: the natives other than write come from the same evm.o as the tools, the
+    	// executable brings its own _start
+    	CMD("gcc", "-nostartfiles", "-no-pie",
         	"-o", PATH("build", "examples", CONCAT(example, ".exe")),
-        	PATH("build", "examples", CONCAT(example, ".o")));
+        	PATH("build", "examples", CONCAT(example, ".o")),
+        	EVM_OBJECT);
 }
 
 void build_x86_64_examples(void) {
-    	build_x86_64_example("123i");
-    	build_x86_64_example("fib");
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			JOB(build_x86_64_example(NOEXT(example)));
+		}
+	});
+}
+
+// NOTE: the same executables encoded by easm2elf, no assembler or linker involved
+void build_elf_examples(void) {
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			if (NEEDS_REBUILD(PATH("build", "examples", CONCAT(example_base, ".elf")),
+					PATH("examples", example), PATH("build", "bin", "easm2elf"))) {
+				JOB(CMD(PATH("build", "bin", "easm2elf"), "-g",
+					PATH("examples", example),
+					PATH("build", "examples", CONCAT(example_base, ".elf"))));
+			}
+		}
+	});
 }
 
-void run_tests(void) {
+// NOTE: the examples translated to C by easm2c and compiled with the C compiler, linked
+// with the same evm.o as the tools
+void build_c_examples(void) {
+	MKDIRS("build", "examples", "c");
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			if (NEEDS_REBUILD(PATH("build", "examples", "c", example_base),
+					PATH("examples", example), PATH("build", "bin", "easm2c"), EVM_OBJECT)) {
+				JOB({
+					CMD(PATH("build", "bin", "easm2c"),
+						PATH("examples", example),
+						PATH("build", "examples", "c", CONCAT(example_base, ".c")));
+					CMD("gcc", "-O2", "-I", "src", "-DEVM_EXTERN_IMPLEMENTATION",
+						"-o", PATH("build", "examples", "c", example_base),
+						PATH("build", "examples", "c", CONCAT(example_base, ".c")),
+						EVM_OBJECT);
+				});
+			}
+		}
+	});
+}
+
+void add_test(FILE *suite, const char *flag, const char *program, const char *example_base) {
+	fprintf(suite, "%s %s -eo %s", flag, program,
+		PATH("test", "examples", CONCAT(example_base, ".expected.out")));
+	const char *error = expected_error(example_base);
+	if (error != NULL) fprintf(suite, " -ee %s", error);
+	fprintf(suite, "\n");
+}
+
+void add_tests(FILE *suite) {
 	FOREACH_FILE_IN_DIR(example, "examples", {
 		size_t n = strlen(example);
 		if (*example != '.') {
 			assert(n >= 4);
 			if (strcmp(example + n - 4, "easm") == 0) {
 				const char *example_base = NOEXT(example);
-				CMD(PATH("build", "bin", "evmr"),
-					"-p", PATH("build", "examples", CONCAT(example_base, ".evm")),
-					"-eo", PATH("test", "examples", CONCAT(example_base, ".expected.out")));
+				add_test(suite, "-p", PATH("build", "examples", CONCAT(example_base, ".evm")), example_base);
+			}
+		}
+	});
+}
+
+// NOTE: linked programs have to behave exactly like their #include counterparts
+void add_linked_tests(FILE *suite) {
+	FOREACH_FILE_IN_DIR(example, PATH("examples", "link"), {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			add_test(suite, "-p", PATH("build", "examples", "link", CONCAT(example_base, ".evm")), example_base);
+		}
+	});
+}
+
+void add_optimized_tests(FILE *suite) {
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			add_test(suite, "-p", PATH("build", "examples", "optimized", CONCAT(example_base, ".evm")), example_base);
+		}
+	});
+}
+
+void add_profiled_tests(FILE *suite) {
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm") && expected_error(NOEXT(example)) == NULL) {
+			const char *example_base = NOEXT(example);
+			add_test(suite, "-p", PATH("build", "examples", "profiled", CONCAT(example_base, ".evm")), example_base);
+		}
+	});
+}
+
+// NOTE: the native executables have to print exactly what the VM does and stop with the same Err
+void add_x86_64_tests(FILE *suite) {
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			add_test(suite, "-x", PATH("build", "examples", CONCAT(example_base, ".exe")), example_base);
+		}
+	});
+}
+
+void add_elf_tests(FILE *suite) {
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			add_test(suite, "-x", PATH("build", "examples", CONCAT(example_base, ".elf")), example_base);
+		}
+	});
+}
+
+void add_c_tests(FILE *suite) {
+	FOREACH_FILE_IN_DIR(example, "examples", {
+		if (ENDS_WITH(example, ".easm")) {
+			const char *example_base = NOEXT(example);
+			add_test(suite, "-x", PATH("build", "examples", "c", example_base), example_base);
+		}
+	});
+}
+
+// NOTE: all the tests run in a single evmr, it reports every failure at the end
+void run_suite(void) {
+	const char *suite_path = PATH("build", "tests.txt");
+	FILE *suite = fopen(suite_path, "w");
+	if (suite == NULL) {
+		ERRO("could not open file %s: %s", suite_path, strerror(errno));
+		exit(1);
+	}
+
+	add_tests(suite);
+	add_linked_tests(suite);
+	add_optimized_tests(suite);
+	add_profiled_tests(suite);
+	add_c_tests(suite);
+#ifdef __linux__
+	add_x86_64_tests(suite);
+	add_elf_tests(suite);
+#endif // __linux__
+	fclose(suite);
+
+	char jobs[32];
+	snprintf(jobs, sizeof(jobs), "%d", ebuild_jobs);
+	CMD(PATH("build", "bin", "evmr"), "-j", jobs, "-suite", suite_path);
+}
+
+// NOTE: bench/ holds the per instruction microbenchmarks and a few longer programs
+void build_bench(void) {
+	MKDIRS("build", "bench");
+	FOREACH_FILE_IN_DIR(bench, "bench", {
+		if (ENDS_WITH(bench, ".easm")) {
+			const char *bench_base = NOEXT(bench);
+			if (NEEDS_REBUILD(PATH("build", "bench", CONCAT(bench_base, ".evm")),
+					PATH("bench", bench), PATH("examples", "natives.hasm"), PATH("build", "bin", "easm"))) {
+				JOB(CMD(PATH("build", "bin", "easm"), "-I", "examples",
+					PATH("bench", bench),
+					PATH("build", "bench", CONCAT(bench_base, ".evm"))));
+			}
+		}
+	});
+	JOBS_WAIT();
+}
+
+// NOTE: every program gets its own json from evmi, they are gathered into build/bench.json.
+// They run one at a time, a parallel job would be measured along with them.
+void run_bench(const char *reps) {
+	const char *report_path = PATH("build", "bench.json");
+	FILE *report = fopen(report_path, "w");
+	if (report == NULL) {
+		ERRO("could not open file %s: %s", report_path, strerror(errno));
+		exit(1);
+	}
+
+	fprintf(report, "[\n");
+	int first = 1;
+	FOREACH_FILE_IN_DIR(bench, "bench", {
+		if (ENDS_WITH(bench, ".easm")) {
+			const char *bench_base = NOEXT(bench);
+			const char *json_path = PATH("build", "bench", CONCAT(bench_base, ".json"));
+			CMD(PATH("build", "bin", "evmi"), "-bench", json_path, "-reps", reps,
+				PATH("build", "bench", CONCAT(bench_base, ".evm")));
+
+			FILE *json = fopen(json_path, "r");
+			if (json == NULL) {
+				ERRO("could not open file %s: %s", json_path, strerror(errno));
+				exit(1);
+			}
+			if (!first) fprintf(report, ",\n");
+			first = 0;
+			char buffer[4096];
+			size_t n;
+			while ((n = fread(buffer, 1, sizeof(buffer), json)) > 0) {
+				fwrite(buffer, 1, n, report);
 			}
+			fclose(json);
 		}
 	});
+	fprintf(report, "]\n");
+	fclose(report);
+
+	INFO("benchmark results are in %s", report_path);
 }
 
 void record_tests(void) {
@@ -75,28 +364,56 @@ void record_tests(void) {
         		assert(n >= 4);
             		if (strcmp(example + n - 4, "easm") == 0) {
                 		const char *example_base = NOEXT(example);
-                		CMD(PATH("build", "bin", "evmr"),
-                    			"-p", PATH("build", "examples", CONCAT(example_base, ".evm")),
-                    			"-ao", PATH("test", "examples", CONCAT(example_base, ".expected.out")));
+                		const char *error = expected_error(example_base);
+                		if (error != NULL) {
+                			JOB(CMD(PATH("build", "bin", "evmr"),
+                    				"-p", PATH("build", "examples", CONCAT(example_base, ".evm")),
+                    				"-ao", PATH("test", "examples", CONCAT(example_base, ".expected.out")),
+                    				"-ee", error));
+                		} else {
+                			JOB(CMD(PATH("build", "bin", "evmr"),
+                    				"-p", PATH("build", "examples", CONCAT(example_base, ".evm")),
+                    				"-ao", PATH("test", "examples", CONCAT(example_base, ".expected.out"))));
+                		}
             		}
         	}
     });
 }
 
 void print_help(FILE *stream) {
-	fprintf(stream, "./nobuild          - Build toolchain and examples\n");
+	fprintf(stream, "./nobuild [-j N] [subcommand]\n");
+	fprintf(stream, "    -j N           - Run up to N commands at once, the number of CPUs by default\n");
+	fprintf(stream, "./nobuild          - Build toolchain and examples, only what is older than its inputs\n");
 	fprintf(stream, "./nobuild test     - Run the tests\n");
 	fprintf(stream, "./nobuild record   - Capture the current output of examples as the expected on for the tests\n");
+	fprintf(stream, "./nobuild bench    - Time the programs under bench/ in the VM into build/bench.json, `bench <reps>` runs each <reps> times\n");
+	fprintf(stream, "./nobuild clean    - Remove everything built\n");
 	fprintf(stream, "./nobuild help     - Show this help message\n");
 	}
 
 int main(int argc, char **argv) {
 	shift(&argc, &argv);
 
+#ifndef _WIN32
+	ebuild_jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	if (ebuild_jobs < 1) ebuild_jobs = 1;
+#endif // _WIN32
+
 	const char *subcommand = NULL;
 
-	if (argc > 0) {
-		subcommand = shift(&argc, &argv);
+	while (argc > 0) {
+		const char *arg = shift(&argc, &argv);
+		if (strcmp(arg, "-j") == 0) {
+			if (argc == 0 || (ebuild_jobs = atoi(*argv)) < 1) {
+				print_help(stderr);
+				fprintf(stderr, "[ERROR] -j expects a positive number of jobs\n");
+				exit(1);
+			}
+			shift(&argc, &argv);
+		} else {
+			subcommand = arg;
+			break;
+		}
 	}
 
 	if (subcommand != NULL && strcmp(subcommand, "help") == 0) {
@@ -104,19 +421,33 @@ int main(int argc, char **argv) {
 		exit(0);
 	}
 
-	RM("build");
+	if (subcommand != NULL && strcmp(subcommand, "clean") == 0) {
+		if (IS_DIR("build")) RM("build");
+		exit(0);
+	}
 
 	build_toolchain();
 	build_examples();
+	build_linked_examples();
+	build_optimized_examples();
+	build_c_examples();
 #ifdef __linux__
     	build_x86_64_examples();
+	build_elf_examples();
 #endif // __linux__
+	JOBS_WAIT();
+	build_profiled_examples();
+	JOBS_WAIT();
 
 	if (subcommand) {
         	if (strcmp(subcommand, "test") == 0) {
-            		run_tests();
+            		run_suite();
         	} else if (strcmp(subcommand, "record") == 0) {
             		record_tests();
+            		JOBS_WAIT();
+        	} else if (strcmp(subcommand, "bench") == 0) {
+            		build_bench();
+            		run_bench(argc > 0 ? shift(&argc, &argv) : "10");
         	} else {
             		print_help(stderr);
             		fprintf(stderr, "[ERROR] unknown subcommand `%s`\n", subcommand);
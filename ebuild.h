@@ -77,17 +77,44 @@ int closedir(DIR *dirp);
 		cmd_impl(0, __VA_ARGS__, NULL);				\
 	} while(0)
 
+// NOTE: runs the body in a child process next to up to `ebuild_jobs - 1` other jobs,
+// the CMDs of one body still run one after another. JOBS_WAIT() waits for all of
+// them and stops the build if any failed. Without fork the body just runs in place.
+#ifdef _WIN32
+#define JOB(body) do { body; } while(0)
+#else
+#define JOB(body)							\
+	do {								\
+		if (ebuild__job_begin()) {				\
+			body;						\
+			exit(0);					\
+		}							\
+	} while(0)
+#endif // _WIN32
+
+#define JOBS_WAIT() ebuild__jobs_wait()
+
+// NOTE: true when the output is missing or older than one of the inputs or of the
+// files they #include "..." (looked up next to the includer)
+#define NEEDS_REBUILD(output, ...) ebuild__needs_rebuild(output, __VA_ARGS__, NULL)
+
 const char *concat_impl(int ignore, ...);
 const char *concat_sep_impl(const char *sep, ...);
 const char *build__join(const char *sep, ...);
 int ebuild__ends_with(const char *str, const char *postfix);
 int ebuild__is_dir(const char *path);
+int ebuild__is_file(const char *path);
 void mkdirs_impl(int ignore, ...);
 void cmd_impl(int ignore, ...);
 void ebuild_exec(const char **argv);
 const char *remove_ext(const char *path);
 char *shift(int *argc, char ***argv);
 void ebuild__rm(const char *path);
+int ebuild__job_begin(void);
+void ebuild__jobs_wait(void);
+int ebuild__needs_rebuild(const char *output, ...);
+
+extern int ebuild_jobs;
 
 #define CONCAT(...) concat_impl(0, __VA_ARGS__, NULL)
 #define CONCAT_SEP(sep, ...) build__deprecated_concat_sep(sep, __VA_ARGS__, NULL)
@@ -97,6 +124,7 @@ void ebuild__rm(const char *path);
 #define NOEXT(path) ebuild__remove_ext(path)
 #define ENDS_WITH(str, postfix) ebuild__ends_with(str, postfix)
 #define IS_DIR(path) ebuild__is_dir(path)
+#define IS_FILE(path) ebuild__is_file(path)
 #define RM(path)                                \
     do {                                        \
         INFO("rm %s", path);                    \
@@ -291,7 +319,10 @@ void ebuild_exec(const char **argv) {
 	} else {
 		for (;;) {
             		int wstatus = 0;
-            		wait(&wstatus);
+            		if (waitpid(cpid, &wstatus, 0) < 0) {
+                		ERRO("could not wait for child process: %s", strerror(errno));
+                		exit(1);
+            		}
 
             		if (WIFEXITED(wstatus)) {
                 		int exit_status = WEXITSTATUS(wstatus);
@@ -312,6 +343,138 @@ void ebuild_exec(const char **argv) {
 #endif // _WIN32
 }
 
+int ebuild_jobs = 1;
+
+#ifndef _WIN32
+static pid_t *ebuild__running = NULL;
+static int ebuild__running_count = 0;
+static int ebuild__failed = 0;
+
+static void ebuild__reap_job(void) {
+	int wstatus = 0;
+	pid_t pid = wait(&wstatus);
+	if (pid < 0) {
+		ERRO("could not wait for a job: %s", strerror(errno));
+		exit(1);
+	}
+
+	for (int i = 0; i < ebuild__running_count; ++i) {
+		if (ebuild__running[i] == pid) {
+			ebuild__running[i] = ebuild__running[--ebuild__running_count];
+			break;
+		}
+	}
+
+	// NOTE: the job has already logged why its command failed
+	if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) ebuild__failed = 1;
+}
+
+int ebuild__job_begin(void) {
+	if (ebuild__running == NULL) {
+		ebuild__running = malloc(sizeof(pid_t) * (size_t) (ebuild_jobs > 0 ? ebuild_jobs : 1));
+	}
+
+	while (ebuild__running_count > 0 && ebuild__running_count >= ebuild_jobs) {
+		ebuild__reap_job();
+	}
+
+	// NOTE: whatever is still buffered would be printed by the child as well
+	fflush(stdout);
+	fflush(stderr);
+
+	pid_t cpid = fork();
+	if (cpid == -1) {
+		ERRO("could not fork a child process: %s", strerror(errno));
+		exit(1);
+	}
+
+	if (cpid == 0) return 1;
+
+	ebuild__running[ebuild__running_count++] = cpid;
+	return 0;
+}
+
+void ebuild__jobs_wait(void) {
+	while (ebuild__running_count > 0) {
+		ebuild__reap_job();
+	}
+
+	if (ebuild__failed) {
+		ERRO("some of the jobs failed");
+		exit(1);
+	}
+}
+#else
+void ebuild__jobs_wait(void) {}
+#endif // _WIN32
+
+// NOTE: in nanoseconds where the file system has them, the outputs of one build are
+// often written in the same second as their inputs
+static long long ebuild__mtime(const char *path) {
+	struct stat statbuf = {0};
+	if (stat(path, &statbuf) < 0) return -1;
+#ifdef __linux__
+	return (long long) statbuf.st_mtim.tv_sec * 1000000000 + statbuf.st_mtim.tv_nsec;
+#else
+	return (long long) statbuf.st_mtime * 1000000000;
+#endif // __linux__
+}
+
+// NOTE: the newest modification time of the file and of everything it includes, -1
+// if something is missing. `depth` keeps include cycles from looping forever.
+static long long ebuild__mtime_with_includes(const char *path, int depth) {
+	long long result = ebuild__mtime(path);
+	if (result < 0 || depth > 32) return result;
+
+	FILE *f = fopen(path, "r");
+	if (f == NULL) return -1;
+
+	size_t dir_len = strlen(path);
+	while (dir_len > 0 && path[dir_len - 1] != PATH_SEP[0]) dir_len -= 1;
+
+	char line[1024];
+	while (fgets(line, sizeof(line), f)) {
+		const char *p = line;
+		while (*p == ' ' || *p == '\t') ++p;
+		if (strncmp(p, "#include", 8) != 0) continue;
+		p = strchr(p + 8, '"');
+		if (p == NULL) continue;
+		const char *end = strchr(p + 1, '"');
+		if (end == NULL) continue;
+
+		char include[1024];
+		const size_t n = (size_t) (end - p - 1);
+		if (dir_len + n + 1 > sizeof(include)) continue;
+		memcpy(include, path, dir_len);
+		memcpy(include + dir_len, p + 1, n);
+		include[dir_len + n] = '\0';
+
+		// NOTE: system headers and the includes found through -I are not followed,
+		// the callers list those themselves
+		const long long mtime = ebuild__mtime_with_includes(include, depth + 1);
+		if (mtime > result) result = mtime;
+	}
+
+	fclose(f);
+	return result;
+}
+
+int ebuild__needs_rebuild(const char *output, ...) {
+	const long long output_mtime = ebuild__mtime(output);
+	if (output_mtime < 0) return 1;
+
+	va_list args;
+	FOREACH_VARGS(output, input, args, {
+		const long long input_mtime = ebuild__mtime_with_includes(input, 0);
+		if (input_mtime < 0 || input_mtime > output_mtime) {
+			va_end(args);
+			return 1;
+		}
+	});
+
+	return 0;
+}
+
 void cmd_impl(int ignore, ...) {
 	size_t argc = 0;
 	va_list args;
@@ -416,6 +579,26 @@ int ebuild__is_dir(const char *path) {
 #endif // _WIN32
 }
 
+int ebuild__is_file(const char *path) {
+#ifdef _WIN32
+    	DWORD dwAttrib = GetFileAttributes(path);
+
+    	return (dwAttrib != INVALID_FILE_ATTRIBUTES &&
+		!(dwAttrib & FILE_ATTRIBUTE_DIRECTORY));
+#else
+    	struct stat statbuf = {0};
+    	if (stat(path, &statbuf) < 0) {
+		if (errno == ENOENT) return 0;
+
+		ERRO("could not retrieve information about file %s: %s",
+	     		path, strerror(errno));
+		exit(1);
+    	}
+
+    	return (statbuf.st_mode & S_IFMT) == S_IFREG;
+#endif // _WIN32
+}
+
 void ebuild__rm(const char *path) {
     	if (IS_DIR(path)) {
 		FOREACH_FILE_IN_DIR(file, path, {
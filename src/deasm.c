@@ -1,4 +1,3 @@
-#define EVM_IMPLEMENTATION
 #include "./evm.h"
 
 int main(int argc, char **argv) {
@@ -1,4 +1,6 @@
-#define EVM_IMPLEMENTATION
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "./evm.h"
 
 static char *shift(int *argc, char ***argv) {
@@ -9,69 +11,332 @@ static char *shift(int *argc, char ***argv) {
 	return result;
 }
 
+// NOTE: FNV-1a, https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
+#define CACHE_HASH_OFFSET 14695981039346656037ULL
+#define CACHE_HASH_PRIME 1099511628211ULL
+
+static uint64_t cache_hash_bytes(uint64_t hash, const void *data, size_t size) {
+	const uint8_t *bytes = data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= CACHE_HASH_PRIME;
+	}
+	return hash;
+}
+
+static bool cache_read_file(const char *file_path, char **data, size_t *size) {
+	FILE *f = fopen(file_path, "rb");
+	if (f == NULL) return false;
+
+	size_t capacity = 4096;
+	*size = 0;
+	*data = malloc(capacity);
+	while (*data != NULL) {
+		*size += fread(*data + *size, 1, capacity - *size, f);
+		if (*size < capacity) break;
+		capacity *= 2;
+		*data = realloc(*data, capacity);
+	}
+
+	const bool ok = *data != NULL && !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+static bool cache_write_file(const char *file_path, const char *data, size_t size) {
+	FILE *f = fopen(file_path, "wb");
+	if (f == NULL) return false;
+
+	fwrite(data, 1, size, f);
+	const bool ok = !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+static bool cache_copy_file(const char *src_path, const char *dst_path) {
+	char *data = NULL;
+	size_t size = 0;
+	const bool ok = cache_read_file(src_path, &data, &size) && cache_write_file(dst_path, data, size);
+	free(data);
+	return ok;
+}
+
+typedef struct {
+	String_View *items;
+	size_t size;
+	size_t capacity;
+} Cache_Visited;
+
+// NOTE: Hashes the file and, depth first, everything it #include-s. Has to agree with
+// easm_translate_source on how an include is spelled and resolved, every file counts once.
+static bool cache_hash_source(EASM *easm, Cache_Visited *visited, String_View file_path, size_t level, uint64_t *hash) {
+	if (level >= EASM_MAX_INCLUDE_LEVEL) return false;
+
+	String_View canonical_path = { 0 };
+	if (!easm_canonical_path(easm, file_path, &canonical_path)) return false;
+	for (size_t i = 0; i < visited->size; ++i) {
+		if (sv_eq(visited->items[i], canonical_path)) return true;
+	}
+	EASM_TABLE_RESERVE(visited->items, visited->size, visited->capacity, 1);
+	visited->items[visited->size++] = canonical_path;
+
+	char *data = NULL;
+	size_t size = 0;
+	if (!cache_read_file(arena_sv_to_cstr(&easm->arena, file_path), &data, &size)) {
+		free(data);
+		return false;
+	}
+
+	*hash = cache_hash_bytes(*hash, data, size);
+
+	String_View source = { .count = size, .data = data };
+	bool ok = true;
+	while (ok && source.count > 0) {
+		String_View line = sv_chop_by_delim(&source, '\n');
+		line = sv_trim(sv_chop_by_delim(&line, EASM_COMMENT_CHAR));
+		String_View token = sv_chop_by_delim(&line, ' ');
+		if (!sv_eq(token, sv_from_cstr("#include"))) continue;
+
+		line = sv_trim(line);
+		if (line.count < 2 || line.data[0] != '"' || line.data[line.count - 1] != '"') {
+			ok = false;
+			break;
+		}
+		line.count -= 2;
+		line.data += 1;
+
+		// NOTE: the source buffer is freed below, keep the path alive
+		line = sv_from_cstr(arena_sv_to_cstr(&easm->arena, line));
+
+		String_View include_path = { 0 };
+		ok = easm_resolve_include_path(easm, file_path, line, &include_path)
+			&& cache_hash_source(easm, visited, include_path, level + 1, hash);
+	}
+
+	free(data);
+	return ok;
+}
+
+// NOTE: The key covers the assembler itself, so rebuilding easm invalidates the cache on
+// its own. Every build writes a new executable, so its size, modification time and inode
+// tell the builds apart for the cost of a stat instead of reading the whole executable.
+static bool cache_key(EASM *easm, const char *input_file_path, bool have_symbol_table, bool optimize, uint64_t *key) {
+	uint64_t hash = CACHE_HASH_OFFSET;
+
+	// NOTE: without /proc only the file formats are covered and the cache has to be dropped by hand
+	const uint16_t versions[2] = { EVM_FILE_VERSION, EVM_OBJECT_VERSION };
+	hash = cache_hash_bytes(hash, versions, sizeof(versions));
+
+	struct stat self = {0};
+	if (stat("/proc/self/exe", &self) == 0) {
+#ifdef __linux__
+		const uint64_t mtime_ns = (uint64_t) self.st_mtim.tv_nsec;
+#else
+		const uint64_t mtime_ns = 0;
+#endif // __linux__
+		const uint64_t stamp[4] = { (uint64_t) self.st_size, (uint64_t) self.st_mtime, mtime_ns, (uint64_t) self.st_ino };
+		hash = cache_hash_bytes(hash, stamp, sizeof(stamp));
+	}
+
+	const uint8_t flags[3] = { easm->is_object, have_symbol_table, optimize };
+	hash = cache_hash_bytes(hash, flags, sizeof(flags));
+
+	Cache_Visited visited = { 0 };
+	const bool ok = cache_hash_source(easm, &visited, sv_from_cstr(input_file_path), 0, &hash);
+	free(visited.items);
+	if (!ok) return false;
+
+	*key = hash;
+	return true;
+}
+
+static const char *cache_entry_path(Arena *arena, const char *cache_dir, uint64_t key, const char *ext) {
+	char name[64];
+	snprintf(name, sizeof(name), "%016lx%s", key, ext);
+	return arena_cstr_concat2(arena, arena_cstr_concat2(arena, cache_dir, "/"), name);
+}
+
+static bool cache_fetch(Arena *arena, const char *cache_dir, uint64_t key, const char *ext, const char *output_file_path, bool have_symbol_table) {
+	const char *entry = cache_entry_path(arena, cache_dir, key, ext);
+	if (!cache_copy_file(entry, output_file_path)) return false;
+
+	if (have_symbol_table) {
+		const char *sym_entry = arena_cstr_concat2(arena, entry, ".sym");
+		const char *sym_file_path = arena_cstr_concat2(arena, output_file_path, ".sym");
+		if (!cache_copy_file(sym_entry, sym_file_path)) return false;
+	}
+
+	return true;
+}
+
+static void cache_store_file(Arena *arena, const char *src_path, const char *entry) {
+	// NOTE: copy under a private name and rename, so a parallel easm never sees half an entry
+	char pid[32];
+	snprintf(pid, sizeof(pid), ".%d", (int) getpid());
+	const char *tmp = arena_cstr_concat2(arena, entry, pid);
+
+	if (!cache_copy_file(src_path, tmp) || rename(tmp, entry) < 0) {
+		fprintf(stderr, "WARNING: could not store `%s` in the cache: %s\n", src_path, strerror(errno));
+		remove(tmp);
+	}
+}
+
+static void cache_store(Arena *arena, const char *cache_dir, uint64_t key, const char *ext, const char *output_file_path, bool have_symbol_table) {
+	if (mkdir(cache_dir, 0755) < 0 && errno != EEXIST) {
+		fprintf(stderr, "WARNING: could not create cache directory `%s`: %s\n", cache_dir, strerror(errno));
+		return;
+	}
+
+	const char *entry = cache_entry_path(arena, cache_dir, key, ext);
+	if (have_symbol_table) {
+		cache_store_file(arena, arena_cstr_concat2(arena, output_file_path, ".sym"), arena_cstr_concat2(arena, entry, ".sym"));
+	}
+	// NOTE: the program goes last, it is what marks the entry as complete
+	cache_store_file(arena, output_file_path, entry);
+}
+
 static void usage(FILE *stream, const char *program) {
-	fprintf(stream, "Usage: %s [-g] <input.easm> <output.evm>\n", program);
+	fprintf(stream, "Usage: %s [-g] [-c] [-O] [-stats] [-profile <input.prof>] [-I <dir>]... [-cache <dir>] <input.easm> <output.evm>\n", program);
+	fprintf(stream, "  -g    also write the symbol table to <output.evm>.sym\n");
+	fprintf(stream, "  -c    write a relocatable object for eld instead of a program\n");
+	fprintf(stream, "  -O    optimize the program and drop the code and strings unreachable from #entry\n");
+	fprintf(stream, "  -stats\n");
+	fprintf(stream, "        report what the optimizer did\n");
+	fprintf(stream, "  -profile <input.prof>\n");
+	fprintf(stream, "        lay the hot code out to fall through, the profile is recorded by `evmi -profile`\n");
+	fprintf(stream, "        on the output of the same command without -profile\n");
+	fprintf(stream, "  -I <dir>\n");
+	fprintf(stream, "        look for #include files in <dir> when they are not next to the includer\n");
+	fprintf(stream, "  -cache <dir>\n");
+	fprintf(stream, "        reuse the outputs of an earlier run on the same sources, includes and easm\n");
 }
 
 int main(int argc, char **argv) {
-	int have_symbol_table = 0;
+	bool have_symbol_table = false;
+	bool optimize = false;
+	bool print_stats = false;
+
+	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
+	static EASM easm = { 0 };
 
 	const char *program = shift(&argc, &argv);
-	if (argc == 0) {
+	const char *input_file_path = NULL;
+	const char *output_file_path = NULL;
+	const char *cache_dir = NULL;
+	const char *profile_file_path = NULL;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+
+		if (strcmp(flag, "-g") == 0) {
+			have_symbol_table = true;
+		} else if (strcmp(flag, "-c") == 0) {
+			easm.is_object = true;
+		} else if (strcmp(flag, "-O") == 0) {
+			optimize = true;
+		} else if (strcmp(flag, "-stats") == 0) {
+			print_stats = true;
+		} else if (strcmp(flag, "-profile") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			profile_file_path = shift(&argc, &argv);
+		} else if (strcmp(flag, "-I") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			easm_add_include_path(&easm, sv_from_cstr(shift(&argc, &argv)));
+		} else if (strcmp(flag, "-cache") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			cache_dir = shift(&argc, &argv);
+		} else if (input_file_path == NULL) {
+			input_file_path = flag;
+		} else if (output_file_path == NULL) {
+			output_file_path = flag;
+		} else {
+			usage(stderr, program);
+			fprintf(stderr, "ERROR: unexpected argument `%s`\n", flag);
+			exit(1);
+		}
+	}
+
+	if (input_file_path == NULL) {
 		usage(stderr, program);
 		fprintf(stderr, "ERROR: expected input\n");
         	exit(1);
 	}
 
-	const char *input_file_path = shift(&argc, &argv);
-	if (!strcmp(input_file_path, "-g")) {
-        	have_symbol_table = 1;
-        	input_file_path = shift(&argc, &argv);
-    	}
-
-	if (argc == 0) {
+	if (output_file_path == NULL) {
         	usage(stderr, program);
         	fprintf(stderr, "ERROR: expected output\n");
         	exit(1);
     	}
 
-	const char *output_file_path = shift(&argc, &argv);
+	const char *cache_ext = easm.is_object ? ".eo" : ".evm";
+	uint64_t cache_key_value = 0;
+	if (profile_file_path != NULL && easm.is_object) {
+		fprintf(stderr, "ERROR: -profile lays out a whole program, it can not be used with -c\n");
+		exit(1);
+	}
 
-	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
-	static EASM easm = { 0 };
+	// NOTE: a cached output has nothing to report, so -stats always translates. The key
+	// does not cover the profile either.
+	const bool cacheable = cache_dir != NULL && !print_stats && profile_file_path == NULL
+		&& cache_key(&easm, input_file_path, have_symbol_table, optimize, &cache_key_value);
+
+	if (cacheable && cache_fetch(&easm.arena, cache_dir, cache_key_value, cache_ext, output_file_path, have_symbol_table)) {
+		return 0;
+	}
 
 	easm_translate_source(&easm, sv_from_cstr(input_file_path));
 
-	if (!easm.has_entry) {
-		fprintf(stderr, "%s: ERROR: entry point for EVM not provided. Use preprocessor directive #entry to provide the entry point\n", input_file_path);
-		exit(1);
+	if (optimize) {
+		const uint64_t program_size = easm.program_size;
+		easm_optimize(&easm);
+
+		size_t removed_insts = 0;
+		size_t removed_bytes = 0;
+		easm_eliminate_dead_code(&easm, &removed_insts, &removed_bytes);
+		if (print_stats) {
+			printf("%s: %lu instructions before the optimizer, %lu after\n",
+				input_file_path, program_size, easm.program_size);
+			printf("%s: removed %zu unreachable instructions (%zu bytes) and %zu bytes of unused strings\n",
+				input_file_path, removed_insts, removed_insts * sizeof(Inst), removed_bytes);
+		}
 	}
 
-	easm_save_to_file(&easm, output_file_path);
+	if (profile_file_path != NULL) {
+		static Evm_Profile profile = { 0 };
+		easm_load_profile_from_file(&easm, profile_file_path, &profile);
+		easm_layout_program(&easm, &profile);
+	}
 
-	if (have_symbol_table) {
-		const char *sym_file_name = arena_cstr_concat2(&easm.arena, output_file_path, ".sym");
-		FILE *symbol_file = fopen(sym_file_name, "w");
-		if (!symbol_file) {
-			fprintf(stderr, "ERROR: Unable to open symbol table file\n");
-			return EXIT_FAILURE;
+	if (easm.is_object) {
+		easm_save_object_to_file(&easm, output_file_path);
+	} else {
+		if (!easm.has_entry) {
+			fprintf(stderr, "%s: ERROR: entry point for EVM not provided. Use preprocessor directive #entry to provide the entry point\n", input_file_path);
+			exit(1);
 		}
 
-		/*
-		* Note: This will dump out *ALL* symbols, no matter whether
-		* they are jump labels or not. However, since the
-		* preprocessor runs before the jump mark resolution, all the
-		* labels are allocated in a way that enables us to just
-		* overwrite prerocessor labels with a value equal to the
-		* address of a jump label.
-		*
-		*/
-		for (size_t i = 0; i < easm.bindings_size; ++i) {
-			fprintf(symbol_file, "%lu \t"SV_Fmt"\n", easm.bindings[i].value.as_u64, SV_Arg(easm.bindings[i].name));
-		}
-		fclose(symbol_file);
+		easm_save_to_file(&easm, output_file_path);
+	}
+
+	if (have_symbol_table) {
+		easm_save_symbols_to_file(&easm, arena_cstr_concat2(&easm.arena, output_file_path, ".sym"));
+	}
+
+	if (cacheable) {
+		cache_store(&easm.arena, cache_dir, cache_key_value, cache_ext, output_file_path, have_symbol_table);
 	}
 
 	return 0;
 }
-
@@ -0,0 +1,590 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "./evm.h"
+
+// NOTE: translates a program into a C translation unit that includes evm.h. Every basic block
+// is a label with its own scope and the values it pushes are C variables, so the C compiler
+// allocates the registers. The stack is touched only where the blocks meet, around the natives
+// and by the frame instructions.
+
+static void usage(FILE *f) {
+		fprintf(f, "Usage: easm2c [-I <dir>]... <input.easm> <output.c>\n");
+}
+
+static char *shift(int *argc, char ***argv) {
+	assert(*argc > 0);
+	char *result = **argv;
+	*argv += 1;
+	*argc -= 1;
+	return result;
+}
+
+// NOTE: the top of the VM stack as the compiler sees it: `values` are the variables holding
+// the top of it, below them is the stack in memory without the `popped` items that were
+// already taken into variables. The variables are never assigned twice, so dup and swap
+// only shuffle their numbers. sp stays the same inside of a block, `checked` is how deep
+// below it the stack is already known to exist.
+typedef struct {
+	FILE *output;
+	size_t *values;
+	size_t values_size;
+	size_t values_capacity;
+	uint64_t popped;
+	uint64_t checked;
+	size_t temps;
+} C_Gen;
+
+// NOTE: the same bounds as the VM checks, only once per depth in a block
+static void c_check_underflow(C_Gen *gen, uint64_t depth) {
+	if (depth > gen->checked) {
+		fprintf(gen->output, "\tif (sp < %lu) return ERR_STACK_UNDERFLOW;\n", depth);
+		gen->checked = depth;
+	}
+}
+
+static size_t c_new_temp(C_Gen *gen) {
+	return gen->temps++;
+}
+
+static void c_push(C_Gen *gen, size_t temp) {
+	EASM_TABLE_RESERVE(gen->values, gen->values_size, gen->values_capacity, 1);
+	gen->values[gen->values_size++] = temp;
+}
+
+// NOTE: makes sure the item `depth` deep is in a variable
+static void c_ensure(C_Gen *gen, uint64_t depth) {
+	while (gen->values_size <= depth) {
+		c_check_underflow(gen, gen->popped + 1);
+		const size_t temp = c_new_temp(gen);
+		fprintf(gen->output, "\tWord t%zu = stack[sp - %lu];\n", temp, gen->popped + 1);
+		gen->popped += 1;
+		EASM_TABLE_RESERVE(gen->values, gen->values_size, gen->values_capacity, 1);
+		memmove(gen->values + 1, gen->values, sizeof(*gen->values) * gen->values_size);
+		gen->values[0] = temp;
+		gen->values_size += 1;
+	}
+}
+
+static size_t c_pop(C_Gen *gen) {
+	c_ensure(gen, 0);
+	return gen->values[--gen->values_size];
+}
+
+// NOTE: the stack in memory grows only here, a block that pushes more than it takes can
+// overflow it, one that drops what it never loaded can underflow it
+static void c_flush(C_Gen *gen) {
+	c_check_underflow(gen, gen->popped);
+	if (gen->values_size > gen->popped) {
+		fprintf(gen->output, "\tif (sp > EVM_STACK_CAPACITY - %lu) return ERR_STACK_OVERFLOW;\n", gen->values_size - gen->popped);
+	}
+	for (size_t i = 0; i < gen->values_size; ++i) {
+		fprintf(gen->output, "\tstack[sp - %lu + %zu] = t%zu;\n", gen->popped, i, gen->values[i]);
+	}
+	if (gen->values_size > gen->popped) {
+		fprintf(gen->output, "\tsp += %lu;\n", gen->values_size - gen->popped);
+	} else if (gen->values_size < gen->popped) {
+		fprintf(gen->output, "\tsp -= %lu;\n", gen->popped - gen->values_size);
+	}
+	gen->values_size = 0;
+	gen->popped = 0;
+	gen->checked = 0;
+}
+
+static void c_binary(C_Gen *gen, const char *in, const char *out, const char *op) {
+	const size_t b = c_pop(gen);
+	const size_t a = c_pop(gen);
+	const size_t result = c_new_temp(gen);
+	fprintf(gen->output, "\tWord t%zu = { .as_%s = t%zu.as_%s %s t%zu.as_%s };\n", result, out, a, in, op, b, in);
+	c_push(gen, result);
+}
+
+static void c_division(C_Gen *gen, const char *type, const char *op) {
+	const size_t b = c_pop(gen);
+	const size_t a = c_pop(gen);
+	const size_t result = c_new_temp(gen);
+	fprintf(gen->output, "\tif (t%zu.as_%s == 0) return ERR_DIV_BY_ZERO;\n", b, type);
+	fprintf(gen->output, "\tWord t%zu = { .as_%s = t%zu.as_%s %s t%zu.as_%s };\n", result, type, a, type, op, b, type);
+	c_push(gen, result);
+}
+
+// NOTE: INT64_MIN / -1 is undefined in C, the VM wraps the quotient around and the remainder is 0
+static void c_signed_division(C_Gen *gen, bool is_modulo) {
+	const size_t b = c_pop(gen);
+	const size_t a = c_pop(gen);
+	const size_t result = c_new_temp(gen);
+	fprintf(gen->output, "\tif (t%zu.as_i64 == 0) return ERR_DIV_BY_ZERO;\n", b);
+	if (is_modulo) {
+		fprintf(gen->output, "\tWord t%zu = { .as_i64 = t%zu.as_i64 == -1 ? 0 : t%zu.as_i64 %% t%zu.as_i64 };\n", result, b, a, b);
+	} else {
+		fprintf(gen->output, "\tWord t%zu = { .as_u64 = t%zu.as_i64 == -1 ? 0 - t%zu.as_u64 : (uint64_t) (t%zu.as_i64 / t%zu.as_i64) };\n", result, b, a, a, b);
+	}
+	c_push(gen, result);
+}
+
+static void c_unary(C_Gen *gen, const char *out, const char *format) {
+	const size_t a = c_pop(gen);
+	const size_t result = c_new_temp(gen);
+	fprintf(gen->output, "\tWord t%zu = { .as_%s = ", result, out);
+	fprintf(gen->output, format, a);
+	fprintf(gen->output, " };\n");
+	c_push(gen, result);
+}
+
+// NOTE: the same bounds as the VM checks
+static void c_read(C_Gen *gen, size_t size) {
+	const size_t addr = c_pop(gen);
+	const size_t result = c_new_temp(gen);
+	fprintf(gen->output, "\tif (t%zu.as_u64 >= EVM_MEMORY_CAPACITY - %zu) return ERR_ILLEGAL_MEMORY_ACCESS;\n", addr, size - 1);
+	fprintf(gen->output, "\tWord t%zu = { .as_u64 = 0 };\n", result);
+	fprintf(gen->output, "\tmemcpy(&t%zu, &evm.memory[t%zu.as_u64], %zu);\n", result, addr, size);
+	c_push(gen, result);
+}
+
+static void c_write(C_Gen *gen, size_t size) {
+	const size_t value = c_pop(gen);
+	const size_t addr = c_pop(gen);
+	fprintf(gen->output, "\tif (t%zu.as_u64 >= EVM_MEMORY_CAPACITY - %zu) return ERR_ILLEGAL_MEMORY_ACCESS;\n", addr, size - 1);
+	fprintf(gen->output, "\tmemcpy(&evm.memory[t%zu.as_u64], &t%zu, %zu);\n", addr, value, size);
+}
+
+// NOTE: outside of the program the VM fails with ERR_ILLEGAL_INST_ACCESS
+static void c_goto(C_Gen *gen, const EASM *easm, uint64_t target) {
+	if (target < easm->program_size) {
+		fprintf(gen->output, "goto inst_%lu;\n", target);
+	} else {
+		fprintf(gen->output, "return ERR_ILLEGAL_INST_ACCESS;\n");
+	}
+}
+
+// NOTE: natives are called like the VM calls them, native 0 is evm_write of evm.h and the
+// rest are linked in as `Err evm_native_<name>(EVM *evm)`
+static void c_native_name(FILE *output, const EASM *easm, uint64_t index) {
+	if (index == 0) {
+		fprintf(output, "evm_write");
+		return;
+	}
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		if (easm->bindings[i].kind == BINDING_NATIVE && easm->bindings[i].value.as_u64 == index) {
+			fprintf(output, "evm_native_"SV_Fmt, SV_Arg(easm->bindings[i].name));
+			return;
+		}
+	}
+	fprintf(stderr, "ERROR: native %lu has no name to link it by\n", index);
+	exit(1);
+}
+
+static void c_inst(C_Gen *gen, const EASM *easm, size_t i) {
+	FILE *output = gen->output;
+	const Inst inst = easm->program[i];
+	const uint64_t operand = inst.operand.as_u64;
+
+	switch (inst.type) {
+		case INST_NOP: break;
+
+		case INST_PUSH: {
+			const size_t result = c_new_temp(gen);
+			fprintf(output, "\tWord t%zu = { .as_u64 = 0x%lxULL };\n", result, operand);
+			c_push(gen, result);
+		} break;
+
+		case INST_DROP: {
+			if (gen->values_size > 0) {
+				gen->values_size -= 1;
+			} else {
+				gen->popped += 1;
+			}
+		} break;
+
+		case INST_DUP: {
+			c_ensure(gen, operand);
+			c_push(gen, gen->values[gen->values_size - 1 - operand]);
+		} break;
+
+		case INST_SWAP: {
+			c_ensure(gen, operand);
+			const size_t top = gen->values[gen->values_size - 1];
+			gen->values[gen->values_size - 1] = gen->values[gen->values_size - 1 - operand];
+			gen->values[gen->values_size - 1 - operand] = top;
+		} break;
+
+		case INST_PLUSI:	c_binary(gen, "u64", "u64", "+"); break;
+		case INST_MINUSI:	c_binary(gen, "u64", "u64", "-"); break;
+		case INST_MULTI:	c_binary(gen, "i64", "i64", "*"); break;
+		case INST_MULTU:	c_binary(gen, "u64", "u64", "*"); break;
+		case INST_DIVI:		c_signed_division(gen, false); break;
+		case INST_MODI:		c_signed_division(gen, true); break;
+		case INST_DIVU:		c_division(gen, "u64", "/"); break;
+		case INST_MODU:		c_division(gen, "u64", "%"); break;
+
+		case INST_PLUSF:	c_binary(gen, "f64", "f64", "+"); break;
+		case INST_MINUSF:	c_binary(gen, "f64", "f64", "-"); break;
+		case INST_MULTF:	c_binary(gen, "f64", "f64", "*"); break;
+		case INST_DIVF:		c_binary(gen, "f64", "f64", "/"); break;
+
+		case INST_JMP: {
+			c_flush(gen);
+			fprintf(output, "\t");
+			c_goto(gen, easm, operand);
+		} break;
+
+		case INST_JMP_IF:
+		case INST_JMP_IF_NOT: {
+			const size_t cond = c_pop(gen);
+			c_flush(gen);
+			fprintf(output, "\tif (%st%zu.as_u64) ", inst.type == INST_JMP_IF ? "" : "!", cond);
+			c_goto(gen, easm, operand);
+		} break;
+
+		// NOTE: the tested value stays on the stack
+		case INST_JMP_IF_ZERO: {
+			c_ensure(gen, 0);
+			const size_t value = gen->values[gen->values_size - 1];
+			c_flush(gen);
+			fprintf(output, "\tif (!t%zu.as_u64) ", value);
+			c_goto(gen, easm, operand);
+		} break;
+
+		case INST_JMP_LTI: {
+			const size_t b = c_pop(gen);
+			const size_t a = c_pop(gen);
+			c_flush(gen);
+			fprintf(output, "\tif (t%zu.as_i64 < t%zu.as_i64) ", a, b);
+			c_goto(gen, easm, operand);
+		} break;
+
+		case INST_RET: {
+			c_flush(gen);
+			fprintf(output, "\tgoto ret;\n");
+		} break;
+
+		case INST_CALL: {
+			c_flush(gen);
+			// NOTE: the same bounds as the VM checks
+			fprintf(output, "\tif (rp >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;\n");
+			fprintf(output, "\trets[rp] = %zu;\n", i + 1);
+			fprintf(output, "\tfps[rp] = fp;\n");
+			fprintf(output, "\trp += 1;\n");
+			fprintf(output, "\tfp = sp;\n");
+			fprintf(output, "\t");
+			c_goto(gen, easm, operand);
+		} break;
+
+		case INST_NATIVE: {
+			c_flush(gen);
+			fprintf(output, "\tevm.stack_size = sp;\n");
+			fprintf(output, "\terr = ");
+			c_native_name(output, easm, operand);
+			fprintf(output, "(&evm);\n");
+			fprintf(output, "\tif (err != ERR_OK) return err;\n");
+			fprintf(output, "\tsp = evm.stack_size;\n");
+		} break;
+
+		case INST_NOT:		c_unary(gen, "u64", "!t%zu.as_u64"); break;
+
+		case INST_EQI:		c_binary(gen, "i64", "u64", "=="); break;
+		case INST_GEI:		c_binary(gen, "i64", "u64", ">="); break;
+		case INST_GTI:		c_binary(gen, "i64", "u64", ">"); break;
+		case INST_LEI:		c_binary(gen, "i64", "u64", "<="); break;
+		case INST_LTI:		c_binary(gen, "i64", "u64", "<"); break;
+		case INST_NEI:		c_binary(gen, "i64", "u64", "!="); break;
+
+		case INST_EQF:		c_binary(gen, "f64", "u64", "=="); break;
+		case INST_GEF:		c_binary(gen, "f64", "u64", ">="); break;
+		case INST_GTF:		c_binary(gen, "f64", "u64", ">"); break;
+		case INST_LEF:		c_binary(gen, "f64", "u64", "<="); break;
+		case INST_LTF:		c_binary(gen, "f64", "u64", "<"); break;
+		case INST_NEF:		c_binary(gen, "f64", "u64", "!="); break;
+
+		case INST_EQU:		c_binary(gen, "u64", "u64", "=="); break;
+		case INST_GEU:		c_binary(gen, "u64", "u64", ">="); break;
+		case INST_GTU:		c_binary(gen, "u64", "u64", ">"); break;
+		case INST_LEU:		c_binary(gen, "u64", "u64", "<="); break;
+		case INST_LTU:		c_binary(gen, "u64", "u64", "<"); break;
+		case INST_NEU:		c_binary(gen, "u64", "u64", "!="); break;
+
+		case INST_ANDB:		c_binary(gen, "u64", "u64", "&"); break;
+		case INST_ORB:		c_binary(gen, "u64", "u64", "|"); break;
+		case INST_XOR:		c_binary(gen, "u64", "u64", "^"); break;
+		case INST_SHR:		c_binary(gen, "u64", "u64", ">>"); break;
+		case INST_SHL:		c_binary(gen, "u64", "u64", "<<"); break;
+		case INST_NOTB:		c_unary(gen, "u64", "~t%zu.as_u64"); break;
+
+		case INST_READ8:	c_read(gen, 1); break;
+		case INST_READ16:	c_read(gen, 2); break;
+		case INST_READ32:	c_read(gen, 4); break;
+		case INST_READ64:	c_read(gen, 8); break;
+
+		case INST_WRITE8:	c_write(gen, 1); break;
+		case INST_WRITE16:	c_write(gen, 2); break;
+		case INST_WRITE32:	c_write(gen, 4); break;
+		case INST_WRITE64:	c_write(gen, 8); break;
+
+		case INST_I2F:		c_unary(gen, "f64", "(double) t%zu.as_i64"); break;
+		case INST_U2F:		c_unary(gen, "f64", "(double) t%zu.as_u64"); break;
+		case INST_F2I:		c_unary(gen, "i64", "f2i(t%zu.as_f64)"); break;
+		case INST_F2U:		c_unary(gen, "u64", "(uint64_t) f2i(t%zu.as_f64)"); break;
+
+		// NOTE: nothing has to reach the stack, but the drops before have to be there
+		case INST_HALT: {
+			c_check_underflow(gen, gen->popped);
+			gen->values_size = 0;
+			gen->popped = 0;
+			gen->checked = 0;
+			fprintf(output, "\treturn ERR_OK;\n");
+		} break;
+
+		// NOTE: the VM stops on it the same way
+		case INST_BREAKPOINT: {
+			c_flush(gen);
+			fprintf(output, "\tevm.stack_size = sp;\n");
+			fprintf(output, "\treturn ERR_BREAKPOINT;\n");
+		} break;
+
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM: {
+			const size_t a = c_pop(gen);
+			const size_t result = c_new_temp(gen);
+			fprintf(output, "\tWord t%zu = { .as_u64 = t%zu.as_u64 %s 0x%lxULL };\n", result, a, inst.type == INST_PLUSI_IMM ? "+" : "-", operand);
+			c_push(gen, result);
+		} break;
+
+		case INST_EQI_IMM: {
+			const size_t a = c_pop(gen);
+			const size_t result = c_new_temp(gen);
+			fprintf(output, "\tWord t%zu = { .as_u64 = t%zu.as_i64 == (int64_t) 0x%lxULL };\n", result, a, operand);
+			c_push(gen, result);
+		} break;
+
+		// NOTE: the frame slots are addressed in memory, so whatever is in variables goes there first
+		case INST_LOCAL_GET:
+		case INST_ARG_GET: {
+			c_flush(gen);
+			const size_t result = c_new_temp(gen);
+			// NOTE: the same bounds as the VM checks, the callee may have gone below its frame
+			if (inst.type == INST_LOCAL_GET) {
+				fprintf(output, "\tif (fp >= sp || %luULL >= sp - fp) return ERR_ILLEGAL_OPERAND;\n", operand);
+				fprintf(output, "\tWord t%zu = stack[fp + %lu];\n", result, operand);
+			} else {
+				fprintf(output, "\tif (%luULL >= fp) return ERR_ILLEGAL_OPERAND;\n", operand);
+				fprintf(output, "\tWord t%zu = stack[fp - 1 - %lu];\n", result, operand);
+			}
+			c_push(gen, result);
+		} break;
+
+		case INST_LOCAL_SET:
+		case INST_ARG_SET: {
+			const size_t value = c_pop(gen);
+			c_flush(gen);
+			if (inst.type == INST_LOCAL_SET) {
+				fprintf(output, "\tif (fp >= sp || %luULL >= sp - fp) return ERR_ILLEGAL_OPERAND;\n", operand);
+				fprintf(output, "\tstack[fp + %lu] = t%zu;\n", operand, value);
+			} else {
+				fprintf(output, "\tif (%luULL >= fp || fp - 1 - %luULL >= sp) return ERR_ILLEGAL_OPERAND;\n", operand, operand);
+				fprintf(output, "\tstack[fp - 1 - %lu] = t%zu;\n", operand, value);
+			}
+		} break;
+
+		case EASM_NUMBER_OF_INSTS:
+		default: UNREACHABLE("NOT EXISTING INST_TYPE");
+	}
+}
+
+int main(int argc, char **argv) {
+	shift(&argc, &argv);        // skip the program
+
+	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
+	static EASM easm = { 0 };
+
+	const char *input_file_path = NULL;
+	const char *output_file_path = NULL;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+
+		if (strcmp(flag, "-I") == 0) {
+			if (argc == 0) {
+				usage(stderr);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			easm_add_include_path(&easm, sv_from_cstr(shift(&argc, &argv)));
+		} else if (input_file_path == NULL) {
+			input_file_path = flag;
+		} else if (output_file_path == NULL) {
+			output_file_path = flag;
+		} else {
+			usage(stderr);
+			fprintf(stderr, "ERROR: unexpected argument `%s`\n", flag);
+			exit(1);
+		}
+	}
+
+	if (input_file_path == NULL) {
+		usage(stderr);
+		fprintf(stderr, "ERROR: no input provided\n");
+		exit(1);
+	}
+
+    	if (output_file_path == NULL) {
+        	usage(stderr);
+        	fprintf(stderr, "ERROR: no output provided.\n");
+        	exit(1);
+    	}
+
+	easm_translate_source(&easm, sv_from_cstr(input_file_path));
+
+	if (easm.memory_capacity > EVM_MEMORY_CAPACITY) {
+		fprintf(stderr, "ERROR: %s: memory section is too big. The program wants %lu bytes. But the capacity is %lu bytes\n", input_file_path, easm.memory_capacity, (uint64_t) EVM_MEMORY_CAPACITY);
+		exit(1);
+	}
+
+	FILE *output = fopen(output_file_path, "wb");
+	if (output == NULL) {
+		fprintf(stderr, "ERROR: could not open file %s: %s\n", output_file_path, strerror(errno));
+		exit(1);
+	}
+
+	// NOTE: everything that can be jumped or returned to starts a new basic block, only the
+	// jump targets and the return sites need a label
+	int *reloc = malloc(sizeof(*reloc) * (easm.program_size + 1));
+	bool *is_target = calloc(easm.program_size + 1, sizeof(*is_target));
+	bool *is_label = calloc(easm.program_size + 1, sizeof(*is_label));
+	if (reloc == NULL || is_target == NULL || is_label == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the basic blocks: %s\n", strerror(errno));
+		exit(1);
+	}
+	easm_find_targets(&easm, reloc, is_target);
+	bool has_calls = false;
+	bool has_rets = false;
+	bool has_natives = false;
+	for (size_t i = 0; i < easm.program_size; ++i) {
+		const Inst inst = easm.program[i];
+		if (easm_inst_has_code_operand(inst.type) && inst.operand.as_u64 < easm.program_size) {
+			is_label[inst.operand.as_u64] = true;
+		}
+		if (inst.type == INST_CALL) {
+			is_label[i + 1] = true;
+			has_calls = true;
+		}
+		if (inst.type == INST_RET) has_rets = true;
+		if (inst.type == INST_NATIVE) has_natives = true;
+	}
+	if (easm.entry < easm.program_size) is_label[easm.entry] = true;
+
+	fprintf(output, "// NOTE: generated by easm2c from %s\n", input_file_path);
+	fprintf(output, "// NOTE: -DEVM_EXTERN_IMPLEMENTATION to link src/evm.c compiled on its own instead\n");
+	fprintf(output, "#ifndef EVM_EXTERN_IMPLEMENTATION\n");
+	fprintf(output, "#define EVM_IMPLEMENTATION\n");
+	fprintf(output, "#endif // EVM_EXTERN_IMPLEMENTATION\n");
+	fprintf(output, "#include \"evm.h\"\n");
+	fprintf(output, "\n");
+
+	static bool native_is_declared[EVM_NATIVES_CAPACITY] = { 0 };
+	for (size_t i = 0; i < easm.program_size; ++i) {
+		const Inst inst = easm.program[i];
+		if (inst.type != INST_NATIVE) continue;
+		if (inst.operand.as_u64 >= EVM_NATIVES_CAPACITY) {
+			fprintf(stderr, "ERROR: native %lu is out of the %d natives the VM has\n", inst.operand.as_u64, EVM_NATIVES_CAPACITY);
+			exit(1);
+		}
+		if (inst.operand.as_u64 != 0 && !native_is_declared[inst.operand.as_u64]) {
+			fprintf(output, "Err ");
+			c_native_name(output, &easm, inst.operand.as_u64);
+			fprintf(output, "(EVM *evm);\n");
+			native_is_declared[inst.operand.as_u64] = true;
+		}
+	}
+
+	// NOTE: the natives take the EVM, so the stack and the memory are the ones of a static EVM
+	fprintf(output, "static EVM evm = { 0 };\n");
+	// NOTE: a double out of the range of int64_t is undefined in C, but the VM always got what
+	// cvttsd2si gives for it, which is INT64_MIN
+	fprintf(output, "static inline int64_t f2i(double x) {\n");
+	fprintf(output, "\treturn x >= -9223372036854775808.0 && x < 9223372036854775808.0 ? (int64_t) x : INT64_MIN;\n");
+	fprintf(output, "}\n");
+	if (easm.memory_size > 0) {
+		fprintf(output, "static const uint8_t memory_init[%zu] = {", easm.memory_size);
+		for (size_t i = 0; i < easm.memory_size; ++i) {
+			fprintf(output, "%s%u,", i % 16 == 0 ? "\n\t" : " ", easm.memory[i]);
+		}
+		fprintf(output, "\n};\n");
+	}
+	fprintf(output, "\n");
+
+	fprintf(output, "static Err run(void) {\n");
+	fprintf(output, "\tWord *const stack = evm.stack;\n");
+	fprintf(output, "\tuint64_t sp = 0;\n");
+	fprintf(output, "\tuint64_t fp = 0;\n");
+	if (has_calls || has_rets) {
+		fprintf(output, "\tInst_Addr rets[EVM_RET_STACK_CAPACITY];\n");
+		fprintf(output, "\tuint64_t fps[EVM_RET_STACK_CAPACITY];\n");
+		fprintf(output, "\tuint64_t rp = 0;\n");
+	}
+	if (has_natives) fprintf(output, "\tErr err = ERR_OK;\n");
+	if (easm.entry < easm.program_size) {
+		fprintf(output, "\tgoto inst_%zu;\n", easm.entry);
+	} else {
+		fprintf(output, "\treturn ERR_ILLEGAL_INST_ACCESS;\n");
+	}
+	fprintf(output, "\t{\n");
+
+	static C_Gen gen = { 0 };
+	gen.output = output;
+	for (size_t i = 0; i < easm.program_size; ++i) {
+		if (is_target[i]) {
+			c_flush(&gen);
+			fprintf(output, "\t}\n");
+			if (is_label[i]) fprintf(output, "inst_%zu:;\n", i);
+			fprintf(output, "\t{\n");
+		}
+		fprintf(output, "\t// %s", inst_name(easm.program[i].type));
+		if (inst_has_operand(easm.program[i].type)) {
+			fprintf(output, " %lu", easm.program[i].operand.as_u64);
+		}
+		fprintf(output, "\n");
+		c_inst(&gen, &easm, i);
+	}
+	c_flush(&gen);
+	fprintf(output, "\t}\n");
+	// NOTE: running past the last instruction
+	fprintf(output, "\treturn ERR_ILLEGAL_INST_ACCESS;\n");
+
+	if (has_rets) {
+		fprintf(output, "ret:\n");
+		fprintf(output, "\tif (rp == 0) return ERR_STACK_UNDERFLOW;\n");
+		fprintf(output, "\trp -= 1;\n");
+		fprintf(output, "\tfp = fps[rp];\n");
+		fprintf(output, "\tswitch (rets[rp]) {\n");
+		for (size_t i = 0; i < easm.program_size; ++i) {
+			if (easm.program[i].type == INST_CALL && i + 1 < easm.program_size) {
+				fprintf(output, "\t\tcase %zu: goto inst_%zu;\n", i + 1, i + 1);
+			}
+		}
+		fprintf(output, "\t}\n");
+		fprintf(output, "\treturn ERR_ILLEGAL_INST_ACCESS;\n");
+	}
+	fprintf(output, "}\n");
+	fprintf(output, "\n");
+
+	fprintf(output, "int main(void) {\n");
+	if (easm.memory_size > 0) {
+		fprintf(output, "\tmemcpy(evm.memory, memory_init, sizeof(memory_init));\n");
+	}
+	// NOTE: the Err is the exit code like in the executables of easm2nasm and easm2elf
+	fprintf(output, "\tconst Err err = run();\n");
+	fprintf(output, "\tif (err != ERR_OK) {\n");
+	fprintf(output, "\t\tfprintf(stderr, \"ERROR: %%s\\n\", err_as_cstr(err));\n");
+	fprintf(output, "\t\treturn (int) err;\n");
+	fprintf(output, "\t}\n");
+	fprintf(output, "\treturn 0;\n");
+	fprintf(output, "}\n");
+
+	fclose(output);
+	free(gen.values);
+	free(reloc);
+	free(is_target);
+	free(is_label);
+	easm_clean(&easm);
+	return 0;
+}
@@ -0,0 +1,1031 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "./evm.h"
+
+// NOTE: the same code easm2nasm produces, encoded right away into a static ELF64 executable
+// so neither nasm nor ld is needed. Only `native write` and `native clock` can be used, they
+// are syscalls and there is nothing to link the other natives with.
+
+#define ELF_TEXT_VADDR 0x400000
+#define ELF_DATA_VADDR 0x40000000
+#define ELF_PAGE_SIZE 0x1000
+
+#define ELF_STACK_SIZE (EVM_STACK_CAPACITY * EVM_WORD_SIZE)
+#define ELF_FRAMES_SIZE (EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE)
+
+#define SYS_EXIT 60
+#define SYS_WRITE 1
+#define SYS_CLOCK_GETTIME 228
+#define STDOUT 1
+#define LINUX_CLOCK_MONOTONIC 1
+
+static void usage(FILE *f) {
+		fprintf(f, "Usage: easm2elf [-g] [-I <dir>]... <input.easm> <output>\n");
+		fprintf(f, "  -g    also write the DWARF line info mapping the code to the easm source\n");
+}
+
+static char *shift(int *argc, char ***argv) {
+	assert(*argc > 0);
+	char *result = **argv;
+	*argv += 1;
+	*argc -= 1;
+	return result;
+}
+
+typedef struct {
+	uint8_t *items;
+	size_t size;
+	size_t capacity;
+} Bytes;
+
+static void bytes_push(Bytes *bytes, const void *data, size_t size) {
+	EASM_TABLE_RESERVE(bytes->items, bytes->size, bytes->capacity, size);
+	memcpy(bytes->items + bytes->size, data, size);
+	bytes->size += size;
+}
+
+static void bytes_u8(Bytes *bytes, uint8_t x) {
+	bytes_push(bytes, &x, 1);
+}
+
+static void bytes_u16(Bytes *bytes, uint16_t x) {
+	for (int i = 0; i < 2; ++i) bytes_u8(bytes, (uint8_t) (x >> (8 * i)));
+}
+
+static void bytes_u32(Bytes *bytes, uint32_t x) {
+	for (int i = 0; i < 4; ++i) bytes_u8(bytes, (uint8_t) (x >> (8 * i)));
+}
+
+static void bytes_u64(Bytes *bytes, uint64_t x) {
+	for (int i = 0; i < 8; ++i) bytes_u8(bytes, (uint8_t) (x >> (8 * i)));
+}
+
+static void bytes_uleb(Bytes *bytes, uint64_t x) {
+	do {
+		uint8_t byte = x & 0x7F;
+		x >>= 7;
+		if (x != 0) byte |= 0x80;
+		bytes_u8(bytes, byte);
+	} while (x != 0);
+}
+
+static void bytes_sleb(Bytes *bytes, int64_t x) {
+	bool more = true;
+	while (more) {
+		uint8_t byte = x & 0x7F;
+		x >>= 7;
+		more = !((x == 0 && (byte & 0x40) == 0) || (x == -1 && (byte & 0x40) != 0));
+		if (more) byte |= 0x80;
+		bytes_u8(bytes, byte);
+	}
+}
+
+static void bytes_sv(Bytes *bytes, String_View sv) {
+	bytes_push(bytes, sv.data, sv.count);
+	bytes_u8(bytes, 0);
+}
+
+static void bytes_patch_u32(Bytes *bytes, size_t at, uint32_t x) {
+	for (int i = 0; i < 4; ++i) bytes->items[at + (size_t) i] = (uint8_t) (x >> (8 * i));
+}
+
+static void bytes_align(Bytes *bytes, size_t alignment) {
+	while (bytes->size % alignment != 0) bytes_u8(bytes, 0);
+}
+
+typedef enum {
+	RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+	R13 = 13, R14 = 14, R15 = 15,
+} Reg;
+
+// NOTE: register numbers of xmm0 and xmm1 and of the byte registers al and bl
+#define XMM0 RAX
+#define XMM1 RCX
+#define AL RAX
+#define BL RBX
+
+// NOTE: the opcode bytes go from the most significant one, no opcode used here starts with 0
+static void emit_opcode(Bytes *code, uint32_t op) {
+	if (op > 0xFFFF) bytes_u8(code, (uint8_t) (op >> 16));
+	if (op > 0xFF) bytes_u8(code, (uint8_t) (op >> 8));
+	bytes_u8(code, (uint8_t) op);
+}
+
+static void emit_prefix_rex(Bytes *code, uint8_t prefix, bool w, int reg, int base) {
+	if (prefix != 0) bytes_u8(code, prefix);
+	const uint8_t rex = (uint8_t) (0x40 | (w << 3) | ((reg >> 3) << 2) | (base >> 3));
+	if (rex != 0x40) bytes_u8(code, rex);
+}
+
+// NOTE: `op reg, rm` with both of them registers
+static void emit_rr(Bytes *code, uint8_t prefix, bool w, uint32_t op, int reg, int rm) {
+	emit_prefix_rex(code, prefix, w, reg, rm);
+	emit_opcode(code, op);
+	bytes_u8(code, (uint8_t) (0xC0 | ((reg & 7) << 3) | (rm & 7)));
+}
+
+// NOTE: `op reg, [base + disp]`, rsp/r12 as the base need a SIB byte and rbp/r13 a displacement
+static void emit_rm(Bytes *code, uint8_t prefix, bool w, uint32_t op, int reg, int base, int32_t disp) {
+	emit_prefix_rex(code, prefix, w, reg, base);
+	emit_opcode(code, op);
+	uint8_t mod = 0x00;
+	if (disp != 0 || (base & 7) == RBP) mod = (disp >= -128 && disp <= 127) ? 0x40 : 0x80;
+	bytes_u8(code, (uint8_t) (mod | ((reg & 7) << 3) | (base & 7)));
+	if ((base & 7) == RSP) bytes_u8(code, 0x24);
+	if (mod == 0x40) bytes_u8(code, (uint8_t) disp);
+	if (mod == 0x80) bytes_u32(code, (uint32_t) disp);
+}
+
+static void emit_mov_rr(Bytes *code, int dst, int src) {
+	emit_rr(code, 0, true, 0x89, src, dst);
+}
+
+static void emit_load(Bytes *code, int dst, int base, int32_t disp) {
+	emit_rm(code, 0, true, 0x8B, dst, base, disp);
+}
+
+static void emit_store(Bytes *code, int base, int32_t disp, int src) {
+	emit_rm(code, 0, true, 0x89, src, base, disp);
+}
+
+static void emit_mov_ri(Bytes *code, int dst, uint64_t imm) {
+	if ((int64_t) imm >= INT32_MIN && (int64_t) imm <= INT32_MAX) {
+		emit_rr(code, 0, true, 0xC7, 0, dst);
+		bytes_u32(code, (uint32_t) imm);
+	} else {
+		emit_prefix_rex(code, 0, true, 0, dst);
+		bytes_u8(code, (uint8_t) (0xB8 + (dst & 7)));
+		bytes_u64(code, imm);
+	}
+}
+
+// NOTE: `op dst, imm32` of the 0x81 group: /0 add, /1 or, /4 and, /5 sub, /7 cmp
+static void emit_alu_ri(Bytes *code, int ext, int dst, int32_t imm) {
+	emit_rr(code, 0, true, 0x81, ext, dst);
+	bytes_u32(code, (uint32_t) imm);
+}
+
+// NOTE: `op dst, src` for 0x01 add, 0x09 or, 0x21 and, 0x29 sub, 0x31 xor, 0x39 cmp, 0x85 test
+static void emit_alu_rr(Bytes *code, uint32_t op, int dst, int src) {
+	emit_rr(code, 0, true, op, src, dst);
+}
+
+#define ALU_ADD 0x01
+#define ALU_OR 0x09
+#define ALU_AND 0x21
+#define ALU_SUB 0x29
+#define ALU_XOR 0x31
+#define ALU_CMP 0x39
+#define ALU_TEST 0x85
+
+#define EXT_ADD 0
+#define EXT_SUB 5
+#define EXT_CMP 7
+
+#define JMP 0xE9
+#define CALL 0xE8
+#define JZ 0x0F84
+#define JNZ 0x0F85
+#define JL 0x0F8C
+
+typedef struct {
+	size_t at;		// the rel32 to patch
+	uint64_t target;	// an instruction, or program_size for illegal_inst_access
+} Fixup;
+
+typedef struct {
+	const EASM *easm;
+	Bytes code;
+	bool cached;
+	// NOTE: where every instruction starts in the code, [program_size] is illegal_inst_access
+	size_t *offsets;
+	Fixup *fixups;
+	size_t fixups_size;
+	size_t fixups_capacity;
+	uint64_t memory_vaddr;
+	uint64_t memory_init_vaddr;
+	uint64_t stack_vaddr;
+	uint64_t frames_vaddr;
+} Elf_Gen;
+
+// NOTE: the targets are known at translation time, outside of the program the VM fails
+// with ERR_ILLEGAL_INST_ACCESS, so does the executable
+static void emit_jump(Elf_Gen *gen, uint32_t op, uint64_t target) {
+	emit_opcode(&gen->code, op);
+	EASM_TABLE_RESERVE(gen->fixups, gen->fixups_size, gen->fixups_capacity, 1);
+	gen->fixups[gen->fixups_size++] = (Fixup) {
+		.at = gen->code.size,
+		.target = target < gen->easm->program_size ? target : gen->easm->program_size,
+	};
+	bytes_u32(&gen->code, 0);
+}
+
+static void emit_syscall(Bytes *code) {
+	bytes_u8(code, 0x0F);
+	bytes_u8(code, 0x05);
+}
+
+// NOTE: the top of the VM stack may be in rax instead of [r15 - EVM_WORD_SIZE] like in easm2nasm
+static void emit_flush(Elf_Gen *gen) {
+	if (gen->cached) {
+		emit_store(&gen->code, R15, 0, RAX);
+		emit_alu_ri(&gen->code, EXT_ADD, R15, EVM_WORD_SIZE);
+		gen->cached = false;
+	}
+}
+
+static void emit_load_top(Elf_Gen *gen) {
+	if (!gen->cached) {
+		emit_alu_ri(&gen->code, EXT_SUB, R15, EVM_WORD_SIZE);
+		emit_load(&gen->code, RAX, R15, 0);
+		gen->cached = true;
+	}
+}
+
+// NOTE: `a b` to rax and rbx, the result is left in rax as the new top
+static void emit_load_binary(Elf_Gen *gen) {
+	emit_load_top(gen);
+	emit_mov_rr(&gen->code, RBX, RAX);
+	emit_alu_ri(&gen->code, EXT_SUB, R15, EVM_WORD_SIZE);
+	emit_load(&gen->code, RAX, R15, 0);
+}
+
+static void emit_setcc_movzx(Bytes *code, uint32_t setcc) {
+	emit_rr(code, 0, false, setcc, 0, AL);
+	emit_rr(code, 0, true, 0x0FB6, RAX, AL);
+}
+
+static void emit_compare(Elf_Gen *gen, uint32_t setcc) {
+	emit_load_binary(gen);
+	emit_alu_rr(&gen->code, ALU_CMP, RAX, RBX);
+	emit_setcc_movzx(&gen->code, setcc);
+}
+
+static void emit_xmm_from_binary(Elf_Gen *gen) {
+	emit_load_binary(gen);
+	emit_rr(&gen->code, 0x66, true, 0x0F6E, XMM0, RAX);
+	emit_rr(&gen->code, 0x66, true, 0x0F6E, XMM1, RBX);
+}
+
+static void emit_binary_float(Elf_Gen *gen, uint32_t op) {
+	emit_xmm_from_binary(gen);
+	emit_rr(&gen->code, 0xF2, false, op, XMM0, XMM1);
+	emit_rr(&gen->code, 0x66, true, 0x0F7E, XMM0, RAX);
+}
+
+// NOTE: ucomisd reports NaN as unordered, so the conditions have to be the ones that are
+// false for it: `a < b` is tested as `b > a`
+static void emit_compare_float(Elf_Gen *gen, bool swapped, uint32_t setcc) {
+	emit_xmm_from_binary(gen);
+	if (swapped) {
+		emit_rr(&gen->code, 0x66, false, 0x0F2E, XMM1, XMM0);
+	} else {
+		emit_rr(&gen->code, 0x66, false, 0x0F2E, XMM0, XMM1);
+	}
+	emit_setcc_movzx(&gen->code, setcc);
+}
+
+// NOTE: eqf is `ZF && !PF`, nef is `!ZF || PF`
+static void emit_compare_float_parity(Elf_Gen *gen, uint32_t setcc, uint32_t setp, uint32_t combine) {
+	emit_xmm_from_binary(gen);
+	emit_rr(&gen->code, 0x66, false, 0x0F2E, XMM0, XMM1);
+	emit_rr(&gen->code, 0, false, setcc, 0, AL);
+	emit_rr(&gen->code, 0, false, setp, 0, BL);
+	emit_rr(&gen->code, 0, false, combine, BL, AL);
+	emit_rr(&gen->code, 0, true, 0x0FB6, RAX, AL);
+}
+
+static void emit_read(Elf_Gen *gen, bool w, uint32_t op) {
+	emit_load_top(gen);
+	emit_alu_ri(&gen->code, EXT_ADD, RAX, (int32_t) gen->memory_vaddr);
+	emit_rm(&gen->code, 0, w, op, RAX, RAX, 0);
+}
+
+static void emit_write(Elf_Gen *gen, uint8_t prefix, bool w, uint32_t op) {
+	emit_load_top(gen);
+	emit_alu_ri(&gen->code, EXT_SUB, R15, EVM_WORD_SIZE);
+	emit_load(&gen->code, RSI, R15, 0);
+	emit_alu_ri(&gen->code, EXT_ADD, RSI, (int32_t) gen->memory_vaddr);
+	emit_rm(&gen->code, prefix, w, op, RAX, RSI, 0);
+	gen->cached = false;
+}
+
+static void emit_exit(Bytes *code, uint64_t status) {
+	emit_mov_ri(code, RAX, SYS_EXIT);
+	emit_mov_ri(code, RDI, status);
+	emit_syscall(code);
+}
+
+static void emit_inst(Elf_Gen *gen, Inst inst) {
+	Bytes *code = &gen->code;
+	const uint64_t operand = inst.operand.as_u64;
+	const int32_t slot = (int32_t) (EVM_WORD_SIZE * operand);
+
+	switch (inst.type) {
+		case INST_NOP: bytes_u8(code, 0x90); break;
+
+		case INST_PUSH: {
+			emit_flush(gen);
+			emit_mov_ri(code, RAX, operand);
+			gen->cached = true;
+		} break;
+
+		case INST_DROP: {
+			if (gen->cached) {
+				gen->cached = false;
+			} else {
+				emit_alu_ri(code, EXT_SUB, R15, EVM_WORD_SIZE);
+			}
+		} break;
+
+		case INST_DUP: {
+			if (!gen->cached) {
+				emit_load(code, RAX, R15, -slot - EVM_WORD_SIZE);
+			} else if (operand == 0) {
+				emit_store(code, R15, 0, RAX);
+				emit_alu_ri(code, EXT_ADD, R15, EVM_WORD_SIZE);
+			} else {
+				emit_load(code, RBX, R15, -slot);
+				emit_store(code, R15, 0, RAX);
+				emit_alu_ri(code, EXT_ADD, R15, EVM_WORD_SIZE);
+				emit_mov_rr(code, RAX, RBX);
+			}
+			gen->cached = true;
+		} break;
+
+		case INST_SWAP: {
+			emit_load_top(gen);
+			emit_load(code, RBX, R15, -slot);
+			emit_store(code, R15, -slot, RAX);
+			emit_mov_rr(code, RAX, RBX);
+		} break;
+
+		case INST_PLUSI:	emit_load_binary(gen); emit_alu_rr(code, ALU_ADD, RAX, RBX); break;
+		case INST_MINUSI:	emit_load_binary(gen); emit_alu_rr(code, ALU_SUB, RAX, RBX); break;
+		// NOTE: the low 64 bits of a product are the same signed or not
+		case INST_MULTI:
+		case INST_MULTU: {
+			emit_load_binary(gen);
+			emit_rr(code, 0, true, 0x0FAF, RAX, RBX);
+		} break;
+		// NOTE: idiv traps on INT64_MIN / -1, the VM wraps the quotient around and the
+		// remainder is 0, so -1 is done by neg and xor instead
+		case INST_DIVI:
+		case INST_MODI: {
+			emit_load_binary(gen);
+			emit_alu_ri(code, EXT_CMP, RBX, -1);
+			bytes_u8(code, 0x75);		// jne divide
+			const size_t to_divide = code->size;
+			bytes_u8(code, 0);
+			if (inst.type == INST_MODI) {
+				emit_alu_rr(code, ALU_XOR, RAX, RAX);
+			} else {
+				emit_rr(code, 0, true, 0xF7, 3, RAX);	// neg rax
+			}
+			bytes_u8(code, 0xEB);		// jmp done
+			const size_t to_done = code->size;
+			bytes_u8(code, 0);
+			code->items[to_divide] = (uint8_t) (code->size - to_divide - 1);
+			bytes_u8(code, 0x48);
+			bytes_u8(code, 0x99);		// cqo
+			emit_rr(code, 0, true, 0xF7, 7, RBX);
+			if (inst.type == INST_MODI) emit_mov_rr(code, RAX, RDX);
+			code->items[to_done] = (uint8_t) (code->size - to_done - 1);
+		} break;
+		case INST_DIVU:
+		case INST_MODU: {
+			emit_load_binary(gen);
+			emit_alu_rr(code, ALU_XOR, RDX, RDX);
+			emit_rr(code, 0, true, 0xF7, 6, RBX);
+			if (inst.type == INST_MODU) emit_mov_rr(code, RAX, RDX);
+		} break;
+
+		case INST_PLUSF:	emit_binary_float(gen, 0x0F58); break;
+		case INST_MINUSF:	emit_binary_float(gen, 0x0F5C); break;
+		case INST_MULTF:	emit_binary_float(gen, 0x0F59); break;
+		case INST_DIVF:		emit_binary_float(gen, 0x0F5E); break;
+
+		case INST_JMP: {
+			emit_flush(gen);
+			emit_jump(gen, JMP, operand);
+		} break;
+
+		case INST_JMP_IF:
+		case INST_JMP_IF_NOT: {
+			emit_load_top(gen);
+			gen->cached = false;
+			emit_alu_rr(code, ALU_TEST, RAX, RAX);
+			emit_jump(gen, inst.type == INST_JMP_IF ? JNZ : JZ, operand);
+		} break;
+
+		// NOTE: the frames are followed by the memory, running out of them or returning with none
+		// traps like in the VM instead of going through it
+		case INST_RET: {
+			emit_flush(gen);
+			emit_alu_ri(code, EXT_CMP, R13, (int32_t) gen->frames_vaddr);
+			bytes_u8(code, 0x77);		// ja has_frame
+			const size_t to_has_frame = code->size;
+			bytes_u8(code, 0);
+			emit_exit(code, ERR_STACK_UNDERFLOW);
+			code->items[to_has_frame] = (uint8_t) (code->size - to_has_frame - 1);
+			emit_alu_ri(code, EXT_SUB, R13, EVM_WORD_SIZE);
+			emit_load(code, R14, R13, 0);
+			bytes_u8(code, 0xC3);
+		} break;
+
+		case INST_CALL: {
+			emit_flush(gen);
+			emit_alu_ri(code, EXT_CMP, R13, (int32_t) (gen->frames_vaddr + ELF_FRAMES_SIZE));
+			bytes_u8(code, 0x72);		// jb has_room
+			const size_t to_has_room = code->size;
+			bytes_u8(code, 0);
+			emit_exit(code, ERR_STACK_OVERFLOW);
+			code->items[to_has_room] = (uint8_t) (code->size - to_has_room - 1);
+			emit_store(code, R13, 0, R14);
+			emit_alu_ri(code, EXT_ADD, R13, EVM_WORD_SIZE);
+			emit_mov_rr(code, R14, R15);
+			emit_jump(gen, CALL, operand);
+		} break;
+
+		// NOTE: native 0 is write and native 1 is clock like in evm_load_standard_natives. The
+		// timespec of clock_gettime goes to the hardware stack, the frames are right after the
+		// VM stack so the push is checked like evm_native_clock does
+		case INST_NATIVE: {
+			emit_flush(gen);
+			if (operand == 0) {
+				emit_alu_ri(code, EXT_SUB, R15, EVM_WORD_SIZE * 2);
+				emit_load(code, RSI, R15, 0);
+				emit_alu_ri(code, EXT_ADD, RSI, (int32_t) gen->memory_vaddr);
+				emit_load(code, RDX, R15, EVM_WORD_SIZE);
+				emit_mov_ri(code, RDI, STDOUT);
+				emit_mov_ri(code, RAX, SYS_WRITE);
+				emit_syscall(code);
+			} else {
+				emit_alu_ri(code, EXT_CMP, R15, (int32_t) (gen->stack_vaddr + ELF_STACK_SIZE));
+				bytes_u8(code, 0x72);		// jb has_room
+				const size_t to_has_room = code->size;
+				bytes_u8(code, 0);
+				emit_exit(code, ERR_STACK_OVERFLOW);
+				code->items[to_has_room] = (uint8_t) (code->size - to_has_room - 1);
+				emit_alu_ri(code, EXT_SUB, RSP, 16);
+				emit_mov_ri(code, RAX, SYS_CLOCK_GETTIME);
+				emit_mov_ri(code, RDI, LINUX_CLOCK_MONOTONIC);
+				emit_mov_rr(code, RSI, RSP);
+				emit_syscall(code);
+				emit_load(code, RAX, RSP, 0);
+				emit_rr(code, 0, true, 0x69, RAX, RAX);		// imul rax, rax, imm32
+				bytes_u32(code, 1000000000);
+				emit_rm(code, 0, true, 0x03, RAX, RSP, 8);	// add rax, [rsp + 8]
+				emit_alu_ri(code, EXT_ADD, RSP, 16);
+				gen->cached = true;
+			}
+		} break;
+
+		case INST_NOT: {
+			emit_load_top(gen);
+			emit_alu_rr(code, ALU_TEST, RAX, RAX);
+			emit_setcc_movzx(code, 0x0F94);
+		} break;
+
+		case INST_EQI:		emit_compare(gen, 0x0F94); break;
+		case INST_GEI:		emit_compare(gen, 0x0F9D); break;
+		case INST_GTI:		emit_compare(gen, 0x0F9F); break;
+		case INST_LEI:		emit_compare(gen, 0x0F9E); break;
+		case INST_LTI:		emit_compare(gen, 0x0F9C); break;
+		case INST_NEI:		emit_compare(gen, 0x0F95); break;
+
+		case INST_EQU:		emit_compare(gen, 0x0F94); break;
+		case INST_GEU:		emit_compare(gen, 0x0F93); break;
+		case INST_GTU:		emit_compare(gen, 0x0F97); break;
+		case INST_LEU:		emit_compare(gen, 0x0F96); break;
+		case INST_LTU:		emit_compare(gen, 0x0F92); break;
+		case INST_NEU:		emit_compare(gen, 0x0F95); break;
+
+		case INST_EQF:		emit_compare_float_parity(gen, 0x0F94, 0x0F9B, 0x20); break;
+		case INST_GEF:		emit_compare_float(gen, false, 0x0F93); break;
+		case INST_GTF:		emit_compare_float(gen, false, 0x0F97); break;
+		case INST_LEF:		emit_compare_float(gen, true, 0x0F93); break;
+		case INST_LTF:		emit_compare_float(gen, true, 0x0F97); break;
+		case INST_NEF:		emit_compare_float_parity(gen, 0x0F95, 0x0F9A, 0x08); break;
+
+		case INST_ANDB:		emit_load_binary(gen); emit_alu_rr(code, ALU_AND, RAX, RBX); break;
+		case INST_ORB:		emit_load_binary(gen); emit_alu_rr(code, ALU_OR, RAX, RBX); break;
+		case INST_XOR:		emit_load_binary(gen); emit_alu_rr(code, ALU_XOR, RAX, RBX); break;
+		case INST_SHR:
+		case INST_SHL: {
+			emit_load_binary(gen);
+			emit_mov_rr(code, RCX, RBX);
+			emit_rr(code, 0, true, 0xD3, inst.type == INST_SHR ? 5 : 4, RAX);
+		} break;
+
+		case INST_NOTB: {
+			emit_load_top(gen);
+			emit_rr(code, 0, true, 0xF7, 2, RAX);
+		} break;
+
+		case INST_READ8:	emit_read(gen, false, 0x0FB6); break;
+		case INST_READ16:	emit_read(gen, false, 0x0FB7); break;
+		case INST_READ32:	emit_read(gen, false, 0x8B); break;
+		case INST_READ64:	emit_read(gen, true, 0x8B); break;
+
+		case INST_WRITE8:	emit_write(gen, 0, false, 0x88); break;
+		case INST_WRITE16:	emit_write(gen, 0x66, false, 0x89); break;
+		case INST_WRITE32:	emit_write(gen, 0, false, 0x89); break;
+		case INST_WRITE64:	emit_write(gen, 0, true, 0x89); break;
+
+		case INST_I2F: {
+			emit_load_top(gen);
+			emit_rr(code, 0xF2, true, 0x0F2A, XMM0, RAX);
+			emit_rr(code, 0x66, true, 0x0F7E, XMM0, RAX);
+		} break;
+
+		case INST_U2F: {
+			// NOTE: there is only a signed conversion, the numbers with the top bit set are
+			// halved keeping the lowest bit for the rounding and doubled back
+			emit_load_top(gen);
+			emit_alu_rr(code, ALU_TEST, RAX, RAX);
+			bytes_u8(code, 0x78);		// js big
+			const size_t to_big = code->size;
+			bytes_u8(code, 0);
+			emit_rr(code, 0xF2, true, 0x0F2A, XMM0, RAX);
+			bytes_u8(code, 0xEB);		// jmp done
+			const size_t to_done = code->size;
+			bytes_u8(code, 0);
+			code->items[to_big] = (uint8_t) (code->size - to_big - 1);
+			emit_mov_rr(code, RBX, RAX);
+			emit_rr(code, 0, true, 0xD1, 5, RBX);
+			emit_alu_ri(code, 4, RAX, 1);
+			emit_alu_rr(code, ALU_OR, RBX, RAX);
+			emit_rr(code, 0xF2, true, 0x0F2A, XMM0, RBX);
+			emit_rr(code, 0xF2, false, 0x0F58, XMM0, XMM0);
+			code->items[to_done] = (uint8_t) (code->size - to_done - 1);
+			emit_rr(code, 0x66, true, 0x0F7E, XMM0, RAX);
+		} break;
+
+		// NOTE: the VM turns floats to unsigned through int64_t as well
+		case INST_F2I:
+		case INST_F2U: {
+			emit_load_top(gen);
+			emit_rr(code, 0x66, true, 0x0F6E, XMM0, RAX);
+			emit_rr(code, 0xF2, true, 0x0F2C, RAX, XMM0);
+		} break;
+
+		case INST_HALT: {
+			emit_exit(code, 0);
+			gen->cached = false;
+		} break;
+
+		case INST_BREAKPOINT: {
+			emit_flush(gen);
+			bytes_u8(code, 0xCC);	// int3
+		} break;
+
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM: {
+			emit_load_top(gen);
+			emit_mov_ri(code, RBX, operand);
+			emit_alu_rr(code, inst.type == INST_PLUSI_IMM ? ALU_ADD : ALU_SUB, RAX, RBX);
+		} break;
+
+		case INST_EQI_IMM: {
+			emit_load_top(gen);
+			emit_mov_ri(code, RBX, operand);
+			emit_alu_rr(code, ALU_CMP, RAX, RBX);
+			emit_setcc_movzx(code, 0x0F94);
+		} break;
+
+		case INST_JMP_IF_ZERO: {
+			emit_flush(gen);
+			emit_rm(code, 0, true, 0x83, 7, R15, -EVM_WORD_SIZE);
+			bytes_u8(code, 0);
+			emit_jump(gen, JZ, operand);
+		} break;
+
+		case INST_JMP_LTI: {
+			emit_load_top(gen);
+			gen->cached = false;
+			emit_alu_ri(code, EXT_SUB, R15, EVM_WORD_SIZE);
+			emit_rm(code, 0, true, ALU_CMP, RAX, R15, 0);
+			emit_jump(gen, JL, operand);
+		} break;
+
+		// NOTE: the slot might be the cached top itself, so it goes to memory first
+		case INST_LOCAL_GET:
+		case INST_ARG_GET: {
+			emit_flush(gen);
+			emit_load(code, RAX, R14, inst.type == INST_LOCAL_GET ? slot : -slot - EVM_WORD_SIZE);
+			gen->cached = true;
+		} break;
+
+		case INST_LOCAL_SET:
+		case INST_ARG_SET: {
+			emit_load_top(gen);
+			emit_store(code, R14, inst.type == INST_LOCAL_SET ? slot : -slot - EVM_WORD_SIZE, RAX);
+			gen->cached = false;
+		} break;
+
+		case EASM_NUMBER_OF_INSTS:
+		default: UNREACHABLE("NOT EXISTING INST_TYPE");
+	}
+}
+
+// NOTE: the files and directories of the line table have to be numbered from 1
+static uint64_t debug_file_index(String_View *files, size_t *files_size, String_View file_path) {
+	for (size_t i = 0; i < *files_size; ++i) {
+		if (sv_eq(files[i], file_path)) return i + 1;
+	}
+	files[*files_size] = file_path;
+	*files_size += 1;
+	return *files_size;
+}
+
+#define DW_FORM_addr 0x01
+#define DW_FORM_data2 0x05
+#define DW_FORM_data8 0x07
+#define DW_FORM_string 0x08
+#define DW_FORM_sec_offset 0x17
+#define DW_LANG_Mips_Assembler 0x8001
+
+// NOTE: one compile unit of DWARF 4 whose line table maps every instruction to its line in
+// the easm sources, enough for gdb and addr2line
+static void write_debug_info(const Elf_Gen *gen, uint64_t text_vaddr, String_View input_file_path,
+			     Bytes *abbrev, Bytes *info, Bytes *line) {
+	const EASM *easm = gen->easm;
+
+	bytes_uleb(abbrev, 1);
+	bytes_uleb(abbrev, 0x11);		// DW_TAG_compile_unit
+	bytes_u8(abbrev, 0);			// DW_CHILDREN_no
+	bytes_uleb(abbrev, 0x03); bytes_uleb(abbrev, DW_FORM_string);		// DW_AT_name
+	bytes_uleb(abbrev, 0x1b); bytes_uleb(abbrev, DW_FORM_string);		// DW_AT_comp_dir
+	bytes_uleb(abbrev, 0x25); bytes_uleb(abbrev, DW_FORM_string);		// DW_AT_producer
+	bytes_uleb(abbrev, 0x13); bytes_uleb(abbrev, DW_FORM_data2);		// DW_AT_language
+	bytes_uleb(abbrev, 0x10); bytes_uleb(abbrev, DW_FORM_sec_offset);	// DW_AT_stmt_list
+	bytes_uleb(abbrev, 0x11); bytes_uleb(abbrev, DW_FORM_addr);		// DW_AT_low_pc
+	bytes_uleb(abbrev, 0x12); bytes_uleb(abbrev, DW_FORM_data8);		// DW_AT_high_pc
+	bytes_uleb(abbrev, 0); bytes_uleb(abbrev, 0);
+	bytes_u8(abbrev, 0);
+
+	char comp_dir[4096] = "";
+	if (getcwd(comp_dir, sizeof(comp_dir)) == NULL) comp_dir[0] = '\0';
+
+	bytes_u32(info, 0);			// unit_length
+	bytes_u16(info, 4);
+	bytes_u32(info, 0);			// debug_abbrev_offset
+	bytes_u8(info, EVM_WORD_SIZE);
+	bytes_uleb(info, 1);
+	bytes_sv(info, input_file_path);
+	bytes_sv(info, sv_from_cstr(comp_dir));
+	bytes_sv(info, sv_from_cstr("easm2elf"));
+	bytes_u16(info, DW_LANG_Mips_Assembler);
+	bytes_u32(info, 0);
+	bytes_u64(info, text_vaddr);
+	bytes_u64(info, gen->code.size);
+	bytes_patch_u32(info, 0, (uint32_t) (info->size - 4));
+
+	String_View *files = malloc(sizeof(*files) * (easm->program_size + 1));
+	uint64_t *file_of = malloc(sizeof(*file_of) * (easm->program_size + 1));
+	if (files == NULL || file_of == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the debug info: %s\n", strerror(errno));
+		exit(1);
+	}
+	size_t files_size = 0;
+	for (size_t i = 0; i < easm->program_size; ++i) {
+		file_of[i] = debug_file_index(files, &files_size, easm->locations[i].file_path);
+	}
+
+	bytes_u32(line, 0);			// unit_length
+	bytes_u16(line, 4);
+	const size_t header_length_at = line->size;
+	bytes_u32(line, 0);
+	bytes_u8(line, 1);			// minimum_instruction_length
+	bytes_u8(line, 1);			// maximum_operations_per_instruction
+	bytes_u8(line, 1);			// default_is_stmt
+	bytes_u8(line, (uint8_t) -5);		// line_base
+	bytes_u8(line, 14);			// line_range
+	bytes_u8(line, 13);			// opcode_base
+	const uint8_t standard_opcode_lengths[] = { 0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1 };
+	bytes_push(line, standard_opcode_lengths, sizeof(standard_opcode_lengths));
+	bytes_u8(line, 0);			// no include_directories
+	for (size_t i = 0; i < files_size; ++i) {
+		bytes_sv(line, files[i]);
+		bytes_uleb(line, 0);
+		bytes_uleb(line, 0);
+		bytes_uleb(line, 0);
+	}
+	bytes_u8(line, 0);
+	bytes_patch_u32(line, header_length_at, (uint32_t) (line->size - header_length_at - 4));
+
+	// DW_LNE_set_address
+	bytes_u8(line, 0);
+	bytes_uleb(line, 1 + EVM_WORD_SIZE);
+	bytes_u8(line, 2);
+	bytes_u64(line, text_vaddr);
+
+	uint64_t file = 1;
+	int64_t line_number = 1;
+	size_t address = 0;
+	for (size_t i = 0; i < easm->program_size; ++i) {
+		if (file_of[i] != file) {
+			bytes_u8(line, 4);		// DW_LNS_set_file
+			bytes_uleb(line, file_of[i]);
+			file = file_of[i];
+		}
+		bytes_u8(line, 3);			// DW_LNS_advance_line
+		bytes_sleb(line, easm->locations[i].line_number - line_number);
+		line_number = easm->locations[i].line_number;
+		bytes_u8(line, 2);			// DW_LNS_advance_pc
+		bytes_uleb(line, gen->offsets[i] - address);
+		address = gen->offsets[i];
+		bytes_u8(line, 1);			// DW_LNS_copy
+	}
+	bytes_u8(line, 2);
+	bytes_uleb(line, gen->code.size - address);
+	// DW_LNE_end_sequence
+	bytes_u8(line, 0);
+	bytes_uleb(line, 1);
+	bytes_u8(line, 1);
+	bytes_patch_u32(line, 0, (uint32_t) (line->size - 4));
+
+	free(files);
+	free(file_of);
+}
+
+#define PT_LOAD 1
+#define PF_X 1
+#define PF_W 2
+#define PF_R 4
+
+#define SHT_PROGBITS 1
+#define SHT_STRTAB 3
+#define SHT_NOBITS 8
+#define SHF_WRITE 1
+#define SHF_ALLOC 2
+#define SHF_EXECINSTR 4
+
+#define ELF_HEADER_SIZE 64
+#define ELF_PHDR_SIZE 56
+#define ELF_SHDR_SIZE 64
+
+typedef struct {
+	const char *name;
+	uint32_t type;
+	uint64_t flags;
+	uint64_t addr;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t align;
+} Elf_Section;
+
+static void write_phdr(Bytes *elf, uint32_t flags, uint64_t offset, uint64_t vaddr, uint64_t filesz, uint64_t memsz) {
+	bytes_u32(elf, PT_LOAD);
+	bytes_u32(elf, flags);
+	bytes_u64(elf, offset);
+	bytes_u64(elf, vaddr);
+	bytes_u64(elf, vaddr);
+	bytes_u64(elf, filesz);
+	bytes_u64(elf, memsz);
+	bytes_u64(elf, ELF_PAGE_SIZE);
+}
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) / (a) * (a))
+
+int main(int argc, char **argv) {
+	shift(&argc, &argv);        // skip the program
+
+	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
+	static EASM easm = { 0 };
+
+	const char *input_file_path = NULL;
+	const char *output_file_path = NULL;
+	bool debug = false;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+
+		if (strcmp(flag, "-I") == 0) {
+			if (argc == 0) {
+				usage(stderr);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			easm_add_include_path(&easm, sv_from_cstr(shift(&argc, &argv)));
+		} else if (strcmp(flag, "-g") == 0) {
+			debug = true;
+		} else if (input_file_path == NULL) {
+			input_file_path = flag;
+		} else if (output_file_path == NULL) {
+			output_file_path = flag;
+		} else {
+			usage(stderr);
+			fprintf(stderr, "ERROR: unexpected argument `%s`\n", flag);
+			exit(1);
+		}
+	}
+
+	if (input_file_path == NULL) {
+		usage(stderr);
+		fprintf(stderr, "ERROR: no input provided\n");
+		exit(1);
+	}
+
+    	if (output_file_path == NULL) {
+        	usage(stderr);
+        	fprintf(stderr, "ERROR: no output provided.\n");
+        	exit(1);
+    	}
+
+	easm_translate_source(&easm, sv_from_cstr(input_file_path));
+
+	// NOTE: the initialised data has to fit into the memory like in a .evm, the whole
+	// EVM_MEMORY_CAPACITY is reserved below whatever the program declares
+	if (easm.memory_capacity > EVM_MEMORY_CAPACITY) {
+		fprintf(stderr, "ERROR: %s: memory section is too big. The program wants %lu bytes. But the capacity is %lu bytes\n", input_file_path, easm.memory_capacity, (uint64_t) EVM_MEMORY_CAPACITY);
+		exit(1);
+	}
+
+	for (size_t i = 0; i < easm.program_size; ++i) {
+		if (easm.program[i].type == INST_NATIVE && easm.program[i].operand.as_u64 > 1) {
+			fprintf(stderr, FL_Fmt": ERROR: only `native write` and `native clock` can be used without a linker, try easm2nasm\n", FL_Arg(easm.locations[i]));
+			exit(1);
+		}
+	}
+
+	// NOTE: .data holds the initialised part of the memory, .bss the stack, the frames and
+	// the memory itself on its own pages. All of it is below 2GB so the addresses fit into
+	// the sign extended 32 bit immediates.
+	static Elf_Gen gen = { 0 };
+	gen.easm = &easm;
+	gen.memory_init_vaddr = ELF_DATA_VADDR;
+	gen.stack_vaddr = ALIGN_UP(ELF_DATA_VADDR + easm.memory_size, ELF_PAGE_SIZE);
+	gen.frames_vaddr = gen.stack_vaddr + ELF_STACK_SIZE;
+	gen.memory_vaddr = gen.frames_vaddr + ELF_FRAMES_SIZE;
+	// NOTE: all of the memory like in the VM, the pages nobody touches are never mapped
+	const uint64_t bss_size = ELF_STACK_SIZE + ELF_FRAMES_SIZE + EVM_MEMORY_CAPACITY;
+
+	gen.offsets = malloc(sizeof(*gen.offsets) * (easm.program_size + 1));
+	if (gen.offsets == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the code: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	// _start
+	emit_mov_ri(&gen.code, R15, gen.stack_vaddr);
+	emit_mov_ri(&gen.code, R14, gen.stack_vaddr);
+	emit_mov_ri(&gen.code, R13, gen.frames_vaddr);
+	if (easm.memory_size > 0) {
+		emit_mov_ri(&gen.code, RSI, gen.memory_init_vaddr);
+		emit_mov_ri(&gen.code, RDI, gen.memory_vaddr);
+		emit_mov_ri(&gen.code, RCX, easm.memory_size);
+		bytes_u8(&gen.code, 0xF3);
+		bytes_u8(&gen.code, 0xA4);		// rep movsb
+	}
+	emit_jump(&gen, JMP, easm.entry);
+
+	// NOTE: everything that can be jumped or returned to starts a new basic block
+	int *reloc = malloc(sizeof(*reloc) * (easm.program_size + 1));
+	bool *is_target = calloc(easm.program_size + 1, sizeof(*is_target));
+	if (reloc == NULL || is_target == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the basic blocks: %s\n", strerror(errno));
+		exit(1);
+	}
+	easm_find_targets(&easm, reloc, is_target);
+
+	for (size_t i = 0; i < easm.program_size; ++i) {
+		if (is_target[i]) emit_flush(&gen);
+		gen.offsets[i] = gen.code.size;
+		emit_inst(&gen, easm.program[i]);
+	}
+
+	// NOTE: running past the last instruction
+	gen.offsets[easm.program_size] = gen.code.size;
+	emit_exit(&gen.code, ERR_ILLEGAL_INST_ACCESS);
+
+	for (size_t i = 0; i < gen.fixups_size; ++i) {
+		const Fixup fixup = gen.fixups[i];
+		const int64_t rel = (int64_t) gen.offsets[fixup.target] - (int64_t) (fixup.at + 4);
+		bytes_patch_u32(&gen.code, fixup.at, (uint32_t) rel);
+	}
+
+	const bool has_data = easm.memory_size > 0;
+	const uint16_t phnum = has_data ? 3 : 2;
+	const uint64_t text_offset = ALIGN_UP((uint64_t) (ELF_HEADER_SIZE + ELF_PHDR_SIZE * phnum), 16);
+	const uint64_t text_vaddr = ELF_TEXT_VADDR + text_offset;
+	const uint64_t data_offset = ALIGN_UP(text_offset + gen.code.size, ELF_PAGE_SIZE);
+
+	Bytes abbrev = { 0 };
+	Bytes info = { 0 };
+	Bytes line = { 0 };
+	if (debug) {
+		write_debug_info(&gen, text_vaddr, sv_from_cstr(input_file_path), &abbrev, &info, &line);
+	}
+
+	Elf_Section sections[8] = { 0 };
+	size_t sections_size = 1;
+	sections[sections_size++] = (Elf_Section) { ".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, text_vaddr, text_offset, gen.code.size, 16 };
+	if (has_data) {
+		sections[sections_size++] = (Elf_Section) { ".data", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, ELF_DATA_VADDR, data_offset, easm.memory_size, 1 };
+	}
+	sections[sections_size++] = (Elf_Section) { ".bss", SHT_NOBITS, SHF_ALLOC | SHF_WRITE, gen.stack_vaddr, data_offset + easm.memory_size, bss_size, ELF_PAGE_SIZE };
+	uint64_t offset = data_offset + easm.memory_size;
+	if (debug) {
+		sections[sections_size++] = (Elf_Section) { ".debug_abbrev", SHT_PROGBITS, 0, 0, offset, abbrev.size, 1 };
+		offset += abbrev.size;
+		sections[sections_size++] = (Elf_Section) { ".debug_info", SHT_PROGBITS, 0, 0, offset, info.size, 1 };
+		offset += info.size;
+		sections[sections_size++] = (Elf_Section) { ".debug_line", SHT_PROGBITS, 0, 0, offset, line.size, 1 };
+		offset += line.size;
+	}
+
+	Bytes shstrtab = { 0 };
+	bytes_u8(&shstrtab, 0);
+	uint32_t names[8] = { 0 };
+	for (size_t i = 1; i < sections_size; ++i) {
+		names[i] = (uint32_t) shstrtab.size;
+		bytes_sv(&shstrtab, sv_from_cstr(sections[i].name));
+	}
+	names[sections_size] = (uint32_t) shstrtab.size;
+	bytes_sv(&shstrtab, sv_from_cstr(".shstrtab"));
+	sections[sections_size++] = (Elf_Section) { ".shstrtab", SHT_STRTAB, 0, 0, offset, shstrtab.size, 1 };
+	offset += shstrtab.size;
+	const uint64_t shoff = ALIGN_UP(offset, 8);
+
+	Bytes elf = { 0 };
+	const uint8_t ident[16] = { 0x7F, 'E', 'L', 'F', 2, 1, 1, 0 };
+	bytes_push(&elf, ident, sizeof(ident));
+	bytes_u16(&elf, 2);			// ET_EXEC
+	bytes_u16(&elf, 62);			// EM_X86_64
+	bytes_u32(&elf, 1);
+	bytes_u64(&elf, text_vaddr);
+	bytes_u64(&elf, ELF_HEADER_SIZE);
+	bytes_u64(&elf, shoff);
+	bytes_u32(&elf, 0);
+	bytes_u16(&elf, ELF_HEADER_SIZE);
+	bytes_u16(&elf, ELF_PHDR_SIZE);
+	bytes_u16(&elf, phnum);
+	bytes_u16(&elf, ELF_SHDR_SIZE);
+	bytes_u16(&elf, (uint16_t) sections_size);
+	bytes_u16(&elf, (uint16_t) (sections_size - 1));
+
+	// NOTE: the text segment maps the headers as well, like ld does
+	write_phdr(&elf, PF_R | PF_X, 0, ELF_TEXT_VADDR, text_offset + gen.code.size, text_offset + gen.code.size);
+	if (has_data) {
+		write_phdr(&elf, PF_R | PF_W, data_offset, ELF_DATA_VADDR, easm.memory_size, easm.memory_size);
+	}
+	write_phdr(&elf, PF_R | PF_W, 0, gen.stack_vaddr, 0, bss_size);
+
+	bytes_align(&elf, 16);
+	bytes_push(&elf, gen.code.items, gen.code.size);
+	bytes_align(&elf, ELF_PAGE_SIZE);
+	bytes_push(&elf, easm.memory, easm.memory_size);
+	bytes_push(&elf, abbrev.items, abbrev.size);
+	bytes_push(&elf, info.items, info.size);
+	bytes_push(&elf, line.items, line.size);
+	bytes_push(&elf, shstrtab.items, shstrtab.size);
+	bytes_align(&elf, 8);
+
+	for (size_t i = 0; i < sections_size; ++i) {
+		bytes_u32(&elf, names[i]);
+		bytes_u32(&elf, sections[i].type);
+		bytes_u64(&elf, sections[i].flags);
+		bytes_u64(&elf, sections[i].addr);
+		bytes_u64(&elf, sections[i].offset);
+		bytes_u64(&elf, sections[i].size);
+		bytes_u32(&elf, 0);
+		bytes_u32(&elf, 0);
+		bytes_u64(&elf, sections[i].align);
+		bytes_u64(&elf, 0);
+	}
+
+	FILE *output = fopen(output_file_path, "wb");
+	if (output == NULL) {
+		fprintf(stderr, "ERROR: could not open file %s: %s\n", output_file_path, strerror(errno));
+		exit(1);
+	}
+	fwrite(elf.items, 1, elf.size, output);
+	if (ferror(output)) {
+		fprintf(stderr, "ERROR: could not write to file %s: %s\n", output_file_path, strerror(errno));
+		exit(1);
+	}
+	fclose(output);
+
+	if (chmod(output_file_path, 0755) < 0) {
+		fprintf(stderr, "ERROR: could not make %s executable: %s\n", output_file_path, strerror(errno));
+		exit(1);
+	}
+
+	free(elf.items);
+	free(shstrtab.items);
+	free(abbrev.items);
+	free(info.items);
+	free(line.items);
+	free(gen.code.items);
+	free(gen.fixups);
+	free(gen.offsets);
+	free(reloc);
+	free(is_target);
+	easm_clean(&easm);
+	return 0;
+}
@@ -1,11 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 
-#define EVM_IMPLEMENTATION
 #include "./evm.h"
 
 static void usage(FILE *f) {
-		fprintf(f, "Usage: easm2nasm <input.easm> <output.asm>\n");
+		fprintf(f, "Usage: easm2nasm [-I <dir>]... <input.easm> <output.asm>\n");
 }
 
 static char *shift(int *argc, char ***argv) {
@@ -16,28 +16,163 @@ static char *shift(int *argc, char ***argv) {
 	return result;
 }
 
+// NOTE: natives are called by index, the executable links them by the name the program
+// bound to the index with #native
+static String_View native_name(const EASM *easm, uint64_t index) {
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		if (easm->bindings[i].kind == BINDING_NATIVE && easm->bindings[i].value.as_u64 == index) {
+			return easm->bindings[i].name;
+		}
+	}
+	fprintf(stderr, "ERROR: native %lu has no name to link it by\n", index);
+	exit(1);
+}
+
+// NOTE: the VM stack pointer lives in r15, the frame in r14 and the saved frames pointer in r13,
+// all of them survive the calls to the natives. Inside of a basic block the top of the VM stack
+// may be kept in rax instead of [r15 - EVM_WORD_SIZE], `cached` tells which one it is. Every
+// block starts and ends with the whole stack in memory.
+static void emit_flush(FILE *output, bool *cached) {
+	if (*cached) {
+		fprintf(output, "\tmov [r15], rax\n");
+		fprintf(output, "\tadd r15, EVM_WORD_SIZE\n");
+		*cached = false;
+	}
+}
+
+static void emit_load_top(FILE *output, bool *cached) {
+	if (!*cached) {
+		fprintf(output, "\tsub r15, EVM_WORD_SIZE\n");
+		fprintf(output, "\tmov rax, [r15]\n");
+		*cached = true;
+	}
+}
+
+// NOTE: `a b` to rax and rbx, the result is left in rax as the new top
+static void emit_load_binary(FILE *output, bool *cached) {
+	emit_load_top(output, cached);
+	fprintf(output, "\tmov rbx, rax\n");
+	fprintf(output, "\tsub r15, EVM_WORD_SIZE\n");
+	fprintf(output, "\tmov rax, [r15]\n");
+}
+
+static void emit_binary(FILE *output, bool *cached, const char *name, const char *code) {
+	fprintf(output, "\t;; %s\n", name);
+	emit_load_binary(output, cached);
+	fprintf(output, "%s", code);
+}
+
+static void emit_compare(FILE *output, bool *cached, const char *name, const char *setcc) {
+	fprintf(output, "\t;; %s\n", name);
+	emit_load_binary(output, cached);
+	fprintf(output, "\tcmp rax, rbx\n");
+	fprintf(output, "\t%s al\n", setcc);
+	fprintf(output, "\tmovzx rax, al\n");
+}
+
+static void emit_binary_float(FILE *output, bool *cached, const char *name, const char *op) {
+	fprintf(output, "\t;; %s\n", name);
+	emit_load_binary(output, cached);
+	fprintf(output, "\tmovq xmm0, rax\n");
+	fprintf(output, "\tmovq xmm1, rbx\n");
+	fprintf(output, "\t%s xmm0, xmm1\n", op);
+	fprintf(output, "\tmovq rax, xmm0\n");
+}
+
+// NOTE: ucomisd reports NaN as unordered, so the conditions have to be the ones that are
+// false for it: `a < b` is tested as `b > a`
+static void emit_compare_float(FILE *output, bool *cached, const char *name, bool swapped, const char *code) {
+	fprintf(output, "\t;; %s\n", name);
+	emit_load_binary(output, cached);
+	fprintf(output, "\tmovq xmm0, rax\n");
+	fprintf(output, "\tmovq xmm1, rbx\n");
+	fprintf(output, "\tucomisd %s\n", swapped ? "xmm1, xmm0" : "xmm0, xmm1");
+	fprintf(output, "%s", code);
+	fprintf(output, "\tmovzx rax, al\n");
+}
+
+// NOTE: the targets are known at translation time, there is no instruction that computes one.
+// Outside of the program the VM fails with ERR_ILLEGAL_INST_ACCESS, so does the executable
+static void emit_jump(FILE *output, const EASM *easm, const char *jump, uint64_t target) {
+	if (target < easm->program_size) {
+		fprintf(output, "\t%s inst_%lu\n", jump, target);
+	} else {
+		fprintf(output, "\t%s illegal_inst_access\n", jump);
+	}
+}
+
+static void emit_load_unary(FILE *output, bool *cached, const char *name) {
+	fprintf(output, "\t;; %s\n", name);
+	emit_load_top(output, cached);
+}
+
+static void emit_read(FILE *output, bool *cached, const char *name, const char *load) {
+	emit_load_unary(output, cached, name);
+	fprintf(output, "\tadd rax, memory\n");
+	fprintf(output, "\t%s\n", load);
+}
+
+static void emit_write(FILE *output, bool *cached, const char *name, const char *store) {
+	fprintf(output, "\t;; %s\n", name);
+	emit_load_top(output, cached);
+	fprintf(output, "\tsub r15, EVM_WORD_SIZE\n");
+	fprintf(output, "\tmov rsi, [r15]\n");
+	fprintf(output, "\tadd rsi, memory\n");
+	fprintf(output, "\t%s\n", store);
+	*cached = false;
+}
+
 int main(int argc, char **argv) {
 	shift(&argc, &argv);        // skip the program
 
-	if (argc == 0) {
+	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
+	static EASM easm = { 0 };
+
+	const char *input_file_path = NULL;
+	const char *output_file_path = NULL;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+
+		if (strcmp(flag, "-I") == 0) {
+			if (argc == 0) {
+				usage(stderr);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			easm_add_include_path(&easm, sv_from_cstr(shift(&argc, &argv)));
+		} else if (input_file_path == NULL) {
+			input_file_path = flag;
+		} else if (output_file_path == NULL) {
+			output_file_path = flag;
+		} else {
+			usage(stderr);
+			fprintf(stderr, "ERROR: unexpected argument `%s`\n", flag);
+			exit(1);
+		}
+	}
+
+	if (input_file_path == NULL) {
 		usage(stderr);
 		fprintf(stderr, "ERROR: no input provided\n");
 		exit(1);
 	}
 
-	const char *input_file_path = shift(&argc, &argv);
-
-    	if (argc == 0) {
+    	if (output_file_path == NULL) {
         	usage(stderr);
         	fprintf(stderr, "ERROR: no output provided.\n");
         	exit(1);
     	}
-    	const char *output_file_path = shift(&argc, &argv);
 
-	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
-	static EASM easm = { 0 };
 	easm_translate_source(&easm, sv_from_cstr(input_file_path));
 
+	// NOTE: memory_capacity is only how far the initialised data reaches, it is refused here
+	// like evm_load_program_from_file refuses it. The program still gets all of the memory.
+	if (easm.memory_capacity > EVM_MEMORY_CAPACITY) {
+		fprintf(stderr, "ERROR: %s: memory section is too big. The program wants %lu bytes. But the capacity is %lu bytes\n", input_file_path, easm.memory_capacity, (uint64_t) EVM_MEMORY_CAPACITY);
+		exit(1);
+	}
+
     	FILE *output = fopen(output_file_path, "wb");
     	if (output == NULL) {
         	fprintf(stderr, "ERROR: could not open file %s: %s\n", output_file_path, strerror(errno));
@@ -46,22 +181,70 @@ int main(int argc, char **argv) {
 
 	fprintf(output, "BITS 64\n");
 	fprintf(output, "%%define EVM_STACK_CAPACITY %d\n", EVM_STACK_CAPACITY);
+	fprintf(output, "%%define EVM_RET_STACK_CAPACITY %d\n", EVM_RET_STACK_CAPACITY);
 	fprintf(output, "%%define EVM_WORD_SIZE %d\n", EVM_WORD_SIZE);
+	fprintf(output, "%%define EVM_MEMORY_CAPACITY %d\n", EVM_MEMORY_CAPACITY);
 	fprintf(output, "%%define STDOUT 1\n");
 	fprintf(output, "%%define SYS_EXIT 60\n");
 	fprintf(output, "%%define SYS_WRITE 1\n");
+
+	// NOTE: native 0 is `write` like in evm_load_standard_natives and is done with a syscall,
+	// every other one is linked in as `Err evm_native_<name>(EVM *evm)` like in the VM. The stack
+	// and the memory are the ones of a static EVM so the natives find them where they expect
+	fprintf(output, "%%define EVM_SIZE %zu\n", sizeof(EVM));
+	fprintf(output, "%%define stack (evm + %zu)\n", offsetof(EVM, stack));
+	fprintf(output, "%%define stack_size (evm + %zu)\n", offsetof(EVM, stack_size));
+	fprintf(output, "%%define memory (evm + %zu)\n", offsetof(EVM, memory));
+	static bool native_is_used[EVM_NATIVES_CAPACITY] = { 0 };
+	bool has_external_natives = false;
+	for (size_t i = 0; i < easm.program_size; ++i) {
+		const Inst inst = easm.program[i];
+		if (inst.type != INST_NATIVE) continue;
+		if (inst.operand.as_u64 >= EVM_NATIVES_CAPACITY) {
+			fprintf(stderr, "ERROR: native %lu is out of the %d natives the VM has\n", inst.operand.as_u64, EVM_NATIVES_CAPACITY);
+			exit(1);
+		}
+		if (inst.operand.as_u64 != 0 && !native_is_used[inst.operand.as_u64]) {
+			fprintf(output, "extern evm_native_"SV_Fmt"\n", SV_Arg(native_name(&easm, inst.operand.as_u64)));
+			has_external_natives = true;
+		}
+		native_is_used[inst.operand.as_u64] = true;
+	}
+
 	fprintf(output, "segment .text\n");
 	fprintf(output, "global _start\n");
+	fprintf(output, "_start:\n");
+	fprintf(output, "\tmov r15, stack\n");
+	fprintf(output, "\tmov r14, stack\n");
+	fprintf(output, "\tmov r13, frames\n");
+	// NOTE: the memory is all in .bss so the kernel maps its zeros lazily, only the part the
+	// program initialised is carried in .data and copied over
+	if (easm.memory_size > 0) {
+		fprintf(output, "\tmov rsi, memory_init\n");
+		fprintf(output, "\tmov rdi, memory\n");
+		fprintf(output, "\tmov rcx, %lu\n", easm.memory_size);
+		fprintf(output, "\trep movsb\n");
+	}
+	fprintf(output, "\tjmp inst_%zu\n", easm.entry);
 
-	size_t jmp_if_escape_count = 0;
+	// NOTE: everything that can be jumped or returned to starts a new basic block
+	int *reloc = malloc(sizeof(*reloc) * (easm.program_size + 1));
+	bool *is_target = calloc(easm.program_size + 1, sizeof(*is_target));
+	if (reloc == NULL || is_target == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the basic blocks: %s\n", strerror(errno));
+		exit(1);
+	}
+	easm_find_targets(&easm, reloc, is_target);
+
+	bool cached = false;
 	for (size_t i = 0; i < easm.program_size; ++i) {
 		Inst inst = easm.program[i];
 
-		if (i == easm.entry) {
-	    		fprintf(output, "_start:\n");
+		if (is_target[i]) {
+			emit_flush(output, &cached);
 		}
 
-		for (size_t j = 0; j < EASM_BINDINGS_CAPACITY; ++j) {
+		for (size_t j = 0; j < easm.bindings_size; ++j) {
             		if (easm.bindings[j].kind != BINDING_LABEL) continue;
 
             		if (easm.bindings[j].value.as_u64 == i) {
@@ -72,383 +255,292 @@ int main(int argc, char **argv) {
 
 		fprintf(output, "inst_%zu:\n", i);
 		switch (inst.type) {
-			case INST_NOP: UNIMPLEMENTED("INST_NOP");
+			case INST_NOP: {
+				fprintf(output, "\t;; nop\n");
+				fprintf(output, "\tnop\n");
+			} break;
 
 			case INST_PUSH: {
 				fprintf(output, "\t;; push %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tmov rsi, [stack_top]\n");
+				emit_flush(output, &cached);
 				fprintf(output, "\tmov rax, 0x%lx\n", inst.operand.as_u64);
-				fprintf(output, "\tmov QWORD [rsi], rax\n");
-				fprintf(output, "\tadd QWORD [stack_top], EVM_WORD_SIZE\n");
+				cached = true;
 			} break;
 
 			case INST_DROP: {
 				fprintf(output, "\t;; drop\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-	    			fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-	    			fprintf(output, "\tmov [stack_top], rsi\n");
+				if (cached) {
+					cached = false;
+				} else {
+					fprintf(output, "\tsub r15, EVM_WORD_SIZE\n");
+				}
 			} break;
 
 			case INST_DUP: {
 				fprintf(output, "\t;; dup %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tmov rdi, rsi\n");
-				fprintf(output, "\tsub rdi, EVM_WORD_SIZE * (%lu + 1)\n", inst.operand.as_u64);
-				fprintf(output, "\tmov rax, [rdi]\n");
-				fprintf(output, "\tmov [rsi], rax\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
+				if (!cached) {
+					fprintf(output, "\tmov rax, [r15 - EVM_WORD_SIZE * (%lu + 1)]\n", inst.operand.as_u64);
+				} else if (inst.operand.as_u64 == 0) {
+					fprintf(output, "\tmov [r15], rax\n");
+					fprintf(output, "\tadd r15, EVM_WORD_SIZE\n");
+				} else {
+					fprintf(output, "\tmov rbx, [r15 - EVM_WORD_SIZE * %lu]\n", inst.operand.as_u64);
+					fprintf(output, "\tmov [r15], rax\n");
+					fprintf(output, "\tadd r15, EVM_WORD_SIZE\n");
+					fprintf(output, "\tmov rax, rbx\n");
+				}
+				cached = true;
 			} break;
 
 			case INST_SWAP: {
 				fprintf(output, "\t;; swap %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rdi, rsi\n");
-				fprintf(output, "\tsub rdi, EVM_WORD_SIZE * %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tmov rbx, [rdi]\n");
-				fprintf(output, "\tmov [rdi], rax\n");
-				fprintf(output, "\tmov [rsi], rbx\n");
-			} break;
-
-			case INST_PLUSI: {
-				fprintf(output, "\t;; plusi \n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [rsi]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tadd rax, rbx\n");
-				fprintf(output, "\tmov [rsi], rax\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-			} break;
-
-			case INST_MINUSI: {
-				fprintf(output, "\t;; minusi \n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [rsi]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tsub rax, rbx\n");
-				fprintf(output, "\tmov [rsi], rax\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-			} break;
-
-			case INST_MULTI: {
-				fprintf(output, "\t;; multi\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], r11\n");
-				fprintf(output, "\tmov rax, [r11]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [r11]\n");
-				fprintf(output, "\timul rax, rbx\n");
-				fprintf(output, "\tmov [r11], rax\n");
-			} break;
-
-			case INST_MULTU: UNIMPLEMENTED("INST_MULTU");
-
-			case INST_DIVI: {
-	    			fprintf(output, "\t;; divi\n");
-	    			fprintf(output, "\tmov rsi, [stack_top]\n");
-	    			fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-	    			fprintf(output, "\tmov rbx, [rsi]\n");
-	    			fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-	    			fprintf(output, "\tmov rax, [rsi]\n");
-	    			fprintf(output, "\txor rdx, rdx\n");
-	    			fprintf(output, "\tidiv rbx\n");
-	    			fprintf(output, "\tmov [rsi], rax\n");
-	    			fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-	    			fprintf(output, "\tmov [stack_top], rsi\n");
-			} break;
-
-			case INST_DIVU: {
-				fprintf(output, "\t;; divu\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [rsi]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\txor rdx, rdx\n");
-				fprintf(output, "\tdiv rbx\n");
-				fprintf(output, "\tmov [rsi], rax\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-			} break;
-
+				emit_load_top(output, &cached);
+				fprintf(output, "\tmov rbx, [r15 - EVM_WORD_SIZE * %lu]\n", inst.operand.as_u64);
+				fprintf(output, "\tmov [r15 - EVM_WORD_SIZE * %lu], rax\n", inst.operand.as_u64);
+				fprintf(output, "\tmov rax, rbx\n");
+			} break;
+
+			case INST_PLUSI:	emit_binary(output, &cached, "plusi", "\tadd rax, rbx\n"); break;
+			case INST_MINUSI:	emit_binary(output, &cached, "minusi", "\tsub rax, rbx\n"); break;
+			// NOTE: the low 64 bits of a product are the same signed or not
+			case INST_MULTI:	emit_binary(output, &cached, "multi", "\timul rax, rbx\n"); break;
+			case INST_MULTU:	emit_binary(output, &cached, "multu", "\timul rax, rbx\n"); break;
+			// NOTE: idiv traps on INT64_MIN / -1, the VM wraps the quotient around and the
+			// remainder is 0
+			case INST_DIVI:
 			case INST_MODI: {
-				fprintf(output, "\t;; modi\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [rsi]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\txor rdx, rdx\n");
+				emit_binary(output, &cached, inst_name(inst.type), "\tcmp rbx, -1\n");
+				fprintf(output, "\tjne divide_%zu\n", i);
+				fprintf(output, "\t%s\n", inst.type == INST_DIVI ? "neg rax" : "xor rax, rax");
+				fprintf(output, "\tjmp divide_done_%zu\n", i);
+				fprintf(output, "divide_%zu:\n", i);
+				fprintf(output, "\tcqo\n");
 				fprintf(output, "\tidiv rbx\n");
-				fprintf(output, "\tmov [rsi], rdx\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
+				if (inst.type == INST_MODI) fprintf(output, "\tmov rax, rdx\n");
+				fprintf(output, "divide_done_%zu:\n", i);
 			} break;
+			case INST_DIVU:		emit_binary(output, &cached, "divu", "\txor rdx, rdx\n\tdiv rbx\n"); break;
+			case INST_MODU:		emit_binary(output, &cached, "modu", "\txor rdx, rdx\n\tdiv rbx\n\tmov rax, rdx\n"); break;
 
-			case INST_MODU: {
-				fprintf(output, "\t;; modu\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [rsi]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\txor rdx, rdx\n");
-				fprintf(output, "\tdiv rbx\n");
-				fprintf(output, "\tmov [rsi], rdx\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-			} break;
-
-			case INST_PLUSF: {
-				fprintf(output, "\t;; plusf\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], r11\n");
-				fprintf(output, "\tmovsd xmm0, [r11]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmovsd xmm1, [r11]\n");
-				fprintf(output, "\taddsd xmm1, xmm0\n");
-				fprintf(output, "\tmovsd [r11], xmm1\n");
-			} break;
-
-			case INST_MINUSF: {
-				fprintf(output, "\t;; minusf\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], r11\n");
-				fprintf(output, "\tmovsd xmm0, [r11]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmovsd xmm1, [r11]\n");
-				fprintf(output, "\tsubsd xmm1, xmm0\n");
-				fprintf(output, "\tmovsd [r11], xmm1\n");
-			} break;
-
-			case INST_MULTF: {
-				fprintf(output, "\t;; multf\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], r11\n");
-				fprintf(output, "\tmovsd xmm0, [r11]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmovsd xmm1, [r11]\n");
-				fprintf(output, "\tmulsd xmm1, xmm0\n");
-				fprintf(output, "\tmovsd [r11], xmm1\n");
-			} break;
-
-			case INST_DIVF: {
-				fprintf(output, "\t;; divf\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], r11\n");
-				fprintf(output, "\tmovsd xmm0, [r11]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmovsd xmm1, [r11]\n");
-				fprintf(output, "\tdivsd xmm1, xmm0\n");
-				fprintf(output, "\tmovsd [r11], xmm1\n");
-			} break;
+			case INST_PLUSF:	emit_binary_float(output, &cached, "plusf", "addsd"); break;
+			case INST_MINUSF:	emit_binary_float(output, &cached, "minusf", "subsd"); break;
+			case INST_MULTF:	emit_binary_float(output, &cached, "multf", "mulsd"); break;
+			case INST_DIVF:		emit_binary_float(output, &cached, "divf", "divsd"); break;
 
 			case INST_JMP: {
 				fprintf(output, "\t;; jmp\n");
-				fprintf(output, "\tmov rdi, inst_map\n");
-				fprintf(output, "\tadd rdi, EVM_WORD_SIZE * %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tjmp [rdi]\n");
+				emit_flush(output, &cached);
+				emit_jump(output, &easm, "jmp", inst.operand.as_u64);
 			} break;
 
-			case INST_JMP_IF: {
-				fprintf(output, "\t;; jmp_if %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-				fprintf(output, "\tcmp rax, 0\n");
-				fprintf(output, "\tje jmp_if_escape_%zu\n", jmp_if_escape_count);
-				fprintf(output, "\tmov rdi, inst_map\n");
-				fprintf(output, "\tadd rdi, EVM_WORD_SIZE * %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tjmp [rdi]\n");
-				fprintf(output, "jmp_if_escape_%zu:\n", jmp_if_escape_count);
-				jmp_if_escape_count += 1;
+			case INST_JMP_IF:
+			case INST_JMP_IF_NOT: {
+				fprintf(output, "\t;; %s %lu\n", inst_name(inst.type), inst.operand.as_u64);
+				emit_load_top(output, &cached);
+				cached = false;
+				fprintf(output, "\ttest rax, rax\n");
+				emit_jump(output, &easm, inst.type == INST_JMP_IF ? "jnz" : "jz", inst.operand.as_u64);
 			} break;
 
+			// NOTE: the return addresses can't be touched by the program, so they go to the hardware
+			// stack with call and ret which the CPU predicts. The return site is the very next
+			// instruction and starts a block, so nothing is cached there. r13 keeps only the frames
+			// NOTE: the frames are followed by the EVM, running out of them or returning with
+			// none traps like in the VM instead of going through it
 			case INST_RET: {
 				fprintf(output, "\t;; ret\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tmov rbx, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmul rbx\n");
-				fprintf(output, "\tadd rax, inst_map\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-				fprintf(output, "\tjmp [rax]\n");
+				emit_flush(output, &cached);
+				fprintf(output, "\tcmp r13, frames\n");
+				fprintf(output, "\tjbe stack_underflow\n");
+				fprintf(output, "\tsub r13, EVM_WORD_SIZE\n");
+				fprintf(output, "\tmov r14, [r13]\n");
+				fprintf(output, "\tret\n");
 			} break;
 
 			case INST_CALL: {
 				fprintf(output, "\t;; call\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tmov QWORD [rsi], %zu\n", i + 1);
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-				fprintf(output, "\tmov rdi, inst_map\n");
-				fprintf(output, "\tadd rdi, EVM_WORD_SIZE * %lu\n", inst.operand.as_u64);
-				fprintf(output, "\tjmp [rdi]\n");
+				emit_flush(output, &cached);
+				fprintf(output, "\tcmp r13, frames + EVM_RET_STACK_CAPACITY * EVM_WORD_SIZE\n");
+				fprintf(output, "\tjae stack_overflow\n");
+				fprintf(output, "\tmov [r13], r14\n");
+				fprintf(output, "\tadd r13, EVM_WORD_SIZE\n");
+				fprintf(output, "\tmov r14, r15\n");
+				emit_jump(output, &easm, "call", inst.operand.as_u64);
 			} break;
 
 			case INST_NATIVE: {
+				emit_flush(output, &cached);
 				if (inst.operand.as_u64 == 0) {
 					fprintf(output, "\t;; native write\n");
-					fprintf(output, "\tmov r11, [stack_top]\n");
-					fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-					fprintf(output, "\tmov rdx, [r11]\n");
-					fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-					fprintf(output, "\tmov rsi, [r11]\n");
+					fprintf(output, "\tsub r15, EVM_WORD_SIZE * 2\n");
+					fprintf(output, "\tmov rsi, [r15]\n");
 					fprintf(output, "\tadd rsi, memory\n");
+					fprintf(output, "\tmov rdx, [r15 + EVM_WORD_SIZE]\n");
 					fprintf(output, "\tmov rdi, STDOUT\n");
 					fprintf(output, "\tmov rax, SYS_WRITE\n");
-					fprintf(output, "\tmov [stack_top], r11\n");
 					fprintf(output, "\tsyscall\n");
-				} else UNIMPLEMENTED("Unsupported native function");
+				} else {
+					const String_View name = native_name(&easm, inst.operand.as_u64);
+					fprintf(output, "\t;; native "SV_Fmt"\n", SV_Arg(name));
+					fprintf(output, "\tmov rax, evm_native_"SV_Fmt"\n", SV_Arg(name));
+					fprintf(output, "\tcall native_bridge\n");
+				}
 			} break;
 
 			case INST_NOT: {
-				fprintf(output, "\t;; not\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tcmp rax, 0\n");
-				fprintf(output, "\tmov rax, 0\n");
+				emit_load_unary(output, &cached, "not");
+				fprintf(output, "\ttest rax, rax\n");
 				fprintf(output, "\tsetz al\n");
-				fprintf(output, "\tmov [rsi], rax\n");
+				fprintf(output, "\tmovzx rax, al\n");
 	    		} break;
 
-			case INST_EQI: {
-				fprintf(output, "\t;; eqi\n");
-				fprintf(output, "\tmov rsi, [stack_top]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rbx, [rsi]\n");
-				fprintf(output, "\tsub rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [rsi]\n");
-				fprintf(output, "\tcmp rax, rbx\n");
-				fprintf(output, "\tmov rax, 0\n");
-				fprintf(output, "\tsetz al\n");
-				fprintf(output, "\tmov [rsi], rax\n");
-				fprintf(output, "\tadd rsi, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov [stack_top], rsi\n");
-			} break;
-
-			case INST_GEI: {
-	    			fprintf(output, "\t;; FIXME: gei\n");
-			} break;
-
-			case INST_GTI: {
-	    			fprintf(output, "\t;; FIXME: gti\n");
-			} break;
-
-			case INST_LEI: {
-	    			fprintf(output, "\t;; FIXME: lei\n");
-			} break;
-
-			case INST_LTI: UNIMPLEMENTED("INST_LTI");
-			case INST_NEI: UNIMPLEMENTED("INST_NEI");
+			case INST_EQI:		emit_compare(output, &cached, "eqi", "sete"); break;
+			case INST_GEI:		emit_compare(output, &cached, "gei", "setge"); break;
+			case INST_GTI:		emit_compare(output, &cached, "gti", "setg"); break;
+			case INST_LEI:		emit_compare(output, &cached, "lei", "setle"); break;
+			case INST_LTI:		emit_compare(output, &cached, "lti", "setl"); break;
+			case INST_NEI:		emit_compare(output, &cached, "nei", "setne"); break;
+
+			case INST_EQU:		emit_compare(output, &cached, "equ", "sete"); break;
+			case INST_GEU:		emit_compare(output, &cached, "geu", "setae"); break;
+			case INST_GTU:		emit_compare(output, &cached, "gtu", "seta"); break;
+			case INST_LEU:		emit_compare(output, &cached, "leu", "setbe"); break;
+			case INST_LTU:		emit_compare(output, &cached, "ltu", "setb"); break;
+			case INST_NEU:		emit_compare(output, &cached, "neu", "setne"); break;
+
+			case INST_EQF:		emit_compare_float(output, &cached, "eqf", false, "\tsete al\n\tsetnp bl\n\tand al, bl\n"); break;
+			case INST_GEF:		emit_compare_float(output, &cached, "gef", false, "\tsetae al\n"); break;
+			case INST_GTF:		emit_compare_float(output, &cached, "gtf", false, "\tseta al\n"); break;
+			case INST_LEF:		emit_compare_float(output, &cached, "lef", true, "\tsetae al\n"); break;
+			case INST_LTF:		emit_compare_float(output, &cached, "ltf", true, "\tseta al\n"); break;
+			case INST_NEF:		emit_compare_float(output, &cached, "nef", false, "\tsetne al\n\tsetp bl\n\tor al, bl\n"); break;
+
+			case INST_ANDB:		emit_binary(output, &cached, "andb", "\tand rax, rbx\n"); break;
+			case INST_ORB:		emit_binary(output, &cached, "orb", "\tor rax, rbx\n"); break;
+			case INST_XOR:		emit_binary(output, &cached, "xor", "\txor rax, rbx\n"); break;
+			case INST_SHR:		emit_binary(output, &cached, "shr", "\tmov rcx, rbx\n\tshr rax, cl\n"); break;
+			case INST_SHL:		emit_binary(output, &cached, "shl", "\tmov rcx, rbx\n\tshl rax, cl\n"); break;
+
+			case INST_NOTB: {
+				emit_load_unary(output, &cached, "notb");
+				fprintf(output, "\tnot rax\n");
+			} break;
+
+			case INST_READ8:	emit_read(output, &cached, "read8", "movzx eax, BYTE [rax]"); break;
+			case INST_READ16:	emit_read(output, &cached, "read16", "movzx eax, WORD [rax]"); break;
+			case INST_READ32:	emit_read(output, &cached, "read32", "mov eax, DWORD [rax]"); break;
+			case INST_READ64:	emit_read(output, &cached, "read64", "mov rax, QWORD [rax]"); break;
+
+			case INST_WRITE8:	emit_write(output, &cached, "write8", "mov BYTE [rsi], al"); break;
+			case INST_WRITE16:	emit_write(output, &cached, "write16", "mov WORD [rsi], ax"); break;
+			case INST_WRITE32:	emit_write(output, &cached, "write32", "mov DWORD [rsi], eax"); break;
+			case INST_WRITE64:	emit_write(output, &cached, "write64", "mov QWORD [rsi], rax"); break;
 
-			case INST_EQU: {
-	    			fprintf(output, "\t;; FIXME: equ\n");
+			case INST_I2F: {
+				emit_load_unary(output, &cached, "i2f");
+				fprintf(output, "\tcvtsi2sd xmm0, rax\n");
+				fprintf(output, "\tmovq rax, xmm0\n");
+			} break;
+
+			case INST_U2F: {
+				// NOTE: there is only a signed conversion, the numbers with the top bit set are
+				// halved keeping the lowest bit for the rounding and doubled back
+				emit_load_unary(output, &cached, "u2f");
+				fprintf(output, "\ttest rax, rax\n");
+				fprintf(output, "\tjs u2f_big_%zu\n", i);
+				fprintf(output, "\tcvtsi2sd xmm0, rax\n");
+				fprintf(output, "\tjmp u2f_done_%zu\n", i);
+				fprintf(output, "u2f_big_%zu:\n", i);
+				fprintf(output, "\tmov rbx, rax\n");
+				fprintf(output, "\tshr rbx, 1\n");
+				fprintf(output, "\tand rax, 1\n");
+				fprintf(output, "\tor rbx, rax\n");
+				fprintf(output, "\tcvtsi2sd xmm0, rbx\n");
+				fprintf(output, "\taddsd xmm0, xmm0\n");
+				fprintf(output, "u2f_done_%zu:\n", i);
+				fprintf(output, "\tmovq rax, xmm0\n");
+			} break;
+
+			// NOTE: the VM turns floats to unsigned through int64_t as well
+			case INST_F2I:
+			case INST_F2U: {
+				emit_load_unary(output, &cached, inst_name(inst.type));
+				fprintf(output, "\tmovq xmm0, rax\n");
+				fprintf(output, "\tcvttsd2si rax, xmm0\n");
 			} break;
 
-			case INST_GEU: UNIMPLEMENTED("INST_GEU");
-			case INST_GTU: UNIMPLEMENTED("INST_GTU");
-			case INST_LEU: UNIMPLEMENTED("INST_LEU");
-			case INST_LTU: UNIMPLEMENTED("INST_LTU");
-			case INST_NEU: UNIMPLEMENTED("INST_NEU");
-			case INST_EQF: UNIMPLEMENTED("INST_EQF");
-
-			case INST_GEF: {
-			    	fprintf(output, "\t;; FIXME: gef\n");
+			case INST_HALT: {
+				fprintf(output, "\t;; halt\n");
+				fprintf(output, "\tmov rax, SYS_EXIT\n");
+				fprintf(output, "\tmov rdi, 0\n");
+				fprintf(output, "\tsyscall\n");
+				cached = false;
 			} break;
 
-			case INST_GTF: {
-			    	fprintf(output, "\t;; FIXME: gtf\n");
+			// NOTE: SIGTRAP, a debugger stops there with the VM stack all in memory
+			case INST_BREAKPOINT: {
+				emit_flush(output, &cached);
+				fprintf(output, "\tint3\n");
 			} break;
 
-			case INST_LEF: {
-			    	fprintf(output, "\t;; FIXME: lef\n");
+			case INST_PLUSI_IMM:
+			case INST_MINUSI_IMM: {
+				emit_load_unary(output, &cached, inst_name(inst.type));
+				fprintf(output, "\tmov rbx, 0x%lx\n", inst.operand.as_u64);
+				fprintf(output, "\t%s rax, rbx\n", inst.type == INST_PLUSI_IMM ? "add" : "sub");
 			} break;
 
-			case INST_LTF: {
-			    	fprintf(output, "\t;; FIXME: ltf\n");
+			case INST_EQI_IMM: {
+				emit_load_unary(output, &cached, "eqi_imm");
+				fprintf(output, "\tmov rbx, 0x%lx\n", inst.operand.as_u64);
+				fprintf(output, "\tcmp rax, rbx\n");
+				fprintf(output, "\tsete al\n");
+				fprintf(output, "\tmovzx rax, al\n");
 			} break;
 
-			case INST_NEF: UNIMPLEMENTED("INST_NEF");
-
-			case INST_ANDB: {
-	    			fprintf(output, "\t;; FIXME: andb\n");
+			case INST_JMP_IF_ZERO: {
+				fprintf(output, "\t;; jmp_if_zero %lu\n", inst.operand.as_u64);
+				emit_flush(output, &cached);
+				fprintf(output, "\tcmp QWORD [r15 - EVM_WORD_SIZE], 0\n");
+				emit_jump(output, &easm, "je", inst.operand.as_u64);
 			} break;
 
-			case INST_ORB: UNIMPLEMENTED("INST_ORB");
-
-			case INST_XOR: {
-	    			fprintf(output, "\t;; FIXME: xor\n");
+			case INST_JMP_LTI: {
+				fprintf(output, "\t;; jmp_lti %lu\n", inst.operand.as_u64);
+				emit_load_top(output, &cached);
+				cached = false;
+				fprintf(output, "\tsub r15, EVM_WORD_SIZE\n");
+				fprintf(output, "\tcmp [r15], rax\n");
+				emit_jump(output, &easm, "jl", inst.operand.as_u64);
 			} break;
 
-			case INST_SHR: UNIMPLEMENTED("INST_SHR");
-			case INST_SHL: UNIMPLEMENTED("INST_SHL");
-			case INST_NOTB: UNIMPLEMENTED("INST_NOTB");
-
-			case INST_READ8: {
-				fprintf(output, "\t;; read8\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rsi, [r11]\n");
-				fprintf(output, "\tadd rsi, memory\n");
-				fprintf(output, "\txor rax, rax\n");
-				fprintf(output, "\tmov al, BYTE [rsi]\n");
-				fprintf(output, "\tmov [r11], rax\n");
+			// NOTE: the slot might be the cached top itself, so it goes to memory first
+			case INST_LOCAL_GET: {
+				fprintf(output, "\t;; local_get %lu\n", inst.operand.as_u64);
+				emit_flush(output, &cached);
+				fprintf(output, "\tmov rax, [r14 + EVM_WORD_SIZE * %lu]\n", inst.operand.as_u64);
+				cached = true;
 			} break;
 
-			case INST_READ16: UNIMPLEMENTED("INST_READ16");
-			case INST_READ32: UNIMPLEMENTED("INST_READ32");
-			case INST_READ64: UNIMPLEMENTED("INST_READ64");
-
-			case INST_WRITE8: {
-				fprintf(output, "\t;; write8\n");
-				fprintf(output, "\tmov r11, [stack_top]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rax, [r11]\n");
-				fprintf(output, "\tsub r11, EVM_WORD_SIZE\n");
-				fprintf(output, "\tmov rsi, [r11]\n");
-				fprintf(output, "\tadd rsi, memory\n");
-				fprintf(output, "\tmov BYTE [rsi], al\n");
-				fprintf(output, "\tmov [stack_top], r11\n");
+			case INST_ARG_GET: {
+				fprintf(output, "\t;; arg_get %lu\n", inst.operand.as_u64);
+				emit_flush(output, &cached);
+				fprintf(output, "\tmov rax, [r14 - EVM_WORD_SIZE * (%lu + 1)]\n", inst.operand.as_u64);
+				cached = true;
 			} break;
 
-			case INST_WRITE16: UNIMPLEMENTED("INST_WRITE16");
-			case INST_WRITE32: UNIMPLEMENTED("INST_WRITE32");
-			case INST_WRITE64: UNIMPLEMENTED("INST_WRITE64");
-
-			case INST_I2F: {
-	    			fprintf(output, "\t;; FIXME: i2f\n");
+			case INST_LOCAL_SET: {
+				fprintf(output, "\t;; local_set %lu\n", inst.operand.as_u64);
+				emit_load_top(output, &cached);
+				fprintf(output, "\tmov [r14 + EVM_WORD_SIZE * %lu], rax\n", inst.operand.as_u64);
+				cached = false;
 			} break;
 
-			case INST_U2F: UNIMPLEMENTED("INST_U2F");
-
-			case INST_F2I: {
-			    	fprintf(output, "\t;; FIXME: f2i\n");
-			} break;
-
-			case INST_F2U: UNIMPLEMENTED("INST_F2U");
-
-			case INST_HALT: {
-				fprintf(output, "\t;; halt\n");
-				fprintf(output, "\tmov rax, SYS_EXIT\n");
-				fprintf(output, "\tmov rdi, 0\n");
-				fprintf(output, "\tsyscall\n");
+			case INST_ARG_SET: {
+				fprintf(output, "\t;; arg_set %lu\n", inst.operand.as_u64);
+				emit_load_top(output, &cached);
+				fprintf(output, "\tmov [r14 - EVM_WORD_SIZE * (%lu + 1)], rax\n", inst.operand.as_u64);
+				cached = false;
 			} break;
 
 			case EASM_NUMBER_OF_INSTS:
@@ -456,22 +548,52 @@ int main(int argc, char **argv) {
 		}
 	}
 
-	fprintf(output, "\tret\n");
+	// NOTE: running past the last instruction
+	fprintf(output, "illegal_inst_access:\n");
+	fprintf(output, "\tmov rax, SYS_EXIT\n");
+	fprintf(output, "\tmov rdi, %d\n", ERR_ILLEGAL_INST_ACCESS);
+	fprintf(output, "\tsyscall\n");
+	fprintf(output, "stack_overflow:\n");
+	fprintf(output, "\tmov rax, SYS_EXIT\n");
+	fprintf(output, "\tmov rdi, %d\n", ERR_STACK_OVERFLOW);
+	fprintf(output, "\tsyscall\n");
+	fprintf(output, "stack_underflow:\n");
+	fprintf(output, "\tmov rax, SYS_EXIT\n");
+	fprintf(output, "\tmov rdi, %d\n", ERR_STACK_UNDERFLOW);
+	fprintf(output, "\tsyscall\n");
+
+	if (has_external_natives) {
+		// NOTE: calls the native in rax with the EVM. r15 becomes evm.stack_size and back, so the
+		// native pushes and pops like in the VM. System V calls want the stack aligned to 16 bytes,
+		// rbx survives the call. The Err is an int, the upper half of rax is garbage
+		fprintf(output, "native_bridge:\n");
+		fprintf(output, "\tmov rbx, r15\n");
+		fprintf(output, "\tsub rbx, stack\n");
+		fprintf(output, "\tshr rbx, 3\n");
+		fprintf(output, "\tmov [stack_size], rbx\n");
+		fprintf(output, "\tmov rbx, rsp\n");
+		fprintf(output, "\tand rsp, -16\n");
+		fprintf(output, "\tmov rdi, evm\n");
+		fprintf(output, "\tcall rax\n");
+		fprintf(output, "\tmov rsp, rbx\n");
+		fprintf(output, "\tmov r15, [stack_size]\n");
+		fprintf(output, "\tshl r15, 3\n");
+		fprintf(output, "\tadd r15, stack\n");
+		fprintf(output, "\ttest eax, eax\n");
+		fprintf(output, "\tjnz native_failed\n");
+		fprintf(output, "\tret\n");
+		// NOTE: the Err of the native that failed is the exit code
+		fprintf(output, "native_failed:\n");
+		fprintf(output, "\tmov edi, eax\n");
+		fprintf(output, "\tmov rax, SYS_EXIT\n");
+		fprintf(output, "\tsyscall\n");
+	}
+
 	fprintf(output, "segment .data\n");
-	fprintf(output, "stack_top: dq stack\n");
-	fprintf(output, "inst_map:\n");
 #define ROW_SIZE 5
 #define ROW_COUNT(size) ((size + ROW_SIZE - 1) / ROW_SIZE)
 #define INDEX(row, col) ((row) * ROW_SIZE + (col))
-    	for (size_t row = 0; row < ROW_COUNT(easm.program_size); ++row) {
-        	fprintf(output, "  dq");
-        	for (size_t col = 0; col < ROW_SIZE && INDEX(row, col) < easm.program_size; ++col) {
-            		fprintf(output, " inst_%zu,", INDEX(row, col));
-        	}
-        	fprintf(output, "\n");
-    	}
-	fprintf(output, "\n");
-    	fprintf(output, "memory:\n");
+    	fprintf(output, "memory_init:\n");
     	for (size_t row = 0; row < ROW_COUNT(easm.memory_size); ++row) {
 		fprintf(output, "\tdb");
         	for (size_t col = 0; col < ROW_SIZE && INDEX(row, col) < easm.memory_size; ++col) {
@@ -479,16 +601,19 @@ int main(int argc, char **argv) {
 		}
 		fprintf(output, "\n");
     	}
-    	// TODO: warning: uninitialized space declared in non-BSS section `.data': zeroing
-    	//   Is it possible to get rid of it? Not really suppress it, but just let nasm know
-    	//   that I know what I'm doing.
-    	fprintf(output, "\ttimes %zu db 0", EVM_MEMORY_CAPACITY - easm.memory_size);
 #undef ROW_SIZE
 #undef ROW_COUNT
-    	fprintf(output, "\n");
 	fprintf(output, "segment .bss\n");
-	fprintf(output, "stack: resq EVM_STACK_CAPACITY\n");
+	fprintf(output, "frames: resq EVM_RET_STACK_CAPACITY\n");
+	// NOTE: the VM lets the programs address all of its memory, past memory_capacity too, and
+	// .bss costs nothing in the executable anyway
+	fprintf(output, "alignb 8\n");
+	fprintf(output, "evm: resb EVM_SIZE\n");
+	// NOTE: gcc links it along with evm.o and wants to know that nothing runs from the stack
+	fprintf(output, "section .note.GNU-stack noalloc noexec nowrite progbits\n");
 
 	fclose(output);
+	free(reloc);
+	free(is_target);
 	return 0;
 }
@@ -0,0 +1,78 @@
+#include <time.h>
+
+#include "./evm.h"
+
+#define EASMB_DEFAULT_ITERATIONS 100
+
+static char *shift(int *argc, char ***argv) {
+	assert(*argc > 0);
+	char *result = **argv;
+	*argv += 1;
+	*argc -= 1;
+	return result;
+}
+
+static void usage(FILE *stream, const char *program) {
+	fprintf(stream, "Usage: %s <input.easm> [-n <iterations>]\n", program);
+}
+
+static double now_secs(void) {
+	struct timespec ts = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+	const char *program = shift(&argc, &argv);
+	const char *input_file_path = NULL;
+	long iterations = EASMB_DEFAULT_ITERATIONS;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+		if (strcmp(flag, "-n") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			iterations = strtol(shift(&argc, &argv), NULL, 10);
+			if (iterations <= 0) {
+				fprintf(stderr, "ERROR: amount of iterations must be positive\n");
+				exit(1);
+			}
+		} else if (input_file_path == NULL) {
+			input_file_path = flag;
+		} else {
+			usage(stderr, program);
+			fprintf(stderr, "ERROR: unexpected argument `%s`\n", flag);
+			exit(1);
+		}
+	}
+
+	if (input_file_path == NULL) {
+		usage(stderr, program);
+		fprintf(stderr, "ERROR: expected input\n");
+		exit(1);
+	}
+
+	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
+	static EASM easm = { 0 };
+
+	size_t total_bytes = 0;
+	double total_secs = 0.0;
+	for (long i = 0; i < iterations; ++i) {
+		easm_clean(&easm);
+
+		const double start = now_secs();
+		easm_translate_source(&easm, sv_from_cstr(input_file_path));
+		total_secs += now_secs() - start;
+
+		total_bytes += easm.source_size;
+	}
+
+	printf("%s: %zu bytes of source, %ld iterations, %.6f s, %.2f MB/s\n",
+		input_file_path, total_bytes / (size_t) iterations, iterations,
+		total_secs, (double) total_bytes / total_secs / 1e6);
+
+	return 0;
+}
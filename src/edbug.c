@@ -4,7 +4,6 @@
 
 #include "./edbug.h"
 
-#define EVM_IMPLEMENTATION
 #include "./evm.h"
 
 #define INPUT_CAPACITY 32
@@ -49,7 +48,7 @@ Edb_Err edb_run_command(Edb_State *state, String_View command_word, String_View
 			if (err) return EXIT_FAILURE;
 
 			printf("-> ");
-			edb_print_instr(stdout, &state->evm.program[state->evm.ip]);
+			edb_print_instr(stdout, edb_inst_at(state, state->evm.ip));
 			printf("\n");
 		} break;
 
@@ -155,13 +154,42 @@ Edb_Err edb_step_instr(Edb_State *state) {
         	return EDB_OK;
     	}
 
-    	Err err = evm_execute_inst(&state->evm);
+    	if (state->evm.ip < EVM_PROGRAM_CAPACITY) state->breakpoints[state->evm.ip].is_broken = 0;
+
+    	Err err = edb_execute_original(state);
     	if (!err)
         	return EDB_OK;
     	else
         	return edb_fault(state, err);
 }
 
+// NOTE: the instruction the program has at addr, not the breakpoint patched over it
+Inst *edb_inst_at(Edb_State *state, Inst_Addr addr) {
+	if (addr < EVM_PROGRAM_CAPACITY && state->breakpoints[addr].is_enabled) {
+		return &state->breakpoints[addr].saved;
+	}
+	return &state->evm.program[addr];
+}
+
+// NOTE: executes the instruction at ip as the program has it. Under a breakpoint it is put
+// back for the one instruction, a `breakpoint` of the program itself is stepped over.
+Err edb_execute_original(Edb_State *state) {
+	const Inst_Addr ip = state->evm.ip;
+	if (ip >= state->evm.program_size) return evm_execute_inst(&state->evm);
+
+	if (edb_inst_at(state, ip)->type == INST_BREAKPOINT) {
+		state->evm.ip += 1;
+		return ERR_OK;
+	}
+
+	if (!state->breakpoints[ip].is_enabled) return evm_execute_inst(&state->evm);
+
+	state->evm.program[ip] = state->breakpoints[ip].saved;
+	const Err err = evm_execute_inst(&state->evm);
+	state->evm.program[ip] = (Inst) { .type = INST_BREAKPOINT };
+	return err;
+}
+
 Edb_Err edb_continue(Edb_State *state) {
     	assert(state);
 
@@ -170,24 +198,33 @@ Edb_Err edb_continue(Edb_State *state) {
         	return EDB_OK;
     	}
 
-    	do {
-        	Edb_Breakpoint *bp = &state->breakpoints[state->evm.ip];
-        	if (!bp->is_broken && bp->is_enabled) {
-            		fprintf(stdout, "Hit breakpoint at %lu", state->evm.ip);
-            		if (state->labels[state->evm.ip].data)
-                		fprintf(stdout, " label '"SV_Fmt"'", SV_Arg(state->labels[state->evm.ip]));
-
-            		fprintf(stdout, "\n");
-            		bp->is_broken = 1;
+    	// NOTE: the breakpoint the program is stopped on lets its instruction through first
+    	if (state->evm.ip < EVM_PROGRAM_CAPACITY && state->breakpoints[state->evm.ip].is_broken) {
+    		state->breakpoints[state->evm.ip].is_broken = 0;
+    		Err err = edb_execute_original(state);
+    		if (err) return edb_fault(state, err);
+    	}
 
-            		return EDB_OK;
+    	// NOTE: the breakpoints are INST_BREAKPOINT in the program, so it runs at full speed
+    	// until one of them traps
+    	Err err = evm_execute_program(&state->evm, -1);
+    	if (err == ERR_BREAKPOINT) {
+        	const Inst_Addr ip = state->evm.ip;
+        	if (state->breakpoints[ip].is_enabled) {
+            		fprintf(stdout, "Hit breakpoint at %lu", ip);
+        	} else {
+            		fprintf(stdout, "Hit breakpoint instruction at %lu", ip);
         	}
+        	if (state->labels[ip].data)
+            		fprintf(stdout, " label '"SV_Fmt"'", SV_Arg(state->labels[ip]));
+
+        	fprintf(stdout, "\n");
+        	state->breakpoints[ip].is_broken = 1;
 
-        	bp->is_broken = 0;
+        	return EDB_OK;
+    	}
 
-        	Err err = evm_execute_inst(&state->evm);
-        	if (err) return edb_fault(state, err);
-    	} while (!state->evm.halt);
+    	if (err) return edb_fault(state, err);
 
     	printf("Program halted.\n");
 
@@ -232,12 +269,12 @@ void edb_print_instr(FILE *f, Inst *i) {
 void edb_add_breakpoint(Edb_State *state, Inst_Addr addr) {
     	assert(state);
 
-    	if (addr > state->evm.program_size) {
+    	if (addr >= state->evm.program_size) {
         	fprintf(stderr, "ERR : Symbol out of program\n");
         	return;
     	}
 
-    	if (addr > EVM_PROGRAM_CAPACITY) {
+    	if (addr >= EVM_PROGRAM_CAPACITY) {
         	fprintf(stderr, "ERR : Symbol out of memory\n");
         	return;
     	}
@@ -247,18 +284,20 @@ void edb_add_breakpoint(Edb_State *state, Inst_Addr addr) {
         	return;
     	}
 
+    	state->breakpoints[addr].saved = state->evm.program[addr];
+    	state->evm.program[addr] = (Inst) { .type = INST_BREAKPOINT };
     	state->breakpoints[addr].is_enabled = 1;
 }
 
 void edb_delete_breakpoint(Edb_State *state, Inst_Addr addr) {
     	assert(state);
 
-    	if (addr > state->evm.program_size) {
+    	if (addr >= state->evm.program_size) {
         	fprintf(stderr, "ERR : Symbol out of program\n");
         	return;
     	}
 
-    	if (addr > EVM_PROGRAM_CAPACITY) {
+    	if (addr >= EVM_PROGRAM_CAPACITY) {
         	fprintf(stderr, "ERR : Symbol out of memory\n");
         	return;
     	}
@@ -268,6 +307,7 @@ void edb_delete_breakpoint(Edb_State *state, Inst_Addr addr) {
         	return;
     	}
 
+    	state->evm.program[addr] = state->breakpoints[addr].saved;
     	state->breakpoints[addr].is_enabled = 0;
 }
 
@@ -275,7 +315,7 @@ Edb_Err edb_fault(Edb_State *state, Err err) {
 	assert(state);
 
     	fprintf(stderr, "%s at %lu (INSTR: ", err_as_cstr(err), state->evm.ip);
-    	edb_print_instr(stderr, &state->evm.program[state->evm.ip]);
+    	edb_print_instr(stderr, edb_inst_at(state, state->evm.ip));
     	fprintf(stderr, ")\n");
     	state->evm.halt = 1;
     	return EDB_OK;
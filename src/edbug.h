@@ -9,10 +9,13 @@ typedef enum {
 	EDB_EXIT,
 } Edb_Err;
 
+// NOTE: an enabled breakpoint has INST_BREAKPOINT patched over its instruction, which is
+// kept in `saved`. is_broken is set while the program is stopped on it.
 typedef struct {
 	int is_enabled;
 	int id;
 	int is_broken;
+	Inst saved;
 } Edb_Breakpoint;
 
 typedef struct {
@@ -26,6 +29,8 @@ typedef struct {
 Edb_Err edb_state_init(Edb_State *state, const char *executable);
 Edb_Err edb_load_symtab(Edb_State *state, String_View symtab_file);
 Edb_Err edb_step_instr(Edb_State *state);
+Err edb_execute_original(Edb_State *state);
+Inst *edb_inst_at(Edb_State *state, Inst_Addr addr);
 Edb_Err edb_continue(Edb_State *state);
 Edb_Err edb_find_addr_of_label(Edb_State *state, String_View name, Inst_Addr *out);
 Edb_Err edb_parse_label_or_addr(Edb_State *st, String_View in, Inst_Addr *out);
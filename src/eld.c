@@ -0,0 +1,189 @@
+#include "./evm.h"
+
+static char *shift(int *argc, char ***argv) {
+	assert(*argc > 0);
+	char *result = **argv;
+	*argv += 1;
+	*argc -= 1;
+	return result;
+}
+
+static void usage(FILE *stream, const char *program) {
+	fprintf(stream, "Usage: %s [-g] -o <output.evm> <input.eo>...\n", program);
+}
+
+static void link_symbol(EASM *linked, Relocation relocation, Inst *inst) {
+	Binding binding = { 0 };
+	if (!easm_resolve_binding(linked, relocation.symbol, &binding)) {
+		fprintf(stderr, FL_Fmt": ERROR: undefined symbol `"SV_Fmt"`\n", FL_Arg(relocation.location), SV_Arg(relocation.symbol));
+		exit(1);
+	}
+
+	if (inst->type == INST_CALL && binding.kind != BINDING_LABEL) {
+		fprintf(stderr, FL_Fmt": ERROR: trying to call not a label. `"SV_Fmt"` is %s\n", FL_Arg(relocation.location), SV_Arg(relocation.symbol), binding_kind_as_cstr(binding.kind));
+		fprintf(stderr, FL_Fmt": NOTE: `"SV_Fmt"` is defined here\n", FL_Arg(binding.location), SV_Arg(relocation.symbol));
+		exit(1);
+	}
+
+	if (inst->type == INST_NATIVE && binding.kind != BINDING_NATIVE) {
+		fprintf(stderr, FL_Fmt": ERROR: trying to invoke native function from a binding that is %s\n", FL_Arg(relocation.location), binding_kind_as_cstr(binding.kind));
+		fprintf(stderr, FL_Fmt": NOTE: `"SV_Fmt"` is defined here\n", FL_Arg(binding.location), SV_Arg(relocation.symbol));
+		exit(1);
+	}
+
+	inst->operand = binding.value;
+
+	if (binding.kind == BINDING_LABEL) {
+		easm_push_relocation(linked, RELOC_CODE, relocation.addr, relocation.symbol, relocation.location);
+	} else if (binding.kind == BINDING_DATA) {
+		easm_push_relocation(linked, RELOC_DATA, relocation.addr, relocation.symbol, relocation.location);
+	}
+}
+
+int main(int argc, char **argv) {
+	int have_symbol_table = 0;
+	const char *program = shift(&argc, &argv);
+	const char *output_file_path = NULL;
+
+	const char **input_file_paths = malloc(sizeof(*input_file_paths) * ((size_t) argc + 1));
+	size_t objects_size = 0;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+
+		if (strcmp(flag, "-g") == 0) {
+			have_symbol_table = 1;
+		} else if (strcmp(flag, "-o") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			output_file_path = shift(&argc, &argv);
+		} else {
+			input_file_paths[objects_size++] = flag;
+		}
+	}
+
+	if (output_file_path == NULL) {
+		usage(stderr, program);
+		fprintf(stderr, "ERROR: expected output\n");
+		exit(1);
+	}
+
+	if (objects_size == 0) {
+		usage(stderr, program);
+		fprintf(stderr, "ERROR: expected at least one input\n");
+		exit(1);
+	}
+
+	EASM *objects = calloc(objects_size, sizeof(*objects));
+	Inst_Addr *code_bases = calloc(objects_size, sizeof(*code_bases));
+	Memory_Addr *data_bases = calloc(objects_size, sizeof(*data_bases));
+	if (objects == NULL || code_bases == NULL || data_bases == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for the objects: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	static EASM linked = { 0 };
+
+	// Layout: sections of the objects follow each other in the command line order
+	for (size_t i = 0; i < objects_size; ++i) {
+		EASM *object = &objects[i];
+		easm_load_object_from_file(object, input_file_paths[i]);
+
+		code_bases[i] = linked.program_size;
+		data_bases[i] = linked.memory_size;
+
+		EASM_TABLE_RESERVE(linked.program, linked.program_size, linked.program_capacity, object->program_size);
+		if (object->program_size > 0) {
+			memcpy(linked.program + linked.program_size, object->program, sizeof(object->program[0]) * object->program_size);
+		}
+		linked.program_size += object->program_size;
+
+		// NOTE: an object owns its whole capacity, the bytes past its saved memory are the
+		// zeroed #reserve buffers and the next object must not be placed on top of them
+		const uint64_t capacity = object->memory_capacity > object->memory_size ? object->memory_capacity : object->memory_size;
+		EASM_TABLE_RESERVE(linked.memory, linked.memory_size, linked.memory_allocated, capacity);
+		if (object->memory_size > 0) {
+			memcpy(linked.memory + linked.memory_size, object->memory, object->memory_size);
+		}
+		memset(linked.memory + linked.memory_size + object->memory_size, 0, capacity - object->memory_size);
+		linked.memory_size += capacity;
+		if (data_bases[i] + capacity > linked.memory_capacity) {
+			linked.memory_capacity = data_bases[i] + capacity;
+		}
+
+		if (object->has_entry) {
+			if (linked.has_entry) {
+				fprintf(stderr, "%s: ERROR: entry point has been already set!\n", input_file_paths[i]);
+				fprintf(stderr, FL_Fmt": NOTE: the first entry point\n", FL_Arg(linked.entry_location));
+				exit(1);
+			}
+
+			linked.has_entry = true;
+			linked.entry = code_bases[i] + object->entry;
+			linked.entry_location = (File_Location) { .file_path = sv_from_cstr(input_file_paths[i]) };
+		}
+	}
+
+	if (!linked.has_entry) {
+		fprintf(stderr, "ERROR: none of the objects provides an entry point. Use preprocessor directive #entry to provide the entry point\n");
+		exit(1);
+	}
+
+	// Symbols: everything an object binds is visible to the others, just like with #include
+	for (size_t i = 0; i < objects_size; ++i) {
+		for (size_t j = 0; j < objects[i].bindings_size; ++j) {
+			Binding binding = objects[i].bindings[j];
+			if (binding.kind == BINDING_LABEL) binding.value.as_u64 += code_bases[i];
+			if (binding.kind == BINDING_DATA) binding.value.as_u64 += data_bases[i];
+
+			Binding existing = { 0 };
+			if (!easm_bind_value(&linked, binding.name, binding.value, binding.kind, binding.location, &existing)) {
+				// NOTE: the same #const or #native declared by several objects is harmless
+				const bool same = existing.kind == binding.kind && existing.value.as_u64 == binding.value.as_u64;
+				if (same && (binding.kind == BINDING_CONST || binding.kind == BINDING_NATIVE)) continue;
+
+				fprintf(stderr, FL_Fmt": ERROR: name `"SV_Fmt"` is already bound\n", FL_Arg(binding.location), SV_Arg(binding.name));
+				fprintf(stderr, FL_Fmt": NOTE: first binding is located here\n", FL_Arg(existing.location));
+				exit(1);
+			}
+		}
+	}
+
+	// Relocations
+	for (size_t i = 0; i < objects_size; ++i) {
+		for (size_t j = 0; j < objects[i].relocations_size; ++j) {
+			Relocation relocation = objects[i].relocations[j];
+			relocation.addr += code_bases[i];
+			Inst *inst = &linked.program[relocation.addr];
+
+			switch (relocation.kind) {
+				case RELOC_CODE:
+					inst->operand.as_u64 += code_bases[i];
+					easm_push_relocation(&linked, relocation.kind, relocation.addr, relocation.symbol, relocation.location);
+				break;
+
+				case RELOC_DATA:
+					inst->operand.as_u64 += data_bases[i];
+					easm_push_relocation(&linked, relocation.kind, relocation.addr, relocation.symbol, relocation.location);
+				break;
+
+				case RELOC_SYMBOL:
+					link_symbol(&linked, relocation, inst);
+				break;
+
+				default: UNREACHABLE("NOT EXISTING RELOC_KIND");
+			}
+		}
+	}
+
+	easm_save_to_file(&linked, output_file_path);
+
+	if (have_symbol_table) {
+		easm_save_symbols_to_file(&linked, arena_cstr_concat2(&linked.arena, output_file_path, ".sym"));
+	}
+
+	return 0;
+}
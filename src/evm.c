@@ -0,0 +1,3 @@
+// NOTE: the implementation of evm.h, ebuild compiles it once and links it into every tool
+#define EVM_IMPLEMENTATION
+#include "./evm.h"
@@ -9,6 +9,7 @@
 #include <string.h>
 #include <errno.h>
 #include <ctype.h>
+#include <time.h>
 
 // NOTE: Stolen from https://stackoverflow.com/a/3312896
 #if defined(__GNUC__) || defined(__clang__)
@@ -33,17 +34,22 @@
 
 #define EVM_WORD_SIZE 8
 #define EVM_STACK_CAPACITY 1024
+#define EVM_RET_STACK_CAPACITY 1024
 #define EVM_PROGRAM_CAPACITY 1024
 #define EVM_NATIVES_CAPACITY 1024
 #define EVM_MEMORY_CAPACITY (640 * 1000)
 
-#define EASM_BINDINGS_CAPACITY 1024
-#define EASM_DEFERRED_OPERANDS_CAPACITY 1024
+#define EASM_INLINE_MAX_INSTS 16
+#define EASM_TABLE_INIT_CAPACITY 256
 #define EASM_COMMENT_CHAR ';'
 #define EASM_PP_CHAR '#'
 #define EASM_MAX_INCLUDE_LEVEL 64
+#define EASM_MAX_MACRO_LEVEL 64
+#define EASM_INST_TABLE_CAPACITY 256
+// NOTE: Chosen so every mnemonic of the current instruction set lands in its own slot
+#define EASM_INST_HASH_SEED 0x1460
 
-#define ARENA_CAPACITY (640 * 1000)
+#define ARENA_REGION_CAPACITY (640 * 1000)
 
 typedef struct {
 	size_t count;
@@ -92,6 +98,7 @@ typedef enum {
 	ERR_ILLEGAL_OPERAND,
 	ERR_DIV_BY_ZERO,
 	ERR_NULL_NATIVE,
+	ERR_BREAKPOINT,
 } Err;
 
 const char *err_as_cstr(Err err);
@@ -157,6 +164,19 @@ typedef enum {
     	INST_F2I,
     	INST_F2U,
 	INST_HALT,
+	INST_PLUSI_IMM,
+	INST_MINUSI_IMM,
+	INST_EQI_IMM,
+	INST_JMP_IF_NOT,
+	INST_JMP_IF_ZERO,
+	INST_JMP_LTI,
+	INST_LOCAL_GET,
+	INST_LOCAL_SET,
+	INST_ARG_GET,
+	INST_ARG_SET,
+	// NOTE: stops the VM with ERR_BREAKPOINT and leaves ip on it. edbug patches it over the
+	// instructions with a breakpoint, so `continue` runs at the speed of evm_execute_program
+	INST_BREAKPOINT,
 	EASM_NUMBER_OF_INSTS,
 } Inst_Type;
 
@@ -167,16 +187,30 @@ typedef struct {
 
 const char *inst_name(Inst_Type type);
 int inst_has_operand(Inst_Type type);
+bool inst_stack_effect(Inst_Type type, size_t *pops, size_t *pushes);
+bool inst_is_conditional_jump(Inst_Type type);
 bool inst_by_name(String_View name, Inst_Type *type);
 
 typedef struct EVM EVM;
 
 typedef Err (*Evm_Native)(EVM *);
 
+// NOTE: call pushes a frame on the return stack and ret pops it, the operand stack only
+// ever holds values. `fp` is the size of the operand stack at the call: the arguments are
+// right below it and the locals of the callee start there.
+typedef struct {
+	Inst_Addr ret;
+	uint64_t fp;
+} Evm_Frame;
+
 struct EVM {
 	Word stack[EVM_STACK_CAPACITY];
 	uint64_t stack_size;
 
+	Evm_Frame ret_stack[EVM_RET_STACK_CAPACITY];
+	uint64_t ret_stack_size;
+	uint64_t fp;
+
 	Inst program[EVM_PROGRAM_CAPACITY];
 	uint64_t program_size;
 	Inst_Addr ip;
@@ -186,6 +220,9 @@ struct EVM {
 
 	uint8_t memory[EVM_MEMORY_CAPACITY];
 
+	// NOTE: instructions retired since the program was loaded, read by `native insts`
+	uint64_t insts;
+
 	bool halt;
 };
 
@@ -195,10 +232,24 @@ void evm_push_native(EVM *evm, Evm_Native native);
 void evm_dump_stack(FILE *stream, const EVM *evm);
 void evm_dump_memory(FILE *stream, const EVM *evm);
 void evm_push_inst(EVM *evm, Inst inst);
+bool evm_try_load_program_from_file(EVM *evm, const char *file_path, char *error, size_t error_size);
 void evm_load_program_from_file(EVM *evm, const char *file_path);
 
+// NOTE: how many times every instruction ran and how many times every jmp_if jumped.
+// Recorded by `evmi -profile` and consumed by `easm -profile`.
+typedef struct {
+	uint64_t counts[EVM_PROGRAM_CAPACITY];
+	uint64_t taken[EVM_PROGRAM_CAPACITY];
+} Evm_Profile;
+
+#define EVM_PROFILE_MAGIC "evm-profile"
+
+Err evm_execute_program_profiled(EVM *evm, int limit, Evm_Profile *profile);
+void evm_save_profile_to_file(const EVM *evm, const Evm_Profile *profile, const char *file_path);
+uint64_t inst_program_hash(const Inst *program, uint64_t program_size);
+
 #define EVM_FILE_MAGIC 0x6D65
-#define EVM_FILE_VERSION 4
+#define EVM_FILE_VERSION 6
 
 PACK(struct Evm_File_Meta {
 	uint16_t magic;
@@ -211,13 +262,63 @@ PACK(struct Evm_File_Meta {
 
 typedef struct Evm_File_Meta Evm_File_Meta;
 
+#define EVM_OBJECT_MAGIC 0x6F65
+#define EVM_OBJECT_VERSION 3
+
+// NOTE: Relocatable object produced by `easm -c` and consumed by `eld`. After the meta
+// follow the program, the memory, the bindings, the relocations and the string table
+// that holds the names referenced by the bindings and relocations.
+PACK(struct Evm_Object_Meta {
+	uint16_t magic;
+	uint16_t version;
+	uint64_t program_size;
+	uint64_t memory_size;
+	uint64_t memory_capacity;
+	uint64_t has_entry;
+	uint64_t entry;
+	uint64_t bindings_size;
+	uint64_t relocations_size;
+	uint64_t strings_size;
+});
+
+typedef struct Evm_Object_Meta Evm_Object_Meta;
+
+PACK(struct Evm_Object_Binding {
+	uint8_t kind;
+	uint64_t value;
+	uint64_t name_offset;
+	uint64_t name_size;
+});
+
+typedef struct Evm_Object_Binding Evm_Object_Binding;
+
+PACK(struct Evm_Object_Relocation {
+	uint8_t kind;
+	uint64_t addr;
+	uint64_t symbol_offset;
+	uint64_t symbol_size;
+});
+
+typedef struct Evm_Object_Relocation Evm_Object_Relocation;
+
+typedef struct Region Region;
+
+struct Region {
+	Region *next;
+	size_t capacity;
+	size_t size;
+	char buffer[];
+};
+
 // NOTE: https://en.wikipedia.org/wiki/Region-based_memory_management
+// Regions are chained and never reallocated, so whatever was handed out stays put.
 typedef struct {
-	char buffer[ARENA_CAPACITY];
-	size_t size;
+	Region *first;
+	Region *last;
 } Arena;
 
 void *arena_alloc(Arena *arena, size_t size);
+void arena_free(Arena *arena);
 String_View arena_slurp_file(Arena *arena, String_View file_path);
 const char *arena_sv_to_cstr(Arena *arena, String_View sv);
 String_View arena_sv_concat2(Arena *arena, const char *a, const char *b);
@@ -235,6 +336,7 @@ typedef enum {
     	BINDING_CONST = 0,
     	BINDING_LABEL,
     	BINDING_NATIVE,
+	BINDING_DATA,
 } Binding_Kind;
 
 const char *binding_kind_as_cstr(Binding_Kind kind);
@@ -244,44 +346,167 @@ typedef struct {
 	String_View name;
 	Word value;
 	File_Location location;
+	// NOTE: only known for #const bindings, the constant expressions need them
+	bool is_float;
+	uint64_t size;		// amount of bytes of a BINDING_DATA string
 } Binding;
 
+// NOTE: code_refs/data_refs count how many label/string addresses are summed up in
+// the value. It can be relocated only when that is exactly one address plus an offset.
+typedef struct {
+	Word value;
+	bool is_float;
+	int64_t code_refs;
+	int64_t data_refs;
+	bool is_scaled;		// an address went through something other than + or -
+	bool uses_labels;
+	uint64_t size;		// amount of bytes when the value is a string
+} Expr_Value;
+
 typedef struct {
 	Inst_Addr addr;
 	String_View label;
 	File_Location location;
 } Deferred_Operand;
 
+typedef enum {
+	RELOC_CODE = 0,		// operand is an address in the program
+	RELOC_DATA,		// operand is an address in the memory
+	RELOC_SYMBOL,		// operand is the value of a symbol defined elsewhere
+} Reloc_Kind;
+
+const char *reloc_kind_as_cstr(Reloc_Kind kind);
+
+typedef struct {
+	Reloc_Kind kind;
+	Inst_Addr addr;
+	String_View symbol;
+	File_Location location;
+} Relocation;
+
+// NOTE: a string literal placed into the memory
+typedef struct {
+	Memory_Addr addr;
+	size_t size;
+} Memory_Chunk;
+
+// NOTE: `#macro name params...` ... `#endmacro`. Labels defined by the body are local to
+// every expansion, they get renamed so the macro can be expanded many times.
+typedef struct {
+	String_View name;
+	String_View *params;
+	size_t params_size;
+	String_View *locals;
+	size_t locals_size;
+	String_View body;
+	File_Location location;
+	size_t expansions;
+} Macro;
+
+// NOTE: Grows a malloc'd table so it can fit `needed` more items
+#define EASM_TABLE_RESERVE(items, size, capacity, needed)						\
+	do {												\
+		if ((size) + (needed) > (capacity)) {							\
+			size_t new_capacity = (capacity) == 0 ? EASM_TABLE_INIT_CAPACITY : (capacity);	\
+			while ((size) + (needed) > new_capacity) new_capacity *= 2;			\
+			(items) = realloc((items), new_capacity * sizeof(*(items)));			\
+			if ((items) == NULL) {								\
+				fprintf(stderr, "ERROR: could not grow assembler table: %s\n", strerror(errno)); \
+				exit(1);								\
+			}										\
+			(capacity) = new_capacity;							\
+		}											\
+	} while (false)
+
 typedef struct {
-	Binding bindings[EASM_BINDINGS_CAPACITY];
+	Binding *bindings;
 	size_t bindings_size;
+	size_t bindings_capacity;
+	// NOTE: open addressing over the names of the bindings, a slot holds the index of a
+	// binding + 1 and zero marks an empty one. It is never more than half full
+	size_t *binding_slots;
+	size_t binding_slots_capacity;
 
-	Deferred_Operand deferred_operands[EASM_DEFERRED_OPERANDS_CAPACITY];
+	Deferred_Operand *deferred_operands;
 	size_t deferred_operands_size;
+	size_t deferred_operands_capacity;
 
-	Inst program[EVM_PROGRAM_CAPACITY];
+	Relocation *relocations;
+	size_t relocations_size;
+	size_t relocations_capacity;
+	// NOTE: unresolved names become RELOC_SYMBOL relocations instead of errors
+	bool is_object;
+	// NOTE: distances between labels are not relocated, so the optimizer must not move the code
+	bool has_label_arithmetic;
+
+	Inst *program;
     	uint64_t program_size;
+	size_t program_capacity;
+	// NOTE: where every instruction came from, filled only by the translation. The optimizer
+	// and the linker do not keep it, the debug info of easm2elf uses it
+	File_Location *locations;
+	size_t locations_capacity;
 	Inst_Addr entry;
 	bool has_entry;
 	String_View deferred_entry_binding_name;
 	File_Location entry_location;
 
-    	uint8_t memory[EVM_MEMORY_CAPACITY];
+    	uint8_t *memory;
     	size_t memory_size;
     	size_t memory_capacity;
+	size_t memory_allocated;
+
+	Memory_Chunk *strings;
+	size_t strings_size;
+	size_t strings_capacity;
 
 	Arena arena;
 
 	size_t include_level;
+	size_t source_size;
+
+	String_View *include_paths;
+	size_t include_paths_size;
+	size_t include_paths_capacity;
+
+	// NOTE: canonical paths of the files translated so far, each one is parsed only once
+	String_View *included_files;
+	size_t included_files_size;
+	size_t included_files_capacity;
+
+	Macro *macros;
+	size_t macros_size;
+	size_t macros_capacity;
+	size_t macro_level;
 } EASM;
 
 bool easm_resolve_binding(const EASM *easm, String_View name, Binding *binding);
 bool easm_bind_value(EASM *easm, String_View name, Word word, Binding_Kind kind, File_Location location, Binding *existing_binding);
 void easm_push_deferred_operand(EASM *easm, Inst_Addr addr, String_View name, File_Location location);
 bool easm_translate_literal(EASM *easm, String_View sv, Word *output);
+Expr_Value easm_eval_expr(EASM *easm, String_View sv, File_Location location);
+bool easm_expr_relocation(EASM *easm, Expr_Value value, File_Location location, Reloc_Kind *kind);
+void easm_push_relocation(EASM *easm, Reloc_Kind kind, Inst_Addr addr, String_View symbol, File_Location location);
 void easm_save_to_file(EASM *easm, const char *output_file_path);
+void easm_save_symbols_to_file(EASM *easm, const char *output_file_path);
+void easm_save_object_to_file(EASM *easm, const char *output_file_path);
+void easm_load_object_from_file(EASM *easm, const char *input_file_path);
 Word easm_push_string_to_memory(EASM *easm, String_View sv);
+Word easm_reserve_memory(EASM *easm, uint64_t size);
 void easm_translate_source(EASM *easm, String_View input_file_path);
+void easm_optimize(EASM *easm);
+void easm_eliminate_dead_code(EASM *easm, size_t *removed_insts, size_t *removed_bytes);
+void easm_load_profile_from_file(const EASM *easm, const char *file_path, Evm_Profile *profile);
+void easm_layout_program(EASM *easm, const Evm_Profile *profile);
+bool easm_inst_has_code_operand(Inst_Type type);
+void easm_find_targets(const EASM *easm, int *reloc, bool *is_target);
+void easm_clean(EASM *easm);
+void easm_add_include_path(EASM *easm, String_View path);
+bool easm_resolve_include_path(EASM *easm, String_View includer_path, String_View path, String_View *resolved);
+bool easm_canonical_path(EASM *easm, String_View path, String_View *canonical);
+Macro *easm_find_macro(EASM *easm, String_View name);
+void easm_define_macro(EASM *easm, String_View header, String_View *source, File_Location *location);
+void easm_expand_macro(EASM *easm, Macro *macro, String_View args, File_Location location);
 
 void evm_load_standard_natives(EVM *evm);
 Err evm_alloc(EVM *evm);
@@ -292,6 +517,10 @@ Err evm_print_f64(EVM *evm);
 Err evm_print_ptr(EVM *evm);
 Err evm_print_memory(EVM *evm);
 Err evm_write(EVM *evm);
+Err evm_native_clock(EVM *evm);
+Err evm_native_insts(EVM *evm);
+Err evm_native_region(EVM *evm);
+uint64_t evm_clock_ns(void);
 
 #endif // EVM_H_
 
@@ -324,6 +553,7 @@ const char *err_as_cstr(Err err) {
 		case ERR_ILLEGAL_OPERAND:		return "ERR_ILLEGAL_OPERAND";
 		case ERR_DIV_BY_ZERO:			return "ERR_DIV_BY_ZERO";
 		case ERR_NULL_NATIVE:			return "ERR_NULL_NATIVE";
+		case ERR_BREAKPOINT:			return "ERR_BREAKPOINT";
 		default: UNREACHABLE("NOT EXISTING ERR");
 	}
 }
@@ -390,6 +620,17 @@ const char *inst_name(Inst_Type type) {
     		case INST_U2F:     	return "u2f";
     		case INST_F2I:     	return "f2i";
     		case INST_F2U:     	return "f2u";
+		case INST_PLUSI_IMM:	return "plusi_imm";
+		case INST_MINUSI_IMM:	return "minusi_imm";
+		case INST_EQI_IMM:	return "eqi_imm";
+		case INST_JMP_IF_NOT:	return "jmp_if_not";
+		case INST_JMP_IF_ZERO:	return "jmp_if_zero";
+		case INST_JMP_LTI:	return "jmp_lti";
+		case INST_LOCAL_GET:	return "local_get";
+		case INST_LOCAL_SET:	return "local_set";
+		case INST_ARG_GET:	return "arg_get";
+		case INST_ARG_SET:	return "arg_set";
+		case INST_BREAKPOINT:	return "breakpoint";
 		case EASM_NUMBER_OF_INSTS:
 		default: UNREACHABLE("NOT EXISTING INST_TYPE");
 	}
@@ -457,14 +698,179 @@ int inst_has_operand(Inst_Type type) {
     		case INST_U2F:     	return 0;
     		case INST_F2I:     	return 0;
     		case INST_F2U:     	return 0;
+		case INST_PLUSI_IMM:	return 1;
+		case INST_MINUSI_IMM:	return 1;
+		case INST_EQI_IMM:	return 1;
+		case INST_JMP_IF_NOT:	return 1;
+		case INST_JMP_IF_ZERO:	return 1;
+		case INST_JMP_LTI:	return 1;
+		case INST_LOCAL_GET:	return 1;
+		case INST_LOCAL_SET:	return 1;
+		case INST_ARG_GET:	return 1;
+		case INST_ARG_SET:	return 1;
+		case INST_BREAKPOINT:	return 0;
+		case EASM_NUMBER_OF_INSTS:
+		default: UNREACHABLE("NOT EXISTING INST_TYPE");
+	}
+}
+
+// NOTE: how many values the instruction takes from the stack and puts back. dup and swap
+// also reach `operand` values deep, the local_* and arg_* ones reach into the frame. The
+// effect of call and native depends on the callee.
+bool inst_stack_effect(Inst_Type type, size_t *pops, size_t *pushes) {
+	switch (type) {
+		case INST_NOP:
+		case INST_SWAP:
+		case INST_JMP:
+		case INST_JMP_IF_ZERO:
+		case INST_HALT:
+		case INST_RET:
+		case INST_BREAKPOINT:
+			*pops = 0;
+			*pushes = 0;
+			return true;
+
+		case INST_PUSH:
+		case INST_DUP:
+		case INST_LOCAL_GET:
+		case INST_ARG_GET:
+			*pops = 0;
+			*pushes = 1;
+			return true;
+
+		case INST_DROP:
+		case INST_JMP_IF:
+		case INST_JMP_IF_NOT:
+		case INST_LOCAL_SET:
+		case INST_ARG_SET:
+			*pops = 1;
+			*pushes = 0;
+			return true;
+
+		case INST_PLUSI:
+		case INST_MINUSI:
+		case INST_MULTI:
+		case INST_DIVI:
+		case INST_MODI:
+		case INST_MULTU:
+		case INST_DIVU:
+		case INST_MODU:
+		case INST_PLUSF:
+		case INST_MINUSF:
+		case INST_MULTF:
+		case INST_DIVF:
+		case INST_EQI:
+		case INST_GEI:
+		case INST_GTI:
+		case INST_LEI:
+		case INST_LTI:
+		case INST_NEI:
+		case INST_EQF:
+		case INST_GEF:
+		case INST_GTF:
+		case INST_LEF:
+		case INST_LTF:
+		case INST_NEF:
+		case INST_EQU:
+		case INST_GEU:
+		case INST_GTU:
+		case INST_LEU:
+		case INST_LTU:
+		case INST_NEU:
+		case INST_ANDB:
+		case INST_ORB:
+		case INST_XOR:
+		case INST_SHR:
+		case INST_SHL:
+			*pops = 2;
+			*pushes = 1;
+			return true;
+
+		case INST_NOT:
+		case INST_NOTB:
+		case INST_READ8:
+		case INST_READ16:
+		case INST_READ32:
+		case INST_READ64:
+		case INST_I2F:
+		case INST_U2F:
+		case INST_F2I:
+		case INST_F2U:
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM:
+		case INST_EQI_IMM:
+			*pops = 1;
+			*pushes = 1;
+			return true;
+
+		case INST_WRITE8:
+		case INST_WRITE16:
+		case INST_WRITE32:
+		case INST_WRITE64:
+		case INST_JMP_LTI:
+			*pops = 2;
+			*pushes = 0;
+			return true;
+
+		case INST_CALL:
+		case INST_NATIVE:
+			return false;
+
 		case EASM_NUMBER_OF_INSTS:
 		default: UNREACHABLE("NOT EXISTING INST_TYPE");
 	}
 }
 
+// NOTE: jumps that may also fall through to the next instruction
+bool inst_is_conditional_jump(Inst_Type type) {
+	return type == INST_JMP_IF || type == INST_JMP_IF_NOT || type == INST_JMP_IF_ZERO || type == INST_JMP_LTI;
+}
+
+static_assert(EASM_NUMBER_OF_INSTS < EASM_INST_TABLE_CAPACITY, "The mnemonic table is too small for the instruction set");
+
+static uint32_t inst_name_hash(String_View name) {
+	uint32_t hash = EASM_INST_HASH_SEED;
+	for (size_t i = 0; i < name.count; ++i) {
+		hash ^= (uint8_t) name.data[i];
+		hash *= 16777619u;
+	}
+	hash ^= hash >> 15;
+	return hash & (EASM_INST_TABLE_CAPACITY - 1);
+}
+
+// NOTE: FNV-1a over the instructions field by field, the padding of Inst is never looked at
+uint64_t inst_program_hash(const Inst *program, uint64_t program_size) {
+	uint64_t hash = 14695981039346656037ull;
+	for (uint64_t i = 0; i < program_size; ++i) {
+		const uint64_t fields[2] = { (uint64_t) program[i].type, program[i].operand.as_u64 };
+		for (size_t j = 0; j < sizeof(fields); ++j) {
+			hash ^= ((const uint8_t *) fields)[j];
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
 bool inst_by_name(String_View name, Inst_Type *type) {
-	for (Inst_Type t = (Inst_Type) 0; t < EASM_NUMBER_OF_INSTS; ++t) {
-		if (sv_eq(sv_from_cstr(inst_name(t)), name)) {
+	// NOTE: slot holds Inst_Type + 1, zero marks an empty slot. The seed keeps the
+	// current mnemonics collision free, probing only matters if the ISA grows.
+	static uint8_t table[EASM_INST_TABLE_CAPACITY] = { 0 };
+	static bool table_ready = false;
+
+	if (!table_ready) {
+		for (Inst_Type t = (Inst_Type) 0; t < EASM_NUMBER_OF_INSTS; ++t) {
+			uint32_t slot = inst_name_hash(sv_from_cstr(inst_name(t)));
+			while (table[slot] != 0) slot = (slot + 1) & (EASM_INST_TABLE_CAPACITY - 1);
+			table[slot] = (uint8_t) (t + 1);
+		}
+		table_ready = true;
+	}
+
+	for (uint32_t slot = inst_name_hash(name); table[slot] != 0; slot = (slot + 1) & (EASM_INST_TABLE_CAPACITY - 1)) {
+		const Inst_Type t = (Inst_Type) (table[slot] - 1);
+		const char *candidate = inst_name(t);
+		// NOTE: strncmp stops at the end of a mnemonic shorter than the name, memcmp would read past it
+		if (strncmp(candidate, name.data, name.count) == 0 && candidate[name.count] == '\0') {
 			*type = t;
 			return true;
 		}
@@ -491,6 +897,7 @@ Err evm_execute_inst(EVM *evm) {
 	if(evm->ip >= evm->program_size) return ERR_ILLEGAL_INST_ACCESS;
 
 	Inst inst = evm->program[evm->ip];
+	evm->insts += 1;
 
 	switch (inst.type) {
 		case INST_NOP:
@@ -498,7 +905,7 @@ Err evm_execute_inst(EVM *evm) {
 		break;
 
 		case INST_PUSH:
-			if (evm->stack_size > EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+			if (evm->stack_size >= EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
 			evm->stack[evm->stack_size++] = inst.operand;
 			evm->ip += 1;
 		break;
@@ -510,7 +917,7 @@ Err evm_execute_inst(EVM *evm) {
 		break;
 
 		case INST_DUP:
-			if (evm->stack_size > EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+			if (evm->stack_size >= EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
 			if (evm->stack_size - inst.operand.as_u64 <= 0) return ERR_STACK_UNDERFLOW;
 			evm->stack[evm->stack_size] = evm->stack[evm->stack_size - 1 - inst.operand.as_u64];
 			evm->stack_size += 1;
@@ -533,9 +940,14 @@ Err evm_execute_inst(EVM *evm) {
 			BINARY_OP(evm, u64, u64, *);
 		break;
 
+		// NOTE: INT64_MIN / -1 does not fit, it wraps around to INT64_MIN like multi by -1 does
 		case INST_DIVI:
 		        if (evm->stack[evm->stack_size - 1].as_i64 == 0) return ERR_DIV_BY_ZERO;
-        		BINARY_OP(evm, i64, i64, /);
+			if (evm->stack[evm->stack_size - 1].as_i64 == -1) {
+				BINARY_OP(evm, u64, u64, *);
+			} else {
+        			BINARY_OP(evm, i64, i64, /);
+			}
     		break;
 
     		case INST_DIVU:
@@ -543,8 +955,10 @@ Err evm_execute_inst(EVM *evm) {
 			BINARY_OP(evm, u64, u64, /);
 		break;
 
+		// NOTE: anything modulo -1 is 0, INT64_MIN % -1 would trap like the division
 		case INST_MODI:
 		        if (evm->stack[evm->stack_size - 1].as_i64 == 0) return ERR_DIV_BY_ZERO;
+			if (evm->stack[evm->stack_size - 1].as_i64 == -1) evm->stack[evm->stack_size - 1].as_i64 = 1;
         		BINARY_OP(evm, i64, i64, %);
     		break;
 
@@ -569,6 +983,24 @@ Err evm_execute_inst(EVM *evm) {
 			BINARY_OP(evm, f64, f64, /);
 		break;
 
+		case INST_PLUSI_IMM:
+			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
+			evm->stack[evm->stack_size - 1].as_u64 += inst.operand.as_u64;
+			evm->ip += 1;
+		break;
+
+		case INST_MINUSI_IMM:
+			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
+			evm->stack[evm->stack_size - 1].as_u64 -= inst.operand.as_u64;
+			evm->ip += 1;
+		break;
+
+		case INST_EQI_IMM:
+			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
+			evm->stack[evm->stack_size - 1].as_u64 = evm->stack[evm->stack_size - 1].as_i64 == inst.operand.as_i64;
+			evm->ip += 1;
+		break;
+
 		case INST_JMP:
 			evm->ip = inst.operand.as_u64;
 		break;
@@ -583,18 +1015,83 @@ Err evm_execute_inst(EVM *evm) {
 			evm->stack_size -= 1;
 		break;
 
-		case INST_RET:
+		case INST_JMP_IF_NOT:
 			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
-			evm->ip = evm->stack[evm->stack_size - 1].as_u64;
+			if (!evm->stack[evm->stack_size - 1].as_u64) {
+				evm->ip = inst.operand.as_u64;
+			} else {
+				evm->ip += 1;
+			}
 			evm->stack_size -= 1;
 		break;
 
+		// NOTE: the tested value stays on the stack, it is usually a counter
+		case INST_JMP_IF_ZERO:
+			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
+			if (!evm->stack[evm->stack_size - 1].as_u64) {
+				evm->ip = inst.operand.as_u64;
+			} else {
+				evm->ip += 1;
+			}
+		break;
+
+		case INST_JMP_LTI:
+			if (evm->stack_size < 2) return ERR_STACK_UNDERFLOW;
+			if (evm->stack[evm->stack_size - 2].as_i64 < evm->stack[evm->stack_size - 1].as_i64) {
+				evm->ip = inst.operand.as_u64;
+			} else {
+				evm->ip += 1;
+			}
+			evm->stack_size -= 2;
+		break;
+
+		case INST_RET:
+			if (evm->ret_stack_size < 1) return ERR_STACK_UNDERFLOW;
+			evm->ret_stack_size -= 1;
+			evm->ip = evm->ret_stack[evm->ret_stack_size].ret;
+			evm->fp = evm->ret_stack[evm->ret_stack_size].fp;
+		break;
+
 		case INST_CALL:
-			if (evm->stack_size > EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
-			evm->stack[evm->stack_size++].as_u64 = evm->ip + 1;
+			if (evm->ret_stack_size >= EVM_RET_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+			evm->ret_stack[evm->ret_stack_size++] = (Evm_Frame) { .ret = evm->ip + 1, .fp = evm->fp };
+			evm->fp = evm->stack_size;
 			evm->ip = inst.operand.as_u64;
 		break;
 
+		case INST_LOCAL_GET:
+			if (evm->stack_size >= EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+			// NOTE: the callee may have taken its arguments and gone below the frame
+			if (evm->fp >= evm->stack_size || inst.operand.as_u64 >= evm->stack_size - evm->fp) return ERR_ILLEGAL_OPERAND;
+			evm->stack[evm->stack_size] = evm->stack[evm->fp + inst.operand.as_u64];
+			evm->stack_size += 1;
+			evm->ip += 1;
+		break;
+
+		case INST_LOCAL_SET:
+			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
+			if (evm->fp >= evm->stack_size - 1 || inst.operand.as_u64 >= evm->stack_size - 1 - evm->fp) return ERR_ILLEGAL_OPERAND;
+			evm->stack[evm->fp + inst.operand.as_u64] = evm->stack[evm->stack_size - 1];
+			evm->stack_size -= 1;
+			evm->ip += 1;
+		break;
+
+		case INST_ARG_GET:
+			if (evm->stack_size >= EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+			if (inst.operand.as_u64 >= evm->fp) return ERR_ILLEGAL_OPERAND;
+			evm->stack[evm->stack_size] = evm->stack[evm->fp - 1 - inst.operand.as_u64];
+			evm->stack_size += 1;
+			evm->ip += 1;
+		break;
+
+		case INST_ARG_SET:
+			if (evm->stack_size < 1) return ERR_STACK_UNDERFLOW;
+			if (inst.operand.as_u64 >= evm->fp || evm->fp - 1 - inst.operand.as_u64 >= evm->stack_size - 1) return ERR_ILLEGAL_OPERAND;
+			evm->stack[evm->fp - 1 - inst.operand.as_u64] = evm->stack[evm->stack_size - 1];
+			evm->stack_size -= 1;
+			evm->ip += 1;
+		break;
+
 		case INST_NATIVE:
 			if (inst.operand.as_u64 > evm->natives_size) return ERR_ILLEGAL_OPERAND;
 			if (!evm->natives[inst.operand.as_u64]) { return ERR_NULL_NATIVE; }
@@ -685,6 +1182,11 @@ Err evm_execute_inst(EVM *evm) {
 			evm->halt = true;
 		break;
 
+		case INST_BREAKPOINT:
+			// NOTE: nothing ran, the instruction under it is the one that retires
+			evm->insts -= 1;
+		return ERR_BREAKPOINT;
+
 		case INST_SWAP:
 			if (inst.operand.as_u64 >= evm->stack_size) return ERR_STACK_UNDERFLOW;
 			const uint64_t a = evm->stack_size - 1;
@@ -826,6 +1328,24 @@ Err evm_execute_program(EVM *evm, int limit) {
 	return ERR_OK;
 }
 
+Err evm_execute_program_profiled(EVM *evm, int limit, Evm_Profile *profile) {
+	while (limit != 0 && !evm->halt) {
+		const Inst_Addr ip = evm->ip;
+		if (ip < EVM_PROGRAM_CAPACITY) profile->counts[ip] += 1;
+
+		Err err = evm_execute_inst(evm);
+		if (err != ERR_OK) {
+			return err;
+		}
+
+		if (inst_is_conditional_jump(evm->program[ip].type) && evm->ip != ip + 1) profile->taken[ip] += 1;
+
+		if (limit > 0) --limit;
+	}
+
+	return ERR_OK;
+}
+
 void evm_push_native(EVM *evm, Evm_Native native) {
 	assert(evm->natives_size < EVM_NATIVES_CAPACITY);
 	evm->natives[evm->natives_size++] = native;
@@ -844,6 +1364,15 @@ void evm_dump_stack(FILE *stream, const EVM *evm) {
 	} else {
 		fprintf(stream, "\t[empty]\n");
 	}
+
+	fprintf(stream, "Return stack (fp: %lu):\n", evm->fp);
+	if (evm->ret_stack_size > 0) {
+		for (uint64_t i = 0; i < evm->ret_stack_size; ++i) {
+			fprintf(stream, "  ret: %lu, fp: %lu\n", evm->ret_stack[i].ret, evm->ret_stack[i].fp);
+		}
+	} else {
+		fprintf(stream, "\t[empty]\n");
+	}
 }
 
 void evm_dump_memory(FILE *stream, const EVM *evm) {
@@ -859,62 +1388,103 @@ void evm_push_inst(EVM *evm, Inst inst) {
 	evm->program[evm->program_size++] = inst;
 }
 
-void evm_load_program_from_file(EVM *evm, const char *file_path) {
+// NOTE: the reason of a failure goes to error instead of stderr, so a caller that runs many
+// programs can report it and go on
+bool evm_try_load_program_from_file(EVM *evm, const char *file_path, char *error, size_t error_size) {
 	FILE *f = fopen(file_path, "rb");
 	if (f == NULL) {
-		fprintf(stderr, "ERROR: Could not open file %s: %s\n", file_path, strerror(errno));
-		exit(1);
+		snprintf(error, error_size, "ERROR: Could not open file %s: %s\n", file_path, strerror(errno));
+		return false;
 	}
 
 	Evm_File_Meta meta = { 0 };
 	size_t n = fread(&meta, sizeof(meta), 1, f);
 	if (n < 1) {
-		fprintf(stderr, "ERROR: Could not read meta data from file %s: %s\n", file_path, strerror(errno));
-		exit(1);
+		snprintf(error, error_size, "ERROR: Could not read meta data from file %s: %s\n", file_path, strerror(errno));
+		fclose(f);
+		return false;
 	}
 
 	if (meta.magic != EVM_FILE_MAGIC) {
-        	fprintf(stderr, "ERROR: %s does not appear to be a valid EVM file. Unexpected magic %04X. Expected %04X.\n", file_path, meta.magic, EVM_FILE_MAGIC);
-		exit(1);
+        	snprintf(error, error_size, "ERROR: %s does not appear to be a valid EVM file. Unexpected magic %04X. Expected %04X.\n", file_path, meta.magic, EVM_FILE_MAGIC);
+		fclose(f);
+		return false;
 	}
 
 	if (meta.version != EVM_FILE_VERSION) {
-        	fprintf(stderr, "ERROR: %s: unsupported version of EVM file %d. Expected version %d.\n", file_path, meta.version, EVM_FILE_VERSION);
-        	exit(1);
+        	snprintf(error, error_size, "ERROR: %s: unsupported version of EVM file %d. Expected version %d.\n", file_path, meta.version, EVM_FILE_VERSION);
+        	fclose(f);
+        	return false;
     	}
 
 	if (meta.program_size > EVM_PROGRAM_CAPACITY) {
-        	fprintf(stderr, "ERROR: %s: program section is too big. The file contains %lu program instruction. But the capacity is %lu\n", file_path, meta.program_size, (uint64_t) EVM_PROGRAM_CAPACITY);
-		exit(1);
+        	snprintf(error, error_size, "ERROR: %s: program section is too big. The file contains %lu program instruction. But the capacity is %lu\n", file_path, meta.program_size, (uint64_t) EVM_PROGRAM_CAPACITY);
+		fclose(f);
+		return false;
 	}
 
 	evm->ip = meta.entry;
 
 	if (meta.memory_capacity > EVM_MEMORY_CAPACITY) {
-        	fprintf(stderr, "ERROR: %s: memory section is too big. The file wants %lu bytes. But the capacity is %lu bytes\n", file_path, meta.memory_capacity, (uint64_t) EVM_MEMORY_CAPACITY);
-        	exit(1);
+        	snprintf(error, error_size, "ERROR: %s: memory section is too big. The file wants %lu bytes. But the capacity is %lu bytes\n", file_path, meta.memory_capacity, (uint64_t) EVM_MEMORY_CAPACITY);
+        	fclose(f);
+        	return false;
     	}
 
 	if (meta.memory_size > meta.memory_capacity) {
-        fprintf(stderr,
-                "ERROR: %s: memory size %lu is greater than declared memory capacity %lu\n", file_path, meta.memory_size, meta.memory_capacity);
-        	exit(1);
+        	snprintf(error, error_size, "ERROR: %s: memory size %lu is greater than declared memory capacity %lu\n", file_path, meta.memory_size, meta.memory_capacity);
+        	fclose(f);
+        	return false;
     	}
 
     	evm->program_size = fread(evm->program, sizeof(evm->program[0]), meta.program_size, f);
 
     	if (evm->program_size != meta.program_size) {
-        	fprintf(stderr, "ERROR: %s: read %zd program instructions, but expected %lu\n", file_path, evm->program_size, meta.program_size);
-        	exit(1);
+        	snprintf(error, error_size, "ERROR: %s: read %zd program instructions, but expected %lu\n", file_path, evm->program_size, meta.program_size);
+        	fclose(f);
+        	return false;
     	}
 
     	n = fread(evm->memory, sizeof(evm->memory[0]), meta.memory_size, f);
 
     	if (n != meta.memory_size) {
-        	fprintf(stderr, "ERROR: %s: read %zd bytes of memory section, but expected %lu bytes.\n", file_path, n, meta.memory_size);
+        	snprintf(error, error_size, "ERROR: %s: read %zd bytes of memory section, but expected %lu bytes.\n", file_path, n, meta.memory_size);
+		fclose(f);
+		return false;
+	}
+
+	fclose(f);
+	return true;
+}
+
+void evm_load_program_from_file(EVM *evm, const char *file_path) {
+	char error[1024];
+	if (!evm_try_load_program_from_file(evm, file_path, error, sizeof(error))) {
+		fprintf(stderr, "%s", error);
+		exit(1);
+	}
+}
+
+// NOTE: the hash ties the profile to the exact program it was recorded on, addresses of
+// any other build mean nothing
+void evm_save_profile_to_file(const EVM *evm, const Evm_Profile *profile, const char *file_path) {
+	FILE *f = fopen(file_path, "w");
+	if (f == NULL) {
+		fprintf(stderr, "ERROR: Could not open file `%s`: %s\n", file_path, strerror(errno));
 		exit(1);
 	}
 
+	fprintf(f, EVM_PROFILE_MAGIC" %lu %016lx\n", evm->program_size, inst_program_hash(evm->program, evm->program_size));
+	for (uint64_t i = 0; i < evm->program_size; ++i) {
+		if (profile->counts[i] > 0) {
+			fprintf(f, "%lu %lu %lu\n", i, profile->counts[i], profile->taken[i]);
+		}
+	}
+
+	if (ferror(f)) {
+		fprintf(stderr, "ERROR: Could not write to file `%s`: %s\n", file_path, strerror(errno));
+		exit(1);
+	}
 	fclose(f);
 }
 
@@ -970,10 +1540,8 @@ String_View sv_trim(String_View sv) {
 }
 
 String_View sv_chop_by_delim(String_View *sv, char delim) {
-	size_t i = 0;
-	while (i < sv->count && sv->data[i] != delim) {
-		i += 1;
-	}
+	const char *end = sv->count > 0 ? memchr(sv->data, delim, sv->count) : NULL;
+	size_t i = end ? (size_t) (end - sv->data) : sv->count;
 
 	String_View result = {
 		.count = i,
@@ -992,38 +1560,110 @@ String_View sv_chop_by_delim(String_View *sv, char delim) {
 }
 
 void *arena_alloc(Arena *arena, size_t size) {
-	assert(arena->size + size <= ARENA_CAPACITY);
+	if (arena->last == NULL || arena->last->size + size > arena->last->capacity) {
+		const size_t capacity = size > ARENA_REGION_CAPACITY ? size : ARENA_REGION_CAPACITY;
+		Region *region = malloc(sizeof(Region) + capacity);
+		if (region == NULL) {
+			fprintf(stderr, "ERROR: could not allocate arena region: %s\n", strerror(errno));
+			exit(1);
+		}
+
+		region->next = NULL;
+		region->capacity = capacity;
+		region->size = 0;
+
+		if (arena->last) {
+			arena->last->next = region;
+		} else {
+			arena->first = region;
+		}
+		arena->last = region;
+	}
 
-	void *result = arena->buffer + arena->size;
-	arena->size += size;
+	void *result = arena->last->buffer + arena->last->size;
+	arena->last->size += size;
 	return result;
 }
 
-bool easm_resolve_binding(const EASM *easm, String_View name, Binding *binding) {
-	for (size_t i = 0; i < easm->bindings_size; ++i) {
-		if (sv_eq(easm->bindings[i].name, name)) {
-			if (binding) *binding = easm->bindings[i];
-			return true;
+void arena_free(Arena *arena) {
+	Region *region = arena->first;
+	while (region) {
+		Region *next = region->next;
+		free(region);
+		region = next;
+	}
+
+	arena->first = NULL;
+	arena->last = NULL;
+}
+
+// NOTE: FNV-1a like inst_name_hash, but over the whole 64 bits
+static uint64_t easm_binding_hash(String_View name) {
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < name.count; ++i) {
+		hash ^= (uint8_t) name.data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// NOTE: the slot where the name is or where it goes
+static size_t *easm_binding_slot(const EASM *easm, String_View name) {
+	const size_t mask = easm->binding_slots_capacity - 1;
+	for (size_t i = easm_binding_hash(name) & mask;; i = (i + 1) & mask) {
+		size_t *slot = &easm->binding_slots[i];
+		if (*slot == 0 || sv_eq(easm->bindings[*slot - 1].name, name)) return slot;
+	}
+}
+
+// NOTE: fills the table again, when it grows and when the bindings were moved around
+static void easm_index_bindings(EASM *easm) {
+	size_t capacity = EASM_TABLE_INIT_CAPACITY;
+	while (capacity < easm->bindings_size * 2 + 2) capacity *= 2;
+	if (capacity != easm->binding_slots_capacity) {
+		free(easm->binding_slots);
+		easm->binding_slots = malloc(sizeof(*easm->binding_slots) * capacity);
+		if (easm->binding_slots == NULL) {
+			fprintf(stderr, "ERROR: could not grow assembler table: %s\n", strerror(errno));
+			exit(1);
 		}
+		easm->binding_slots_capacity = capacity;
 	}
+	memset(easm->binding_slots, 0, sizeof(*easm->binding_slots) * capacity);
 
-	return false;
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		*easm_binding_slot(easm, easm->bindings[i].name) = i + 1;
+	}
+}
+
+bool easm_resolve_binding(const EASM *easm, String_View name, Binding *binding) {
+	if (easm->binding_slots_capacity == 0) return false;
+
+	const size_t *slot = easm_binding_slot(easm, name);
+	if (*slot == 0) return false;
+	if (binding) *binding = easm->bindings[*slot - 1];
+	return true;
 }
 
 bool easm_bind_value(EASM *easm, String_View name, Word word, Binding_Kind kind, File_Location location, Binding *existing_binding) {
-	assert(easm->bindings_size < EASM_BINDINGS_CAPACITY);
 	if (easm_resolve_binding(easm, name, existing_binding)) return false;
+	EASM_TABLE_RESERVE(easm->bindings, easm->bindings_size, easm->bindings_capacity, 1);
 	easm->bindings[easm->bindings_size++] = (Binding) {
 		.name = name,
 		.value = word,
 		.kind = kind,
 		.location = location,
 	};
+	if (easm->bindings_size * 2 + 2 > easm->binding_slots_capacity) {
+		easm_index_bindings(easm);
+	} else {
+		*easm_binding_slot(easm, name) = easm->bindings_size;
+	}
 	return true;
 }
 
 void easm_push_deferred_operand(EASM *easm, Inst_Addr addr, String_View label, File_Location location) {
-	assert(easm->deferred_operands_size < EASM_DEFERRED_OPERANDS_CAPACITY);
+	EASM_TABLE_RESERVE(easm->deferred_operands, easm->deferred_operands_size, easm->deferred_operands_capacity, 1);
 	easm->deferred_operands[easm->deferred_operands_size++] = (Deferred_Operand) {
 		.addr = addr,
 		.label = label,
@@ -1031,19 +1671,66 @@ void easm_push_deferred_operand(EASM *easm, Inst_Addr addr, String_View label, F
 	};
 }
 
-void easm_save_to_file(EASM *easm, const char *file_path) {
-	FILE *f = fopen(file_path, "wb");
-    	if (f == NULL) {
-        	fprintf(stderr, "ERROR: Could not open file `%s`: %s\n", file_path, strerror(errno));
-        	exit(1);
-    	}
+static bool easm_is_string_literal(String_View sv) {
+	return sv.count >= 2 && *sv.data == '"' && sv.data[sv.count - 1] == '"';
+}
 
-	Evm_File_Meta meta = {
+// NOTE: anything that is not a plain name goes through the constant expression evaluator
+static bool easm_is_expression(String_View sv) {
+	for (size_t i = 0; i < sv.count; ++i) {
+		if (sv.data[i] != '\0' && strchr("+-*/%&|^~()<> \t'\"", sv.data[i]) != NULL) return true;
+	}
+	return false;
+}
+
+void easm_push_relocation(EASM *easm, Reloc_Kind kind, Inst_Addr addr, String_View symbol, File_Location location) {
+	EASM_TABLE_RESERVE(easm->relocations, easm->relocations_size, easm->relocations_capacity, 1);
+	easm->relocations[easm->relocations_size++] = (Relocation) {
+		.kind = kind,
+		.addr = addr,
+		.symbol = symbol,
+		.location = location,
+	};
+}
+
+const char *reloc_kind_as_cstr(Reloc_Kind kind) {
+	switch (kind) {
+		case RELOC_CODE:	return "code";
+		case RELOC_DATA:	return "data";
+		case RELOC_SYMBOL:	return "symbol";
+		default: UNREACHABLE("NOT EXISTING RELOC_KIND");
+	}
+}
+
+// NOTE: the memory past the last nonzero byte is zero once loaded anyway, so the
+// files only keep what comes before it and #reserve costs nothing on disk
+static uint64_t easm_initialised_memory_size(const EASM *easm) {
+	uint64_t size = easm->memory_size;
+	while (size > 0 && easm->memory[size - 1] == 0) {
+		size -= 1;
+	}
+	return size;
+}
+
+void easm_save_to_file(EASM *easm, const char *file_path) {
+	// NOTE: easm grows the program as it needs, but the VM can only load this much
+	if (easm->program_size > EVM_PROGRAM_CAPACITY) {
+		fprintf(stderr, "ERROR: %s: program section is too big. The program contains %lu instructions. But the capacity is %lu\n", file_path, easm->program_size, (uint64_t) EVM_PROGRAM_CAPACITY);
+		exit(1);
+	}
+
+	FILE *f = fopen(file_path, "wb");
+    	if (f == NULL) {
+        	fprintf(stderr, "ERROR: Could not open file `%s`: %s\n", file_path, strerror(errno));
+        	exit(1);
+    	}
+
+	Evm_File_Meta meta = {
 		.magic = EVM_FILE_MAGIC,
 		.version = EVM_FILE_VERSION,
 		.program_size = easm->program_size,
 		.entry = easm->entry,
-		.memory_size = easm->memory_size,
+		.memory_size = easm_initialised_memory_size(easm),
 		.memory_capacity = easm->memory_capacity,
 	};
 
@@ -1059,7 +1746,7 @@ void easm_save_to_file(EASM *easm, const char *file_path) {
         	exit(1);
     	}
 
-    	fwrite(easm->memory, sizeof(easm->memory[0]), easm->memory_size, f);
+    	fwrite(easm->memory, sizeof(easm->memory[0]), meta.memory_size, f);
     	if (ferror(f)) {
         	fprintf(stderr, "ERROR: Could not write to file `%s`: %s\n", file_path, strerror(errno));
         	exit(1);
@@ -1068,16 +1755,273 @@ void easm_save_to_file(EASM *easm, const char *file_path) {
     	fclose(f);
 }
 
-void easm_translate_source(EASM *easm, String_View input_file_path) {
-	String_View original_source = arena_slurp_file(&easm->arena, input_file_path);
-	String_View source = original_source;
-	File_Location location = {
-        	.file_path = input_file_path,
-    	};
+void easm_save_symbols_to_file(EASM *easm, const char *file_path) {
+	FILE *f = fopen(file_path, "w");
+	if (f == NULL) {
+		fprintf(stderr, "ERROR: Could not open file `%s`: %s\n", file_path, strerror(errno));
+		exit(1);
+	}
 
-	// First pass
+	/*
+	* Note: This will dump out *ALL* symbols, no matter whether
+	* they are jump labels or not. However, since the
+	* preprocessor runs before the jump mark resolution, all the
+	* labels are allocated in a way that enables us to just
+	* overwrite prerocessor labels with a value equal to the
+	* address of a jump label.
+	*
+	*/
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		fprintf(f, "%lu \t"SV_Fmt"\n", easm->bindings[i].value.as_u64, SV_Arg(easm->bindings[i].name));
+	}
+
+	fclose(f);
+}
+
+static void easm_write_object_section(FILE *f, const char *file_path, const void *data, size_t size, size_t count) {
+	if (count == 0) return;
+
+	fwrite(data, size, count, f);
+	if (ferror(f)) {
+		fprintf(stderr, "ERROR: Could not write to file `%s`: %s\n", file_path, strerror(errno));
+		exit(1);
+	}
+}
+
+void easm_save_object_to_file(EASM *easm, const char *file_path) {
+	FILE *f = fopen(file_path, "wb");
+	if (f == NULL) {
+		fprintf(stderr, "ERROR: Could not open file `%s`: %s\n", file_path, strerror(errno));
+		exit(1);
+	}
+
+	uint64_t strings_size = 0;
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		strings_size += easm->bindings[i].name.count;
+	}
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		if (easm->relocations[i].kind == RELOC_SYMBOL) strings_size += easm->relocations[i].symbol.count;
+	}
+
+	Evm_Object_Meta meta = {
+		.magic = EVM_OBJECT_MAGIC,
+		.version = EVM_OBJECT_VERSION,
+		.program_size = easm->program_size,
+		.memory_size = easm_initialised_memory_size(easm),
+		.memory_capacity = easm->memory_capacity,
+		.has_entry = easm->has_entry,
+		.entry = easm->entry,
+		.bindings_size = easm->bindings_size,
+		.relocations_size = easm->relocations_size,
+		.strings_size = strings_size,
+	};
+
+	easm_write_object_section(f, file_path, &meta, sizeof(meta), 1);
+	easm_write_object_section(f, file_path, easm->program, sizeof(easm->program[0]), easm->program_size);
+	easm_write_object_section(f, file_path, easm->memory, sizeof(easm->memory[0]), meta.memory_size);
+
+	uint64_t offset = 0;
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		Evm_Object_Binding binding = {
+			.kind = (uint8_t) easm->bindings[i].kind,
+			.value = easm->bindings[i].value.as_u64,
+			.name_offset = offset,
+			.name_size = easm->bindings[i].name.count,
+		};
+		offset += binding.name_size;
+		easm_write_object_section(f, file_path, &binding, sizeof(binding), 1);
+	}
+
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		Evm_Object_Relocation relocation = {
+			.kind = (uint8_t) easm->relocations[i].kind,
+			.addr = easm->relocations[i].addr,
+			.symbol_offset = offset,
+			.symbol_size = easm->relocations[i].kind == RELOC_SYMBOL ? easm->relocations[i].symbol.count : 0,
+		};
+		offset += relocation.symbol_size;
+		easm_write_object_section(f, file_path, &relocation, sizeof(relocation), 1);
+	}
+
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		easm_write_object_section(f, file_path, easm->bindings[i].name.data, 1, easm->bindings[i].name.count);
+	}
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		if (easm->relocations[i].kind == RELOC_SYMBOL) {
+			easm_write_object_section(f, file_path, easm->relocations[i].symbol.data, 1, easm->relocations[i].symbol.count);
+		}
+	}
+
+	fclose(f);
+}
+
+static void easm_read_object_section(FILE *f, const char *file_path, void *data, size_t size, size_t count) {
+	if (count == 0) return;
+
+	if (fread(data, size, count, f) != count) {
+		fprintf(stderr, "ERROR: %s: object file is truncated\n", file_path);
+		exit(1);
+	}
+}
+
+void easm_load_object_from_file(EASM *easm, const char *file_path) {
+	FILE *f = fopen(file_path, "rb");
+	if (f == NULL) {
+		fprintf(stderr, "ERROR: Could not open file %s: %s\n", file_path, strerror(errno));
+		exit(1);
+	}
+
+	Evm_Object_Meta meta = { 0 };
+	easm_read_object_section(f, file_path, &meta, sizeof(meta), 1);
+
+	if (meta.magic != EVM_OBJECT_MAGIC) {
+		fprintf(stderr, "ERROR: %s does not appear to be a valid EVM object file. Unexpected magic %04X. Expected %04X.\n", file_path, meta.magic, EVM_OBJECT_MAGIC);
+		exit(1);
+	}
+
+	if (meta.version != EVM_OBJECT_VERSION) {
+		fprintf(stderr, "ERROR: %s: unsupported version of EVM object file %d. Expected version %d.\n", file_path, meta.version, EVM_OBJECT_VERSION);
+		exit(1);
+	}
+
+	EASM_TABLE_RESERVE(easm->program, easm->program_size, easm->program_capacity, meta.program_size);
+	easm_read_object_section(f, file_path, easm->program, sizeof(easm->program[0]), meta.program_size);
+	easm->program_size = meta.program_size;
+
+	EASM_TABLE_RESERVE(easm->memory, easm->memory_size, easm->memory_allocated, meta.memory_size);
+	easm_read_object_section(f, file_path, easm->memory, sizeof(easm->memory[0]), meta.memory_size);
+	easm->memory_size = meta.memory_size;
+	easm->memory_capacity = meta.memory_capacity;
+
+	easm->has_entry = meta.has_entry != 0;
+	easm->entry = meta.entry;
+
+	Evm_Object_Binding *bindings = malloc(sizeof(*bindings) * meta.bindings_size + 1);
+	Evm_Object_Relocation *relocations = malloc(sizeof(*relocations) * meta.relocations_size + 1);
+	char *strings = arena_alloc(&easm->arena, meta.strings_size);
+	if (bindings == NULL || relocations == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for object file %s: %s\n", file_path, strerror(errno));
+		exit(1);
+	}
+
+	easm_read_object_section(f, file_path, bindings, sizeof(*bindings), meta.bindings_size);
+	easm_read_object_section(f, file_path, relocations, sizeof(*relocations), meta.relocations_size);
+	easm_read_object_section(f, file_path, strings, 1, meta.strings_size);
+
+	const File_Location location = {
+		.file_path = sv_from_cstr(arena_sv_to_cstr(&easm->arena, sv_from_cstr(file_path))),
+	};
+
+	for (size_t i = 0; i < meta.bindings_size; ++i) {
+		if (bindings[i].kind > BINDING_DATA || bindings[i].name_offset + bindings[i].name_size > meta.strings_size) {
+			fprintf(stderr, "ERROR: %s: binding %zu is corrupted\n", file_path, i);
+			exit(1);
+		}
+
+		String_View name = {
+			.count = bindings[i].name_size,
+			.data = strings + bindings[i].name_offset,
+		};
+
+		Binding existing = { 0 };
+		if (!easm_bind_value(easm, name, word_u64(bindings[i].value), (Binding_Kind) bindings[i].kind, location, &existing)) {
+			fprintf(stderr, "ERROR: %s: name `"SV_Fmt"` is bound twice\n", file_path, SV_Arg(name));
+			exit(1);
+		}
+	}
+
+	for (size_t i = 0; i < meta.relocations_size; ++i) {
+		if (relocations[i].kind > RELOC_SYMBOL
+			|| relocations[i].addr >= meta.program_size
+			|| relocations[i].symbol_offset + relocations[i].symbol_size > meta.strings_size) {
+			fprintf(stderr, "ERROR: %s: relocation %zu is corrupted\n", file_path, i);
+			exit(1);
+		}
+
+		String_View symbol = {
+			.count = relocations[i].symbol_size,
+			.data = strings + relocations[i].symbol_offset,
+		};
+
+		easm_push_relocation(easm, (Reloc_Kind) relocations[i].kind, relocations[i].addr, symbol, location);
+	}
+
+	free(bindings);
+	free(relocations);
+	fclose(f);
+}
+
+void easm_add_include_path(EASM *easm, String_View path) {
+	EASM_TABLE_RESERVE(easm->include_paths, easm->include_paths_size, easm->include_paths_capacity, 1);
+	easm->include_paths[easm->include_paths_size++] = path;
+}
+
+static bool easm_file_exists(EASM *easm, String_View path) {
+	FILE *f = fopen(arena_sv_to_cstr(&easm->arena, path), "r");
+	if (f == NULL) return false;
+	fclose(f);
+	return true;
+}
+
+static String_View easm_join_path(EASM *easm, String_View dir, String_View path) {
+	const size_t sep_count = (dir.count > 0 && dir.data[dir.count - 1] != '/') ? 1 : 0;
+	const size_t count = dir.count + sep_count + path.count;
+	char *buffer = arena_alloc(&easm->arena, count);
+	memcpy(buffer, dir.data, dir.count);
+	if (sep_count > 0) buffer[dir.count] = '/';
+	memcpy(buffer + dir.count + sep_count, path.data, path.count);
+	return (String_View) {
+		.count = count,
+		.data = buffer,
+	};
+}
+
+bool easm_resolve_include_path(EASM *easm, String_View includer_path, String_View path, String_View *resolved) {
+	if (path.count > 0 && path.data[0] == '/') {
+		*resolved = path;
+		return easm_file_exists(easm, path);
+	}
+
+	// Next to the file that includes it
+	size_t dir_count = includer_path.count;
+	while (dir_count > 0 && includer_path.data[dir_count - 1] != '/') {
+		dir_count -= 1;
+	}
+	if (dir_count > 0) {
+		*resolved = easm_join_path(easm, (String_View) { .count = dir_count, .data = includer_path.data }, path);
+		if (easm_file_exists(easm, *resolved)) return true;
+	}
+
+	// Search paths in the order they were provided
+	for (size_t i = 0; i < easm->include_paths_size; ++i) {
+		*resolved = easm_join_path(easm, easm->include_paths[i], path);
+		if (easm_file_exists(easm, *resolved)) return true;
+	}
+
+	// NOTE: Relative to the working directory, that is how easm always resolved includes
+	*resolved = path;
+	return easm_file_exists(easm, path);
+}
+
+bool easm_canonical_path(EASM *easm, String_View path, String_View *canonical) {
+	const char *path_cstr = arena_sv_to_cstr(&easm->arena, path);
+#ifdef _WIN32
+	char *result = _fullpath(NULL, path_cstr, 0);
+#else
+	char *result = realpath(path_cstr, NULL);
+#endif // _WIN32
+	if (result == NULL) return false;
+
+	*canonical = sv_from_cstr(arena_sv_to_cstr(&easm->arena, sv_from_cstr(result)));
+	free(result);
+	return true;
+}
+
+// NOTE: `location` is the line right before the first one of `source`
+static void easm_translate_lines(EASM *easm, String_View source, File_Location location) {
 	while (source.count > 0) {
-		String_View line = sv_trim(sv_chop_by_delim(&source, '\n'));
+		// NOTE: the comment is cut off before trimming, so every line is trimmed only once
+		String_View line = sv_chop_by_delim(&source, '\n');
 		line = sv_trim(sv_chop_by_delim(&line, EASM_COMMENT_CHAR));
 		location.line_number += 1;
 		if (line.count > 0) {
@@ -1092,23 +2036,57 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
 					String_View label = sv_chop_by_delim(&line, ' ');
 					if (label.count > 0) {
 						line = sv_trim(line);
-						String_View value = line;
-						Word word = { 0 };
-						if (!easm_translate_literal(easm, value, &word)) {
-							fprintf(stderr, FL_Fmt": ERROR: unknown pre-processor directive '"SV_Fmt"'\n", FL_Arg(location), SV_Arg(value));
+						if (line.count == 0) {
+							fprintf(stderr, FL_Fmt": ERROR: value of '"SV_Fmt"' is not provided\n", FL_Arg(location), SV_Arg(label));
 							exit(1);
 						}
 
+						// NOTE: names in the expression have to be bound before the #const
+						const Expr_Value value = easm_eval_expr(easm, line, location);
+
+						// NOTE: addresses in the program and in the memory stay addresses, the linker has to move them
+						Binding_Kind kind = BINDING_CONST;
+						Reloc_Kind reloc_kind = RELOC_CODE;
+						if (easm_expr_relocation(easm, value, location, &reloc_kind)) {
+							kind = reloc_kind == RELOC_CODE ? BINDING_LABEL : BINDING_DATA;
+						}
+
 						Binding existing = {0};
-                        			if (!easm_bind_value(easm, label, word, BINDING_CONST, location, &existing)) {
+                        			if (!easm_bind_value(easm, label, value.value, kind, location, &existing)) {
 							fprintf(stderr, FL_Fmt": ERROR: label '"SV_Fmt"' is allready define\n", FL_Arg(location), SV_Arg(label));
 	                    				fprintf(stderr, FL_Fmt": NOTE: first binding is located here\n", FL_Arg(existing.location));
 							exit(1);
 						}
+						easm->bindings[easm->bindings_size - 1].is_float = value.is_float;
+						easm->bindings[easm->bindings_size - 1].size = value.size;
 					} else {
 						fprintf(stderr, FL_Fmt": ERROR: label name in not provided\n", FL_Arg(location));
 						exit(1);
 					}
+				} else if (sv_eq(token, sv_from_cstr("reserve"))) {
+					line = sv_trim(line);
+					String_View name = sv_chop_by_delim(&line, ' ');
+					line = sv_trim(line);
+					if (name.count == 0 || line.count == 0) {
+						fprintf(stderr, FL_Fmt": ERROR: usage: #reserve <name> <size>\n", FL_Arg(location));
+						exit(1);
+					}
+
+					const Expr_Value size = easm_eval_expr(easm, line, location);
+					if (size.is_float || size.code_refs != 0 || size.data_refs != 0
+						|| size.value.as_i64 <= 0 || size.value.as_u64 > EVM_MEMORY_CAPACITY) {
+						fprintf(stderr, FL_Fmt": ERROR: size of '"SV_Fmt"' has to be a number between 1 and %lu\n", FL_Arg(location), SV_Arg(name), (uint64_t) EVM_MEMORY_CAPACITY);
+						exit(1);
+					}
+
+					const Word addr = easm_reserve_memory(easm, size.value.as_u64);
+					Binding existing = {0};
+					if (!easm_bind_value(easm, name, addr, BINDING_DATA, location, &existing)) {
+						fprintf(stderr, FL_Fmt": ERROR: label '"SV_Fmt"' is allready define\n", FL_Arg(location), SV_Arg(name));
+						fprintf(stderr, FL_Fmt": NOTE: first binding is located here\n", FL_Arg(existing.location));
+						exit(1);
+					}
+					easm->bindings[easm->bindings_size - 1].size = size.value.as_u64;
 				} else if (sv_eq(token, sv_from_cstr("native"))) {
                     			line = sv_trim(line);
                     			String_View name = sv_chop_by_delim(&line, ' ');
@@ -1143,8 +2121,14 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
 								exit(1);
 							}
 
+							String_View include_path = { 0 };
+							if (!easm_resolve_include_path(easm, location.file_path, line, &include_path)) {
+								fprintf(stderr, FL_Fmt": ERROR: could not find include file `"SV_Fmt"`\n", FL_Arg(location), SV_Arg(line));
+								exit(1);
+							}
+
 							easm->include_level += 1;
-							easm_translate_source(easm, line);
+							easm_translate_source(easm, include_path);
 							easm->include_level -= 1;
 						} else {
 							fprintf(stderr, FL_Fmt": ERROR: path must be surrounded by quotation marks\n", FL_Arg(location));
@@ -1167,16 +2151,21 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
 						exit(1);
 					}
 
+					// NOTE: a number is not an address the optimizer or the linker could follow
 					Word entry = { 0 };
-
-					if (!easm_translate_literal(easm, line, &entry)) {
-						easm->deferred_entry_binding_name = line;
-					} else {
-						easm->entry = entry.as_u64;
+					if (easm_translate_literal(easm, line, &entry)) {
+						fprintf(stderr, FL_Fmt": ERROR: trying to set the number '"SV_Fmt"' as an entry point. Entry point has to be a label.\n", FL_Arg(location), SV_Arg(line));
+						exit(1);
 					}
+					easm->deferred_entry_binding_name = line;
 
 					easm->has_entry = true;
 					easm->entry_location = location;
+				} else if (sv_eq(token, sv_from_cstr("macro"))) {
+					easm_define_macro(easm, line, &source, &location);
+				} else if (sv_eq(token, sv_from_cstr("endmacro"))) {
+					fprintf(stderr, FL_Fmt": ERROR: #endmacro without #macro\n", FL_Arg(location));
+					exit(1);
 			 	} else {
 					fprintf(stderr, FL_Fmt": ERROR: unknown pre-processor directive '"SV_Fmt"'\n", FL_Arg(location), SV_Arg(token));
 					exit(1);
@@ -1204,8 +2193,12 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
 
 					Inst_Type inst_type = INST_NOP;
 					if (inst_by_name(token, &inst_type)) {
-						assert(easm->program_size < EVM_PROGRAM_CAPACITY);
-						easm->program[easm->program_size].type = inst_type;
+						EASM_TABLE_RESERVE(easm->program, easm->program_size, easm->program_capacity, 1);
+						EASM_TABLE_RESERVE(easm->locations, easm->program_size, easm->locations_capacity, 1);
+						easm->locations[easm->program_size] = location;
+						// NOTE: the operand of an instruction without one is zero, so the same source
+						// always makes the same program
+						easm->program[easm->program_size] = (Inst) { .type = inst_type };
 						if (inst_has_operand(inst_type)) {
 							if (operand.count == 0) {
 								fprintf(stderr, FL_Fmt": ERROR: instruction '"SV_Fmt"' requires an operand\n", FL_Arg(location), SV_Arg(token));
@@ -1213,24 +2206,274 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
 							}
 							if (!easm_translate_literal(easm, operand, &easm->program[easm->program_size].operand)) {
 								easm_push_deferred_operand(easm, easm->program_size, operand, location);
+							} else if (easm_is_string_literal(operand)) {
+								easm_push_relocation(easm, RELOC_DATA, easm->program_size, operand, location);
 							}
 						}
 						easm->program_size += 1;
 					} else {
-						fprintf(stderr, FL_Fmt": ERROR: unknown instruction '"SV_Fmt"'\n", FL_Arg(location), SV_Arg(token));
-						exit(1);
+						Macro *macro = easm_find_macro(easm, token);
+						if (macro == NULL) {
+							fprintf(stderr, FL_Fmt": ERROR: unknown instruction '"SV_Fmt"'\n", FL_Arg(location), SV_Arg(token));
+							exit(1);
+						}
+						easm_expand_macro(easm, macro, operand, location);
 					}
 				}
 			}
 		}
 	}
+}
+
+Macro *easm_find_macro(EASM *easm, String_View name) {
+	for (size_t i = 0; i < easm->macros_size; ++i) {
+		if (sv_eq(easm->macros[i].name, name)) {
+			return &easm->macros[i];
+		}
+	}
+	return NULL;
+}
+
+// NOTE: splits by whitespaces, but keeps character and string literals whole
+static String_View easm_chop_macro_word(String_View *sv) {
+	*sv = sv_trim_left(*sv);
+	size_t i = 0;
+	while (i < sv->count && !isspace(sv->data[i])) {
+		if (sv->data[i] == '"' || sv->data[i] == '\'') {
+			const char quote = sv->data[i++];
+			while (i < sv->count && sv->data[i] != quote) i += 1;
+		}
+		if (i < sv->count) i += 1;
+	}
+
+	String_View result = { .count = i, .data = sv->data };
+	sv->count -= i;
+	sv->data += i;
+	return result;
+}
+
+static bool easm_is_macro_name_char(char c) {
+	return isalnum((unsigned char) c) || c == '_';
+}
+
+void easm_define_macro(EASM *easm, String_View header, String_View *source, File_Location *location) {
+	Macro macro = { .location = *location };
+
+	macro.name = easm_chop_macro_word(&header);
+	if (macro.name.count == 0) {
+		fprintf(stderr, FL_Fmt": ERROR: macro name is not provided\n", FL_Arg((*location)));
+		exit(1);
+	}
+
+	Inst_Type inst_type = INST_NOP;
+	if (inst_by_name(macro.name, &inst_type)) {
+		fprintf(stderr, FL_Fmt": ERROR: macro `"SV_Fmt"` shadows an instruction\n", FL_Arg((*location)), SV_Arg(macro.name));
+		exit(1);
+	}
+
+	Macro *existing = easm_find_macro(easm, macro.name);
+	if (existing != NULL) {
+		fprintf(stderr, FL_Fmt": ERROR: macro `"SV_Fmt"` is already defined\n", FL_Arg((*location)), SV_Arg(macro.name));
+		fprintf(stderr, FL_Fmt": NOTE: first definition is located here\n", FL_Arg(existing->location));
+		exit(1);
+	}
+
+	// NOTE: every parameter takes at least two characters of the header
+	macro.params = arena_alloc(&easm->arena, sizeof(*macro.params) * (header.count / 2 + 1));
+	for (String_View param = easm_chop_macro_word(&header); param.count > 0; param = easm_chop_macro_word(&header)) {
+		macro.params[macro.params_size++] = param;
+	}
+
+	// NOTE: the body is kept raw and translated on every expansion
+	macro.body.data = source->data;
+	bool terminated = false;
+	size_t locals_capacity = 0;
+	while (source->count > 0) {
+		const char *line_start = source->data;
+		String_View line = sv_chop_by_delim(source, '\n');
+		location->line_number += 1;
+		line = sv_trim(sv_chop_by_delim(&line, EASM_COMMENT_CHAR));
+
+		String_View token = sv_trim(sv_chop_by_delim(&line, ' '));
+		if (sv_eq(token, sv_from_cstr("#endmacro"))) {
+			macro.body.count = (size_t) (line_start - macro.body.data);
+			terminated = true;
+			break;
+		}
+
+		if (sv_eq(token, sv_from_cstr("#macro"))) {
+			fprintf(stderr, FL_Fmt": ERROR: macros can not be defined inside of other macros\n", FL_Arg((*location)));
+			fprintf(stderr, FL_Fmt": NOTE: macro `"SV_Fmt"` starts here\n", FL_Arg(macro.location), SV_Arg(macro.name));
+			exit(1);
+		}
+
+		if (token.count > 1 && token.data[token.count - 1] == ':') {
+			EASM_TABLE_RESERVE(macro.locals, macro.locals_size, locals_capacity, 1);
+			macro.locals[macro.locals_size++] = (String_View) { .count = token.count - 1, .data = token.data };
+		}
+	}
+
+	if (!terminated) {
+		fprintf(stderr, FL_Fmt": ERROR: macro `"SV_Fmt"` is not terminated with #endmacro\n", FL_Arg(macro.location), SV_Arg(macro.name));
+		exit(1);
+	}
+
+	// NOTE: keep the locals in the arena, like the rest of the macro
+	if (macro.locals_size > 0) {
+		String_View *locals = arena_alloc(&easm->arena, sizeof(*locals) * macro.locals_size);
+		memcpy(locals, macro.locals, sizeof(*locals) * macro.locals_size);
+		free(macro.locals);
+		macro.locals = locals;
+	}
+
+	EASM_TABLE_RESERVE(easm->macros, easm->macros_size, easm->macros_capacity, 1);
+	easm->macros[easm->macros_size++] = macro;
+}
+
+void easm_expand_macro(EASM *easm, Macro *macro, String_View args, File_Location location) {
+	String_View *values = arena_alloc(&easm->arena, sizeof(*values) * (macro->params_size + 1));
+	size_t values_size = 0;
+	for (String_View arg = easm_chop_macro_word(&args); arg.count > 0; arg = easm_chop_macro_word(&args)) {
+		if (values_size >= macro->params_size) {
+			values_size += 1;
+			break;
+		}
+		values[values_size++] = arg;
+	}
+
+	if (values_size != macro->params_size) {
+		fprintf(stderr, FL_Fmt": ERROR: macro `"SV_Fmt"` expects %zu arguments\n", FL_Arg(location), SV_Arg(macro->name), macro->params_size);
+		fprintf(stderr, FL_Fmt": NOTE: macro `"SV_Fmt"` is defined here\n", FL_Arg(macro->location), SV_Arg(macro->name));
+		exit(1);
+	}
+
+	if (easm->macro_level + 1 >= EASM_MAX_MACRO_LEVEL) {
+		fprintf(stderr, FL_Fmt": ERROR: exceeded maximum macro expansion level\n", FL_Arg(location));
+		exit(1);
+	}
+
+	// NOTE: locals of the expansion are renamed to `local@macro.N`
+	char counter[32];
+	const size_t counter_size = (size_t) snprintf(counter, sizeof(counter), ".%zu", macro->expansions++);
+
+	char *text = NULL;
+	size_t text_size = 0;
+	size_t text_capacity = 0;
+
+	const String_View body = macro->body;
+	size_t i = 0;
+	while (i < body.count) {
+		const char c = body.data[i];
+		size_t start = i;
+
+		if (c == '"' || c == '\'') {
+			i += 1;
+			while (i < body.count && body.data[i] != c && body.data[i] != '\n') i += 1;
+			if (i < body.count && body.data[i] == c) i += 1;
+		} else if (c == EASM_COMMENT_CHAR) {
+			while (i < body.count && body.data[i] != '\n') i += 1;
+		} else if (easm_is_macro_name_char(c)) {
+			while (i < body.count && easm_is_macro_name_char(body.data[i])) i += 1;
+
+			const String_View word = { .count = i - start, .data = body.data + start };
+			String_View replacement = word;
+			bool is_local = false;
+
+			for (size_t j = 0; j < macro->params_size; ++j) {
+				if (sv_eq(word, macro->params[j])) {
+					replacement = values[j];
+					break;
+				}
+			}
+			for (size_t j = 0; j < macro->locals_size; ++j) {
+				if (sv_eq(word, macro->locals[j])) {
+					is_local = true;
+					break;
+				}
+			}
+
+			EASM_TABLE_RESERVE(text, text_size, text_capacity, replacement.count + 1 + macro->name.count + counter_size);
+			memcpy(text + text_size, replacement.data, replacement.count);
+			text_size += replacement.count;
+			if (is_local) {
+				text[text_size++] = '@';
+				memcpy(text + text_size, macro->name.data, macro->name.count);
+				text_size += macro->name.count;
+				memcpy(text + text_size, counter, counter_size);
+				text_size += counter_size;
+			}
+			continue;
+		} else {
+			i += 1;
+		}
+
+		EASM_TABLE_RESERVE(text, text_size, text_capacity, i - start);
+		memcpy(text + text_size, body.data + start, i - start);
+		text_size += i - start;
+	}
+
+	String_View expansion = { .count = text_size, .data = NULL };
+	if (text_size > 0) {
+		char *data = arena_alloc(&easm->arena, text_size);
+		memcpy(data, text, text_size);
+		expansion.data = data;
+	}
+	free(text);
+
+	easm->macro_level += 1;
+	easm_translate_lines(easm, expansion, macro->location);
+	easm->macro_level -= 1;
+}
+
+void easm_translate_source(EASM *easm, String_View input_file_path) {
+	String_View canonical_path = { 0 };
+	if (!easm_canonical_path(easm, input_file_path, &canonical_path)) {
+		fprintf(stderr, "Could not open file "SV_Fmt": %s\n", SV_Arg(input_file_path), strerror(errno));
+		exit(1);
+	}
+
+	for (size_t i = 0; i < easm->included_files_size; ++i) {
+		if (sv_eq(easm->included_files[i], canonical_path)) return;
+	}
+	EASM_TABLE_RESERVE(easm->included_files, easm->included_files_size, easm->included_files_capacity, 1);
+	easm->included_files[easm->included_files_size++] = canonical_path;
+
+	String_View source = arena_slurp_file(&easm->arena, input_file_path);
+	easm->source_size += source.count;
+
+	// First pass
+	easm_translate_lines(easm, source, (File_Location) { .file_path = input_file_path });
+
+	// NOTE: Included files may refer to labels defined later by the file that includes
+	// them, so the rest is done once, when the outermost file is over.
+	if (easm->include_level > 0) return;
 
 	// Second pass
 	for (size_t i = 0; i < easm->deferred_operands_size; ++i) {
 		String_View label = easm->deferred_operands[i].label;
 		Inst_Addr addr = easm->deferred_operands[i].addr;
 		Binding binding = {0};
-		if (!easm_resolve_binding(easm, label, &binding)) {
+		Expr_Value value = {0};
+		const bool is_resolved = easm_resolve_binding(easm, label, &binding);
+		const bool is_expression = !is_resolved && easm_is_expression(label);
+		if (is_expression) {
+			value = easm_eval_expr(easm, label, easm->deferred_operands[i].location);
+			// NOTE: an expression is a label only when it is the address of one plus an offset,
+			// natives can not be used in expressions at all
+			binding.value = value.value;
+			if (!value.is_float && !value.is_scaled && value.data_refs == 0 && value.code_refs == 1) {
+				binding.kind = BINDING_LABEL;
+			} else if (!value.is_float && !value.is_scaled && value.code_refs == 0 && value.data_refs == 1) {
+				binding.kind = BINDING_DATA;
+			} else {
+				binding.kind = BINDING_CONST;
+			}
+		} else if (!is_resolved) {
+			if (easm->is_object) {
+				easm_push_relocation(easm, RELOC_SYMBOL, addr, label, easm->deferred_operands[i].location);
+				continue;
+			}
+
 			fprintf(stderr, FL_Fmt": ERROR: unknown label '"SV_Fmt"'\n", FL_Arg(easm->deferred_operands[i].location), SV_Arg(label));
 			exit(1);
 		}
@@ -1246,12 +2489,28 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
        	 	}
 
 		easm->program[addr].operand = binding.value;
+
+		if (is_expression) {
+			Reloc_Kind kind = RELOC_CODE;
+			if (easm_expr_relocation(easm, value, easm->deferred_operands[i].location, &kind)) {
+				easm_push_relocation(easm, kind, addr, label, easm->deferred_operands[i].location);
+			}
+		} else if (binding.kind == BINDING_LABEL) {
+			easm_push_relocation(easm, RELOC_CODE, addr, label, easm->deferred_operands[i].location);
+		} else if (binding.kind == BINDING_DATA) {
+			easm_push_relocation(easm, RELOC_DATA, addr, label, easm->deferred_operands[i].location);
+		}
 	}
 
 	// Resolving deferred entry point
 	if (easm->has_entry && easm->deferred_entry_binding_name.count > 0) {
 		Binding binding = {0};
-		if (!easm_resolve_binding(easm, easm->deferred_entry_binding_name, &binding)) {
+		if (easm_is_expression(easm->deferred_entry_binding_name)) {
+			const Expr_Value value = easm_eval_expr(easm, easm->deferred_entry_binding_name, easm->entry_location);
+			binding.value = value.value;
+			const bool is_address = !value.is_float && !value.is_scaled && value.data_refs == 0 && value.code_refs == 1;
+			binding.kind = is_address ? BINDING_LABEL : BINDING_CONST;
+		} else if (!easm_resolve_binding(easm, easm->deferred_entry_binding_name, &binding)) {
 			fprintf(stderr, FL_Fmt": ERROR: unknown label '"SV_Fmt"'\n", FL_Arg(easm->entry_location), SV_Arg(easm->deferred_entry_binding_name));
 			exit(1);
 		}
@@ -1265,25 +2524,1871 @@ void easm_translate_source(EASM *easm, String_View input_file_path) {
 	}
 }
 
-Word easm_push_string_to_memory(EASM *easm, String_View sv) {
-    assert(easm->memory_size + sv.count <= EVM_MEMORY_CAPACITY);
+// Optimizer
 
-    Word result = word_u64(easm->memory_size);
-    memcpy(easm->memory + easm->memory_size, sv.data, sv.count);
-    easm->memory_size += sv.count;
+#define EASM_NO_RELOC -1
 
-    if (easm->memory_size > easm->memory_capacity) {
+bool easm_inst_has_code_operand(Inst_Type type) {
+	return type == INST_JMP || inst_is_conditional_jump(type) || type == INST_CALL;
+}
+
+// NOTE: folds `push a; push b; <inst>` the same way the VM would execute it
+static bool easm_fold_binary(Inst_Type type, Word a, Word b, Word *result) {
+	switch (type) {
+		case INST_PLUSI:	result->as_u64 = a.as_u64 + b.as_u64; return true;
+		case INST_MINUSI:	result->as_u64 = a.as_u64 - b.as_u64; return true;
+		case INST_MULTI:	result->as_i64 = a.as_i64 * b.as_i64; return true;
+		case INST_MULTU:	result->as_u64 = a.as_u64 * b.as_u64; return true;
+		case INST_DIVI:
+			if (b.as_i64 == 0) return false;
+			// NOTE: INT64_MIN / -1 wraps around in the VM, the host would trap on it
+			if (b.as_i64 == -1) {
+				result->as_u64 = 0 - a.as_u64;
+			} else {
+				result->as_i64 = a.as_i64 / b.as_i64;
+			}
+			return true;
+		case INST_MODI:
+			if (b.as_i64 == 0) return false;
+			result->as_i64 = b.as_i64 == -1 ? 0 : a.as_i64 % b.as_i64;
+			return true;
+		case INST_DIVU:
+			if (b.as_u64 == 0) return false;
+			result->as_u64 = a.as_u64 / b.as_u64;
+			return true;
+		case INST_MODU:
+			if (b.as_u64 == 0) return false;
+			result->as_u64 = a.as_u64 % b.as_u64;
+			return true;
+		case INST_PLUSF:	result->as_f64 = a.as_f64 + b.as_f64; return true;
+		case INST_MINUSF:	result->as_f64 = a.as_f64 - b.as_f64; return true;
+		case INST_MULTF:	result->as_f64 = a.as_f64 * b.as_f64; return true;
+		case INST_DIVF:		result->as_f64 = a.as_f64 / b.as_f64; return true;
+		case INST_EQI:		result->as_u64 = a.as_i64 == b.as_i64; return true;
+		case INST_GEI:		result->as_u64 = a.as_i64 >= b.as_i64; return true;
+		case INST_GTI:		result->as_u64 = a.as_i64 > b.as_i64; return true;
+		case INST_LEI:		result->as_u64 = a.as_i64 <= b.as_i64; return true;
+		case INST_LTI:		result->as_u64 = a.as_i64 < b.as_i64; return true;
+		case INST_NEI:		result->as_u64 = a.as_i64 != b.as_i64; return true;
+		case INST_EQU:		result->as_u64 = a.as_u64 == b.as_u64; return true;
+		case INST_GEU:		result->as_u64 = a.as_u64 >= b.as_u64; return true;
+		case INST_GTU:		result->as_u64 = a.as_u64 > b.as_u64; return true;
+		case INST_LEU:		result->as_u64 = a.as_u64 <= b.as_u64; return true;
+		case INST_LTU:		result->as_u64 = a.as_u64 < b.as_u64; return true;
+		case INST_NEU:		result->as_u64 = a.as_u64 != b.as_u64; return true;
+		case INST_EQF:		result->as_u64 = a.as_f64 == b.as_f64; return true;
+		case INST_GEF:		result->as_u64 = a.as_f64 >= b.as_f64; return true;
+		case INST_GTF:		result->as_u64 = a.as_f64 > b.as_f64; return true;
+		case INST_LEF:		result->as_u64 = a.as_f64 <= b.as_f64; return true;
+		case INST_LTF:		result->as_u64 = a.as_f64 < b.as_f64; return true;
+		case INST_NEF:		result->as_u64 = a.as_f64 != b.as_f64; return true;
+		case INST_ANDB:		result->as_u64 = a.as_u64 & b.as_u64; return true;
+		case INST_ORB:		result->as_u64 = a.as_u64 | b.as_u64; return true;
+		case INST_XOR:		result->as_u64 = a.as_u64 ^ b.as_u64; return true;
+		case INST_SHR:
+			if (b.as_u64 >= 64) return false;
+			result->as_u64 = a.as_u64 >> b.as_u64;
+			return true;
+		case INST_SHL:
+			if (b.as_u64 >= 64) return false;
+			result->as_u64 = a.as_u64 << b.as_u64;
+			return true;
+		case INST_NOP:
+		case INST_PUSH:
+		case INST_DROP:
+		case INST_DUP:
+		case INST_SWAP:
+		case INST_JMP:
+		case INST_JMP_IF:
+		case INST_RET:
+		case INST_CALL:
+		case INST_NATIVE:
+		case INST_NOT:
+		case INST_NOTB:
+		case INST_READ8:
+		case INST_READ16:
+		case INST_READ32:
+		case INST_READ64:
+		case INST_WRITE8:
+		case INST_WRITE16:
+		case INST_WRITE32:
+		case INST_WRITE64:
+		case INST_I2F:
+		case INST_U2F:
+		case INST_F2I:
+		case INST_F2U:
+		case INST_HALT:
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM:
+		case INST_EQI_IMM:
+		case INST_JMP_IF_NOT:
+		case INST_JMP_IF_ZERO:
+		case INST_JMP_LTI:
+		case INST_LOCAL_GET:
+		case INST_LOCAL_SET:
+		case INST_ARG_GET:
+		case INST_ARG_SET:
+		case INST_BREAKPOINT:
+		case EASM_NUMBER_OF_INSTS:
+		default: return false;
+	}
+}
+
+static bool easm_fold_unary(Inst_Type type, Word a, Word *result) {
+	switch (type) {
+		case INST_NOT:	result->as_u64 = !a.as_u64; return true;
+		case INST_NOTB:	result->as_u64 = ~a.as_u64; return true;
+		case INST_I2F:	result->as_f64 = (double) a.as_i64; return true;
+		case INST_U2F:	result->as_f64 = (double) a.as_u64; return true;
+		case INST_NOP:
+		case INST_PUSH:
+		case INST_DROP:
+		case INST_DUP:
+		case INST_SWAP:
+		case INST_PLUSI:
+		case INST_MINUSI:
+		case INST_MULTI:
+		case INST_DIVI:
+		case INST_MODI:
+		case INST_MULTU:
+		case INST_DIVU:
+		case INST_MODU:
+		case INST_PLUSF:
+		case INST_MINUSF:
+		case INST_MULTF:
+		case INST_DIVF:
+		case INST_JMP:
+		case INST_JMP_IF:
+		case INST_RET:
+		case INST_CALL:
+		case INST_NATIVE:
+		case INST_EQI:
+		case INST_GEI:
+		case INST_GTI:
+		case INST_LEI:
+		case INST_LTI:
+		case INST_NEI:
+		case INST_EQF:
+		case INST_GEF:
+		case INST_GTF:
+		case INST_LEF:
+		case INST_LTF:
+		case INST_NEF:
+		case INST_EQU:
+		case INST_GEU:
+		case INST_GTU:
+		case INST_LEU:
+		case INST_LTU:
+		case INST_NEU:
+		case INST_ANDB:
+		case INST_ORB:
+		case INST_XOR:
+		case INST_SHR:
+		case INST_SHL:
+		case INST_READ8:
+		case INST_READ16:
+		case INST_READ32:
+		case INST_READ64:
+		case INST_WRITE8:
+		case INST_WRITE16:
+		case INST_WRITE32:
+		case INST_WRITE64:
+		case INST_F2I:
+		case INST_F2U:
+		case INST_HALT:
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM:
+		case INST_EQI_IMM:
+		case INST_JMP_IF_NOT:
+		case INST_JMP_IF_ZERO:
+		case INST_JMP_LTI:
+		case INST_LOCAL_GET:
+		case INST_LOCAL_SET:
+		case INST_ARG_GET:
+		case INST_ARG_SET:
+		case INST_BREAKPOINT:
+		case EASM_NUMBER_OF_INSTS:
+		default: return false;
+	}
+}
+
+// NOTE: `push 0; plusi` and friends do nothing
+static bool easm_is_identity(Inst_Type type, Word operand) {
+	switch (type) {
+		case INST_PLUSI:
+		case INST_MINUSI:
+		case INST_ORB:
+		case INST_XOR:
+		case INST_SHR:
+		case INST_SHL:
+			return operand.as_u64 == 0;
+		case INST_MULTI:
+		case INST_MULTU:
+		case INST_DIVI:
+		case INST_DIVU:
+			return operand.as_u64 == 1;
+		case INST_NOP:
+		case INST_PUSH:
+		case INST_DROP:
+		case INST_DUP:
+		case INST_SWAP:
+		case INST_MODI:
+		case INST_MODU:
+		case INST_PLUSF:
+		case INST_MINUSF:
+		case INST_MULTF:
+		case INST_DIVF:
+		case INST_JMP:
+		case INST_JMP_IF:
+		case INST_RET:
+		case INST_CALL:
+		case INST_NATIVE:
+		case INST_NOT:
+		case INST_EQI:
+		case INST_GEI:
+		case INST_GTI:
+		case INST_LEI:
+		case INST_LTI:
+		case INST_NEI:
+		case INST_EQF:
+		case INST_GEF:
+		case INST_GTF:
+		case INST_LEF:
+		case INST_LTF:
+		case INST_NEF:
+		case INST_EQU:
+		case INST_GEU:
+		case INST_GTU:
+		case INST_LEU:
+		case INST_LTU:
+		case INST_NEU:
+		case INST_ANDB:
+		case INST_NOTB:
+		case INST_READ8:
+		case INST_READ16:
+		case INST_READ32:
+		case INST_READ64:
+		case INST_WRITE8:
+		case INST_WRITE16:
+		case INST_WRITE32:
+		case INST_WRITE64:
+		case INST_I2F:
+		case INST_U2F:
+		case INST_F2I:
+		case INST_F2U:
+		case INST_HALT:
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM:
+		case INST_EQI_IMM:
+		case INST_JMP_IF_NOT:
+		case INST_JMP_IF_ZERO:
+		case INST_JMP_LTI:
+		case INST_LOCAL_GET:
+		case INST_LOCAL_SET:
+		case INST_ARG_GET:
+		case INST_ARG_SET:
+		case INST_BREAKPOINT:
+		case EASM_NUMBER_OF_INSTS:
+		default: return false;
+	}
+}
+
+// NOTE: `push a; plusi_imm b` and friends
+static bool easm_fold_immediate(Inst_Type type, Word a, Word b, Word *result) {
+	if (type == INST_PLUSI_IMM) {
+		result->as_u64 = a.as_u64 + b.as_u64;
+	} else if (type == INST_MINUSI_IMM) {
+		result->as_u64 = a.as_u64 - b.as_u64;
+	} else if (type == INST_EQI_IMM) {
+		result->as_u64 = a.as_i64 == b.as_i64;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static bool easm_immediate_form(Inst_Type type, Inst_Type *immediate) {
+	if (type == INST_PLUSI) {
+		*immediate = INST_PLUSI_IMM;
+	} else if (type == INST_MINUSI) {
+		*immediate = INST_MINUSI_IMM;
+	} else if (type == INST_EQI) {
+		*immediate = INST_EQI_IMM;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// NOTE: float comparisons are left alone, NaN makes `ltf; not` differ from `gef`
+static bool easm_negate_comparison(Inst_Type type, Inst_Type *negated) {
+	switch (type) {
+		case INST_EQI: *negated = INST_NEI; return true;
+		case INST_NEI: *negated = INST_EQI; return true;
+		case INST_LTI: *negated = INST_GEI; return true;
+		case INST_GEI: *negated = INST_LTI; return true;
+		case INST_GTI: *negated = INST_LEI; return true;
+		case INST_LEI: *negated = INST_GTI; return true;
+		case INST_EQU: *negated = INST_NEU; return true;
+		case INST_NEU: *negated = INST_EQU; return true;
+		case INST_LTU: *negated = INST_GEU; return true;
+		case INST_GEU: *negated = INST_LTU; return true;
+		case INST_GTU: *negated = INST_LEU; return true;
+		case INST_LEU: *negated = INST_GTU; return true;
+		case INST_EQF: *negated = INST_NEF; return true;
+		case INST_NEF: *negated = INST_EQF; return true;
+		case INST_NOP:
+		case INST_PUSH:
+		case INST_DROP:
+		case INST_DUP:
+		case INST_SWAP:
+		case INST_PLUSI:
+		case INST_MINUSI:
+		case INST_MULTI:
+		case INST_DIVI:
+		case INST_MODI:
+		case INST_MULTU:
+		case INST_DIVU:
+		case INST_MODU:
+		case INST_PLUSF:
+		case INST_MINUSF:
+		case INST_MULTF:
+		case INST_DIVF:
+		case INST_JMP:
+		case INST_JMP_IF:
+		case INST_RET:
+		case INST_CALL:
+		case INST_NATIVE:
+		case INST_NOT:
+		case INST_GEF:
+		case INST_GTF:
+		case INST_LEF:
+		case INST_LTF:
+		case INST_ANDB:
+		case INST_ORB:
+		case INST_XOR:
+		case INST_SHR:
+		case INST_SHL:
+		case INST_NOTB:
+		case INST_READ8:
+		case INST_READ16:
+		case INST_READ32:
+		case INST_READ64:
+		case INST_WRITE8:
+		case INST_WRITE16:
+		case INST_WRITE32:
+		case INST_WRITE64:
+		case INST_I2F:
+		case INST_U2F:
+		case INST_F2I:
+		case INST_F2U:
+		case INST_HALT:
+		case INST_PLUSI_IMM:
+		case INST_MINUSI_IMM:
+		case INST_EQI_IMM:
+		case INST_JMP_IF_NOT:
+		case INST_JMP_IF_ZERO:
+		case INST_JMP_LTI:
+		case INST_LOCAL_GET:
+		case INST_LOCAL_SET:
+		case INST_ARG_GET:
+		case INST_ARG_SET:
+		case INST_BREAKPOINT:
+		case EASM_NUMBER_OF_INSTS:
+		default: return false;
+	}
+}
+
+// NOTE: removed instructions are mapped to the next one that survives, so labels that
+// pointed to them keep pointing to the code with the same meaning
+static void easm_remove_insts(EASM *easm, const bool *removed) {
+	const uint64_t size = easm->program_size;
+	Inst_Addr *new_addr = malloc(sizeof(*new_addr) * (size + 1));
+	int *reloc = malloc(sizeof(*reloc) * (size + 1));
+	if (new_addr == NULL || reloc == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the optimizer: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	Inst_Addr next = 0;
+	for (uint64_t i = 0; i < size; ++i) {
+		new_addr[i] = next;
+		reloc[i] = EASM_NO_RELOC;
+		if (!removed[i]) next += 1;
+	}
+	new_addr[size] = next;
+
+	size_t relocations_size = 0;
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		Relocation relocation = easm->relocations[i];
+		if (removed[relocation.addr]) continue;
+		reloc[relocation.addr] = (int) relocation.kind;
+		relocation.addr = new_addr[relocation.addr];
+		easm->relocations[relocations_size++] = relocation;
+	}
+	easm->relocations_size = relocations_size;
+
+	size_t deferred_operands_size = 0;
+	for (size_t i = 0; i < easm->deferred_operands_size; ++i) {
+		Deferred_Operand operand = easm->deferred_operands[i];
+		if (removed[operand.addr]) continue;
+		operand.addr = new_addr[operand.addr];
+		easm->deferred_operands[deferred_operands_size++] = operand;
+	}
+	easm->deferred_operands_size = deferred_operands_size;
+
+	for (uint64_t i = 0; i < size; ++i) {
+		if (removed[i]) continue;
+
+		Inst inst = easm->program[i];
+		const bool is_code_addr = reloc[i] == RELOC_CODE
+			|| (easm_inst_has_code_operand(inst.type) && reloc[i] != RELOC_SYMBOL);
+		if (is_code_addr && inst.operand.as_u64 <= size) {
+			inst.operand.as_u64 = new_addr[inst.operand.as_u64];
+		}
+		easm->program[new_addr[i]] = inst;
+	}
+	easm->program_size = next;
+
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		Binding *binding = &easm->bindings[i];
+		if (binding->kind == BINDING_LABEL && binding->value.as_u64 <= size) {
+			binding->value.as_u64 = new_addr[binding->value.as_u64];
+		}
+	}
+
+	if (easm->has_entry && easm->entry <= size) {
+		easm->entry = new_addr[easm->entry];
+	}
+
+	free(new_addr);
+	free(reloc);
+}
+
+// NOTE: fills the relocation kind of every instruction and marks everything the control
+// flow may reach other than by falling through
+void easm_find_targets(const EASM *easm, int *reloc, bool *is_target) {
+	const uint64_t size = easm->program_size;
+
+	for (uint64_t i = 0; i < size; ++i) reloc[i] = EASM_NO_RELOC;
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		reloc[easm->relocations[i].addr] = (int) easm->relocations[i].kind;
+	}
+
+	for (uint64_t i = 0; i < size; ++i) {
+		const bool is_code_addr = reloc[i] == RELOC_CODE
+			|| (easm_inst_has_code_operand(easm->program[i].type) && reloc[i] != RELOC_SYMBOL);
+		if (is_code_addr && easm->program[i].operand.as_u64 < size) {
+			is_target[easm->program[i].operand.as_u64] = true;
+		}
+		// NOTE: the return address of a call
+		if (easm->program[i].type == INST_CALL) is_target[i + 1] = true;
+	}
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		if (easm->bindings[i].kind == BINDING_LABEL && easm->bindings[i].value.as_u64 < size) {
+			is_target[easm->bindings[i].value.as_u64] = true;
+		}
+	}
+	if (easm->has_entry && easm->entry < size) is_target[easm->entry] = true;
+}
+
+// NOTE: takes the instruction out of the ones the peephole still sees, a label of it moves
+// to the next one
+static void easm_peephole_remove(bool *removed, bool *is_target, uint64_t *next, uint64_t *prev, uint64_t size, uint64_t i) {
+	removed[i] = true;
+	if (next[i] < size) {
+		prev[next[i]] = prev[i];
+		if (is_target[i]) is_target[next[i]] = true;
+	}
+	if (prev[i] < size) next[prev[i]] = next[i];
+}
+
+// NOTE: returns whether the program changed
+static bool easm_optimize_once(EASM *easm) {
+	const uint64_t size = easm->program_size;
+	Inst *program = easm->program;
+
+	bool *removed = calloc(size + 1, sizeof(*removed));
+	bool *is_target = calloc(size + 1, sizeof(*is_target));
+	int *reloc = malloc(sizeof(*reloc) * (size + 1));
+	uint64_t *next = malloc(sizeof(*next) * (size + 1));
+	uint64_t *prev = malloc(sizeof(*prev) * (size + 1));
+	if (removed == NULL || is_target == NULL || reloc == NULL || next == NULL || prev == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the optimizer: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	easm_find_targets(easm, reloc, is_target);
+
+	bool changed = false;
+
+	// Jump threading
+	for (uint64_t i = 0; i < size; ++i) {
+		if (!easm_inst_has_code_operand(program[i].type) || reloc[i] == RELOC_SYMBOL) continue;
+
+		Inst_Addr target = program[i].operand.as_u64;
+		uint64_t hops = 0;
+		while (hops < size && target < size && program[target].type == INST_JMP && reloc[target] != RELOC_SYMBOL) {
+			target = program[target].operand.as_u64;
+			hops += 1;
+		}
+
+		// NOTE: a loop made only of jumps has no end to thread to
+		if (hops < size && target != program[i].operand.as_u64) {
+			program[i].operand.as_u64 = target;
+			changed = true;
+		}
+	}
+
+	// Peephole
+	//
+	// NOTE: the window slides over the instructions that are still there, they are linked
+	// to their neighbours. A label of a removed instruction moves to the next one like in
+	// easm_remove_insts. After a rewrite the window steps back by one, so a chain like
+	// `push 1; push 2; plusi; push 3; plusi` folds in a single pass.
+	for (uint64_t i = 0; i < size; ++i) {
+		next[i] = i + 1;
+		prev[i] = i == 0 ? size : i - 1;
+	}
+#define EASM_PEEPHOLE_REMOVE(j) easm_peephole_remove(removed, is_target, next, prev, size, (j))
+	for (uint64_t i = 0; i < size;) {
+		const uint64_t ib = next[i];
+		const uint64_t ic = ib < size ? next[ib] : size;
+		Inst *a = &program[i];
+		Inst *b = ib < size && !is_target[ib] ? &program[ib] : NULL;
+		Inst *c = b != NULL && ic < size && !is_target[ic] ? &program[ic] : NULL;
+		const bool a_is_const = a->type == INST_PUSH && reloc[i] == EASM_NO_RELOC;
+		const bool b_is_const = b != NULL && b->type == INST_PUSH && reloc[ib] == EASM_NO_RELOC;
+		Word folded = { 0 };
+		Inst_Type negated = INST_NOP;
+
+		if (a->type == INST_NOP) {
+			EASM_PEEPHOLE_REMOVE(i);
+		} else if (a->type == INST_JMP && reloc[i] != RELOC_SYMBOL && a->operand.as_u64 == i + 1) {
+			EASM_PEEPHOLE_REMOVE(i);
+		} else if (a_is_const && b_is_const && c != NULL && easm_fold_binary(c->type, a->operand, b->operand, &folded)) {
+			a->operand = folded;
+			EASM_PEEPHOLE_REMOVE(ib);
+			EASM_PEEPHOLE_REMOVE(ic);
+		} else if (a_is_const && b != NULL && easm_fold_unary(b->type, a->operand, &folded)) {
+			a->operand = folded;
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if (a_is_const && b != NULL && easm_is_identity(b->type, a->operand)) {
+			EASM_PEEPHOLE_REMOVE(i);
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if ((a->type == INST_PUSH || a->type == INST_DUP || a->type == INST_LOCAL_GET || a->type == INST_ARG_GET)
+			&& b != NULL && b->type == INST_DROP) {
+			EASM_PEEPHOLE_REMOVE(i);
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if (a->type == INST_SWAP && b != NULL && b->type == INST_SWAP && a->operand.as_u64 == b->operand.as_u64) {
+			EASM_PEEPHOLE_REMOVE(i);
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if (b != NULL && b->type == INST_NOT && easm_negate_comparison(a->type, &negated)) {
+			a->type = negated;
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if (a->type == INST_NOT && b != NULL && b->type == INST_NOT && ic < size
+			&& (program[ic].type == INST_JMP_IF || program[ic].type == INST_JMP_IF_NOT)) {
+			EASM_PEEPHOLE_REMOVE(i);
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if (a_is_const && b != NULL && (b->type == INST_JMP_IF || b->type == INST_JMP_IF_NOT)) {
+			// NOTE: the jump keeps its own relocation, so it is the one that stays
+			EASM_PEEPHOLE_REMOVE(i);
+			if ((a->operand.as_u64 == 0) == (b->type == INST_JMP_IF)) {
+				EASM_PEEPHOLE_REMOVE(ib);
+			} else {
+				b->type = INST_JMP;
+			}
+		} else if (a_is_const && b != NULL && easm_fold_immediate(b->type, a->operand, b->operand, &folded) && reloc[ib] == EASM_NO_RELOC) {
+			a->operand = folded;
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if (a_is_const && b != NULL && easm_immediate_form(b->type, &negated)) {
+			// NOTE: the constant moves into the instruction, `push 1; minusi` is `minusi_imm 1`
+			a->type = negated;
+			EASM_PEEPHOLE_REMOVE(ib);
+		} else if ((a->type == INST_PLUSI_IMM || a->type == INST_MINUSI_IMM) && a->operand.as_u64 == 0 && reloc[i] == EASM_NO_RELOC) {
+			EASM_PEEPHOLE_REMOVE(i);
+		} else if (a->type == INST_EQI_IMM && a->operand.as_u64 == 0 && reloc[i] == EASM_NO_RELOC) {
+			a->type = INST_NOT;
+		} else if (a->type == INST_NOT && b != NULL && (b->type == INST_JMP_IF || b->type == INST_JMP_IF_NOT)) {
+			b->type = b->type == INST_JMP_IF ? INST_JMP_IF_NOT : INST_JMP_IF;
+			EASM_PEEPHOLE_REMOVE(i);
+		} else if (a->type == INST_DUP && a->operand.as_u64 == 0 && b != NULL && b->type == INST_JMP_IF_NOT) {
+			b->type = INST_JMP_IF_ZERO;
+			EASM_PEEPHOLE_REMOVE(i);
+		} else if (b != NULL && ((a->type == INST_LTI && b->type == INST_JMP_IF) || (a->type == INST_GEI && b->type == INST_JMP_IF_NOT))) {
+			b->type = INST_JMP_LTI;
+			EASM_PEEPHOLE_REMOVE(i);
+		} else {
+			i = ib;
+			continue;
+		}
+
+		changed = true;
+		if (prev[i] < size) {
+			i = prev[i];
+		} else if (removed[i]) {
+			i = next[i];
+		}
+	}
+#undef EASM_PEEPHOLE_REMOVE
+
+	if (changed) easm_remove_insts(easm, removed);
+
+	free(removed);
+	free(is_target);
+	free(reloc);
+	free(next);
+	free(prev);
+	return changed;
+}
+
+// NOTE: a callee is followed from its entry with the height of the stack above the
+// caller's values. Functions that do not reach below what they were given are the ones
+// that may be inlined or jumped to.
+typedef struct {
+	bool analyzed;
+	bool in_progress;
+	bool ok;
+	bool is_leaf;
+	bool uses_frame;	// looks at the frame pointer, which a jump does not move
+	int64_t args;		// values of the caller the function consumes
+	int64_t results;	// values it leaves for the caller
+
+	// NOTE: the body with the frame accesses turned into dup and swap, only for inlinable leaves
+	Inst *body;
+	Inst_Addr *body_source;
+	bool *body_is_local;	// jump operand is an index in the body
+	size_t body_size;
+} Easm_Function;
+
+typedef struct {
+	EASM *easm;
+	const int *reloc;
+	Easm_Function *functions;
+} Easm_Inliner;
+
+typedef struct {
+	bool seen;
+	int64_t height;		// values above the caller's stack, the frame pointer is at 0
+} Easm_Track_State;
+
+static bool easm_analyze_function(Easm_Inliner *inliner, Inst_Addr start);
+
+// NOTE: where the slot the frame instruction reaches is, relative to the frame pointer
+static int64_t easm_frame_index(Inst inst) {
+	const int64_t n = (int64_t) inst.operand.as_u64;
+	return inst.type == INST_LOCAL_GET || inst.type == INST_LOCAL_SET ? n : -1 - n;
+}
+
+// NOTE: fills `states` for every instruction reachable from `start` before returning
+static bool easm_track_function(Easm_Inliner *inliner, Inst_Addr start, Easm_Track_State *states, Easm_Function *function) {
+	EASM *easm = inliner->easm;
+	const uint64_t size = easm->program_size;
+
+	Inst_Addr *stack = malloc(sizeof(*stack) * (size + 1));
+	if (stack == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the inliner: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	bool ok = true;
+	bool has_exit = false;
+	int64_t exit_height = 0;
+	int64_t lowest = 0;
+	function->is_leaf = true;
+	function->uses_frame = false;
+
+	size_t stack_size = 0;
+	states[start] = (Easm_Track_State) { .seen = true };
+	stack[stack_size++] = start;
+
+	while (ok && stack_size > 0) {
+		const Inst_Addr i = stack[--stack_size];
+		const Inst inst = easm->program[i];
+		int64_t h = states[i].height;
+
+		Inst_Addr next[2];
+		size_t next_size = 0;
+		size_t pops = 0;
+		size_t pushes = 0;
+
+		if (inst.type == INST_DUP || inst.type == INST_SWAP) {
+			const int64_t index = h - 1 - (int64_t) inst.operand.as_u64;
+			if (index < lowest) lowest = index;
+			if (inst.type == INST_DUP) h += 1;
+			next[next_size++] = i + 1;
+		} else if (inst.type == INST_LOCAL_GET || inst.type == INST_ARG_GET
+			|| inst.type == INST_LOCAL_SET || inst.type == INST_ARG_SET) {
+			const bool is_set = inst.type == INST_LOCAL_SET || inst.type == INST_ARG_SET;
+			const int64_t index = easm_frame_index(inst);
+			if (index < lowest) lowest = index;
+			// NOTE: the slot has to be there, after the value to set is taken off
+			ok = index < (is_set ? h - 1 : h);
+			function->uses_frame = true;
+			h += is_set ? -1 : 1;
+			next[next_size++] = i + 1;
+		} else if (inst.type == INST_RET) {
+			ok = !has_exit || exit_height == h;
+			has_exit = true;
+			exit_height = h;
+		} else if (inst.type == INST_CALL) {
+			function->is_leaf = false;
+			ok = inliner->reloc[i] != RELOC_SYMBOL && inst.operand.as_u64 < size
+				&& easm_analyze_function(inliner, inst.operand.as_u64);
+			if (ok) {
+				const Easm_Function *callee = &inliner->functions[inst.operand.as_u64];
+				if (h - callee->args < lowest) lowest = h - callee->args;
+				h += callee->results - callee->args;
+				next[next_size++] = i + 1;
+			}
+		} else if (inst.type == INST_NATIVE || inst.type == INST_HALT || inst.type == INST_BREAKPOINT) {
+			// NOTE: natives may do anything with the stack, a breakpoint has to stay where it is
+			ok = false;
+		} else {
+			const bool is_jump = inst.type == INST_JMP || inst_is_conditional_jump(inst.type);
+			if (is_jump && inliner->reloc[i] == RELOC_SYMBOL) ok = false;
+			if (is_jump) next[next_size++] = inst.operand.as_u64;
+			if (inst.type != INST_JMP) next[next_size++] = i + 1;
+
+			// NOTE: jmp_if_zero looks at the top without taking it
+			if (inst.type == INST_JMP_IF_ZERO && h - 1 < lowest) lowest = h - 1;
+
+			inst_stack_effect(inst.type, &pops, &pushes);
+			if (h - (int64_t) pops < lowest) lowest = h - (int64_t) pops;
+			h += (int64_t) pushes - (int64_t) pops;
+		}
+
+		for (size_t j = 0; ok && j < next_size; ++j) {
+			if (next[j] >= size) {
+				ok = false;
+			} else if (!states[next[j]].seen) {
+				states[next[j]] = (Easm_Track_State) { .seen = true, .height = h };
+				stack[stack_size++] = next[j];
+			} else if (states[next[j]].height != h) {
+				ok = false;
+			}
+		}
+	}
+
+	free(stack);
+
+	if (!ok || !has_exit) return false;
+	function->args = -lowest;
+	function->results = exit_height - lowest;
+	return true;
+}
+
+// NOTE: rewrites the reachable part of the leaf in address order. Inlined, the frame is the
+// caller's, so the frame accesses become dup and `swap; drop` by the tracked height.
+static void easm_build_inline_body(Inst_Addr start, const EASM *easm, const Easm_Track_State *states, Easm_Function *function) {
+	const uint64_t size = easm->program_size;
+	Inst_Addr *local = malloc(sizeof(*local) * (size + 1));
+	function->body = malloc(sizeof(*function->body) * (2 * size + 1));
+	function->body_source = malloc(sizeof(*function->body_source) * (2 * size + 1));
+	function->body_is_local = calloc(2 * size + 1, sizeof(*function->body_is_local));
+	if (local == NULL || function->body == NULL || function->body_source == NULL || function->body_is_local == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the inliner: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	Inst_Addr last = start;
+	for (Inst_Addr i = start; i < size; ++i) {
+		if (states[i].seen) last = i;
+	}
+
+	// Layout
+	size_t count = 0;
+	for (Inst_Addr i = 0; i < size; ++i) {
+		if (!states[i].seen) continue;
+		local[i] = count;
+
+		const Inst inst = easm->program[i];
+		if (inst.type == INST_RET) {
+			if (i != last) count += 1;
+		} else if (inst.type == INST_LOCAL_SET || inst.type == INST_ARG_SET) {
+			count += 2;
+		} else {
+			count += 1;
+		}
+	}
+
+	// Emit
+	size_t n = 0;
+	for (Inst_Addr i = 0; i < size; ++i) {
+		if (!states[i].seen) continue;
+
+		Inst inst = easm->program[i];
+		const int64_t h = states[i].height;
+		bool is_local = false;
+
+		if (inst.type == INST_RET) {
+			if (i == last) continue;
+			inst = (Inst) { .type = INST_JMP, .operand = word_u64(count) };
+			is_local = true;
+		} else if (inst.type == INST_LOCAL_GET || inst.type == INST_ARG_GET) {
+			inst = (Inst) { .type = INST_DUP, .operand = word_u64((uint64_t) (h - 1 - easm_frame_index(inst))) };
+		} else if (inst.type == INST_LOCAL_SET || inst.type == INST_ARG_SET) {
+			function->body[n] = (Inst) { .type = INST_SWAP, .operand = word_u64((uint64_t) (h - 1 - easm_frame_index(inst))) };
+			function->body_source[n] = i;
+			function->body_is_local[n] = false;
+			n += 1;
+			inst = (Inst) { .type = INST_DROP };
+		} else if (inst.type == INST_JMP || inst_is_conditional_jump(inst.type)) {
+			inst.operand = word_u64(local[inst.operand.as_u64]);
+			is_local = true;
+		}
+
+		function->body[n] = inst;
+		function->body_source[n] = i;
+		function->body_is_local[n] = is_local;
+		n += 1;
+	}
+	function->body_size = n;
+
+	free(local);
+}
+
+static bool easm_analyze_function(Easm_Inliner *inliner, Inst_Addr start) {
+	Easm_Function *function = &inliner->functions[start];
+	if (function->analyzed) return function->ok;
+	// NOTE: recursion can not be summarized
+	if (function->in_progress) return false;
+
+	function->in_progress = true;
+
+	Easm_Track_State *states = calloc(inliner->easm->program_size + 1, sizeof(*states));
+	if (states == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the inliner: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	function->ok = easm_track_function(inliner, start, states, function);
+	if (function->ok && function->is_leaf) {
+		easm_build_inline_body(start, inliner->easm, states, function);
+	}
+
+	free(states);
+	function->in_progress = false;
+	function->analyzed = true;
+	return function->ok;
+}
+
+// NOTE: returns whether the program changed
+static bool easm_inline_calls(EASM *easm) {
+	const uint64_t size = easm->program_size;
+	int *reloc = malloc(sizeof(*reloc) * (size + 1));
+	Easm_Function *functions = calloc(size + 1, sizeof(*functions));
+	Easm_Function **inlined = calloc(size + 1, sizeof(*inlined));
+	Inst_Addr *new_addr = malloc(sizeof(*new_addr) * (size + 1));
+	if (reloc == NULL || functions == NULL || inlined == NULL || new_addr == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the inliner: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	for (uint64_t i = 0; i < size; ++i) reloc[i] = EASM_NO_RELOC;
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		reloc[easm->relocations[i].addr] = (int) easm->relocations[i].kind;
+	}
+
+	Easm_Inliner inliner = {
+		.easm = easm,
+		.reloc = reloc,
+		.functions = functions,
+	};
+
+	bool changed = false;
+	bool has_inlined = false;
+	Inst_Addr next = 0;
+	for (uint64_t i = 0; i < size; ++i) {
+		new_addr[i] = next;
+		next += 1;
+
+		const Inst inst = easm->program[i];
+		if (inst.type != INST_CALL || reloc[i] == RELOC_SYMBOL || inst.operand.as_u64 >= size) continue;
+		if (!easm_analyze_function(&inliner, inst.operand.as_u64)) continue;
+
+		Easm_Function *callee = &functions[inst.operand.as_u64];
+		if (callee->is_leaf && callee->body_size <= EASM_INLINE_MAX_INSTS) {
+			inlined[i] = callee;
+			next += callee->body_size;
+			next -= 1;
+			has_inlined = true;
+			changed = true;
+		} else if (!callee->uses_frame && i + 1 < size && easm->program[i + 1].type == INST_RET) {
+			// NOTE: the return address is not on the operand stack, the callee may return
+			// straight to our caller as long as it does not look at the frame it would share
+			easm->program[i].type = INST_JMP;
+			changed = true;
+		}
+	}
+	new_addr[size] = next;
+
+	if (has_inlined) {
+		Inst *program = malloc(sizeof(*program) * (next + 1));
+		Relocation *relocations = NULL;
+		size_t relocations_size = 0;
+		size_t relocations_capacity = 0;
+		if (program == NULL) {
+			fprintf(stderr, "ERROR: could not allocate memory for the inliner: %s\n", strerror(errno));
+			exit(1);
+		}
+
+		// NOTE: relocations of the callees are copied to every inlined body
+		Relocation **reloc_at = calloc(size + 1, sizeof(*reloc_at));
+		if (reloc_at == NULL) {
+			fprintf(stderr, "ERROR: could not allocate memory for the inliner: %s\n", strerror(errno));
+			exit(1);
+		}
+		for (size_t i = 0; i < easm->relocations_size; ++i) {
+			reloc_at[easm->relocations[i].addr] = &easm->relocations[i];
+		}
+
+		for (uint64_t i = 0; i < size; ++i) {
+			if (inlined[i] != NULL) {
+				const Easm_Function *callee = inlined[i];
+				for (size_t j = 0; j < callee->body_size; ++j) {
+					Inst inst = callee->body[j];
+					const Relocation *relocation = reloc_at[callee->body_source[j]];
+					if (callee->body_is_local[j]) {
+						inst.operand.as_u64 += new_addr[i];
+					} else if (relocation != NULL && relocation->kind == RELOC_CODE && inst.operand.as_u64 <= size) {
+						inst.operand.as_u64 = new_addr[inst.operand.as_u64];
+					}
+					program[new_addr[i] + j] = inst;
+
+					if (relocation != NULL) {
+						EASM_TABLE_RESERVE(relocations, relocations_size, relocations_capacity, 1);
+						relocations[relocations_size] = *relocation;
+						relocations[relocations_size].addr = new_addr[i] + j;
+						relocations_size += 1;
+					}
+				}
+				continue;
+			}
+
+			Inst inst = easm->program[i];
+			const bool is_code_addr = reloc[i] == RELOC_CODE
+				|| (easm_inst_has_code_operand(inst.type) && reloc[i] != RELOC_SYMBOL);
+			if (is_code_addr && inst.operand.as_u64 <= size) {
+				inst.operand.as_u64 = new_addr[inst.operand.as_u64];
+			}
+			program[new_addr[i]] = inst;
+
+			if (reloc_at[i] != NULL) {
+				EASM_TABLE_RESERVE(relocations, relocations_size, relocations_capacity, 1);
+				relocations[relocations_size] = *reloc_at[i];
+				relocations[relocations_size].addr = new_addr[i];
+				relocations_size += 1;
+			}
+		}
+
+		size_t deferred_operands_size = 0;
+		for (size_t i = 0; i < easm->deferred_operands_size; ++i) {
+			Deferred_Operand operand = easm->deferred_operands[i];
+			if (inlined[operand.addr] != NULL) continue;
+			operand.addr = new_addr[operand.addr];
+			easm->deferred_operands[deferred_operands_size++] = operand;
+		}
+		easm->deferred_operands_size = deferred_operands_size;
+
+		for (size_t i = 0; i < easm->bindings_size; ++i) {
+			Binding *binding = &easm->bindings[i];
+			if (binding->kind == BINDING_LABEL && binding->value.as_u64 <= size) {
+				binding->value.as_u64 = new_addr[binding->value.as_u64];
+			}
+		}
+
+		if (easm->has_entry && easm->entry <= size) {
+			easm->entry = new_addr[easm->entry];
+		}
+
+		free(easm->program);
+		easm->program = program;
+		easm->program_size = next;
+		easm->program_capacity = next + 1;
+
+		free(easm->relocations);
+		easm->relocations = relocations;
+		easm->relocations_size = relocations_size;
+		easm->relocations_capacity = relocations_capacity;
+
+		free(reloc_at);
+	}
+
+	for (uint64_t i = 0; i < size; ++i) {
+		free(functions[i].body);
+		free(functions[i].body_source);
+		free(functions[i].body_is_local);
+	}
+	free(functions);
+	free(inlined);
+	free(new_addr);
+	free(reloc);
+	return changed;
+}
+
+// Value numbering
+//
+// NOTE: every basic block is executed symbolically, every slot of the stack holds the
+// number of the value it has. That is SSA for straight code: equal numbers are equal
+// values no matter which dup/swap moved them around.
+
+typedef struct {
+	Inst_Type type;
+	Word operand;
+	int reloc;
+	size_t args[2];
+	size_t epoch;		// reads of the memory are equal only between the same writes
+} Easm_Value;
+
+typedef struct {
+	size_t value;
+	// NOTE: [start, end] are the instructions that computed the slot out of nothing but
+	// pushes and copies, start is -1 when there are none
+	int64_t start;
+	int64_t end;
+} Easm_Slot;
+
+// NOTE: a slot of the hash table of the values, it is empty unless it was filled in the
+// current block, so starting a block empties the whole table at once
+typedef struct {
+	size_t value;
+	size_t block;
+} Easm_Value_Slot;
+
+typedef struct {
+	// NOTE: the values of the current block only, nothing is known across the blocks
+	Easm_Value *values;
+	size_t values_size;
+	size_t values_capacity;
+
+	Easm_Value_Slot *slots;
+	size_t slots_capacity;
+	size_t block;
+
+	Easm_Slot *stack;
+	size_t stack_size;
+	size_t stack_capacity;
+
+	size_t epoch;
+} Easm_Numbering;
+
+// NOTE: FNV-1a field by field like inst_program_hash
+static uint64_t easm_value_hash(const Easm_Value *value) {
+	const uint64_t fields[6] = {
+		(uint64_t) value->type, value->operand.as_u64, (uint64_t) value->reloc,
+		value->args[0], value->args[1], value->epoch,
+	};
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t j = 0; j < sizeof(fields); ++j) {
+		hash ^= ((const uint8_t *) fields)[j];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static bool easm_value_equal(const Easm_Value *a, const Easm_Value *b) {
+	return a->type == b->type && a->operand.as_u64 == b->operand.as_u64 && a->reloc == b->reloc
+		&& a->args[0] == b->args[0] && a->args[1] == b->args[1] && a->epoch == b->epoch;
+}
+
+// NOTE: the slot where the value is or where it goes, the table is never more than half full
+static Easm_Value_Slot *easm_number_slot(Easm_Numbering *numbering, const Easm_Value *value) {
+	const size_t mask = numbering->slots_capacity - 1;
+	for (size_t i = easm_value_hash(value) & mask;; i = (i + 1) & mask) {
+		Easm_Value_Slot *slot = &numbering->slots[i];
+		if (slot->block != numbering->block || easm_value_equal(&numbering->values[slot->value], value)) {
+			return slot;
+		}
+	}
+}
+
+static size_t easm_number_value(Easm_Numbering *numbering, Easm_Value value) {
+	if ((numbering->values_size + 1) * 2 > numbering->slots_capacity) {
+		const size_t capacity = numbering->slots_capacity == 0 ? EASM_TABLE_INIT_CAPACITY : numbering->slots_capacity * 2;
+		free(numbering->slots);
+		numbering->slots = calloc(capacity, sizeof(*numbering->slots));
+		if (numbering->slots == NULL) {
+			fprintf(stderr, "ERROR: could not grow assembler table: %s\n", strerror(errno));
+			exit(1);
+		}
+		numbering->slots_capacity = capacity;
+		for (size_t i = 0; i < numbering->values_size; ++i) {
+			*easm_number_slot(numbering, &numbering->values[i]) = (Easm_Value_Slot) { .value = i, .block = numbering->block };
+		}
+	}
+
+	Easm_Value_Slot *slot = easm_number_slot(numbering, &value);
+	if (slot->block == numbering->block) return slot->value;
+
+	EASM_TABLE_RESERVE(numbering->values, numbering->values_size, numbering->values_capacity, 1);
+	numbering->values[numbering->values_size] = value;
+	*slot = (Easm_Value_Slot) { .value = numbering->values_size, .block = numbering->block };
+	return numbering->values_size++;
+}
+
+// NOTE: values the block found on the stack are unknown, every one of them is unique
+static void easm_number_ensure_depth(Easm_Numbering *numbering, size_t depth) {
+	if (numbering->stack_size > depth) return;
+
+	const size_t missing = depth + 1 - numbering->stack_size;
+	EASM_TABLE_RESERVE(numbering->stack, numbering->stack_size, numbering->stack_capacity, missing);
+	memmove(numbering->stack + missing, numbering->stack, sizeof(*numbering->stack) * numbering->stack_size);
+	for (size_t i = 0; i < missing; ++i) {
+		// NOTE: NOP never makes it into the table on its own, so it is a safe tag for unknowns
+		const Easm_Value unknown = { .type = INST_NOP, .operand = word_u64(numbering->values_size), .epoch = numbering->epoch };
+		numbering->stack[i] = (Easm_Slot) { .value = easm_number_value(numbering, unknown), .start = -1, .end = -1 };
+	}
+	numbering->stack_size += missing;
+}
+
+static Easm_Slot easm_number_pop(Easm_Numbering *numbering) {
+	easm_number_ensure_depth(numbering, 0);
+	return numbering->stack[--numbering->stack_size];
+}
+
+static void easm_number_push(Easm_Numbering *numbering, Easm_Slot slot) {
+	EASM_TABLE_RESERVE(numbering->stack, numbering->stack_size, numbering->stack_capacity, 1);
+	numbering->stack[numbering->stack_size++] = slot;
+}
+
+static bool easm_is_power_of_two(uint64_t x, uint64_t *log2) {
+	if (x == 0 || (x & (x - 1)) != 0) return false;
+	*log2 = 0;
+	while ((x >> *log2) != 1) *log2 += 1;
+	return true;
+}
+
+// NOTE: `push 2^k; multu` is `push k; shl` and so on. divi and modi round negative numbers
+// differently from the shifts, so they stay.
+static bool easm_reduce_strength(Inst *push, Inst *op) {
+	uint64_t k = 0;
+	if (!easm_is_power_of_two(push->operand.as_u64, &k)) return false;
+
+	if (op->type == INST_MULTI || op->type == INST_MULTU) {
+		push->operand = word_u64(k);
+		op->type = INST_SHL;
+	} else if (op->type == INST_DIVU) {
+		push->operand = word_u64(k);
+		op->type = INST_SHR;
+	} else if (op->type == INST_MODU) {
+		push->operand = word_u64(push->operand.as_u64 - 1);
+		op->type = INST_ANDB;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static bool easm_ends_block(Inst_Type type) {
+	return type == INST_JMP || inst_is_conditional_jump(type) || type == INST_RET
+		|| type == INST_CALL || type == INST_NATIVE || type == INST_HALT || type == INST_BREAKPOINT;
+}
+
+static uint64_t easm_block_end(const EASM *easm, const bool *is_target, uint64_t start) {
+	uint64_t i = start;
+	while (i + 1 < easm->program_size && !easm_ends_block(easm->program[i].type) && !is_target[i + 1]) i += 1;
+	return i + 1;
+}
+
+// NOTE: returns whether the block changed. It goes on after every rewrite, the removed
+// instructions are dropped once the program is compacted
+static bool easm_number_block(EASM *easm, Easm_Numbering *numbering, const int *reloc, uint64_t start, uint64_t end, bool *removed) {
+	Inst *program = easm->program;
+	bool changed = false;
+
+	numbering->stack_size = 0;
+	numbering->values_size = 0;
+	numbering->block += 1;
+	numbering->epoch += 1;
+
+	for (uint64_t i = start; i < end; ++i) {
+
+		const Inst inst = program[i];
+		size_t pops = 0;
+		size_t pushes = 0;
+		Easm_Slot result = { .start = (int64_t) i, .end = (int64_t) i };
+
+		if (inst.type == INST_PUSH) {
+			const Easm_Value value = { .type = INST_PUSH, .operand = inst.operand, .reloc = reloc[i] };
+			result.value = easm_number_value(numbering, value);
+			easm_number_push(numbering, result);
+			continue;
+		} else if (inst.type == INST_DUP) {
+			easm_number_ensure_depth(numbering, inst.operand.as_u64);
+			result.value = numbering->stack[numbering->stack_size - 1 - inst.operand.as_u64].value;
+			easm_number_push(numbering, result);
+			continue;
+		} else if (inst.type == INST_SWAP) {
+			easm_number_ensure_depth(numbering, inst.operand.as_u64);
+			Easm_Slot *a = &numbering->stack[numbering->stack_size - 1];
+			Easm_Slot *b = &numbering->stack[numbering->stack_size - 1 - inst.operand.as_u64];
+			// NOTE: swapping a value with a copy of itself does nothing
+			if (a->value == b->value) {
+				removed[i] = true;
+				changed = true;
+				continue;
+			}
+			const Easm_Slot t = *a;
+			*a = *b;
+			*b = t;
+			continue;
+		} else if (inst.type == INST_DROP) {
+			easm_number_pop(numbering);
+			continue;
+		} else if (inst.type >= INST_WRITE8 && inst.type <= INST_WRITE64) {
+			easm_number_pop(numbering);
+			easm_number_pop(numbering);
+			numbering->epoch += 1;
+			continue;
+		} else if (inst.type == INST_LOCAL_GET || inst.type == INST_ARG_GET) {
+			// NOTE: where the frame is relative to the block is not known, the value is new
+			const Easm_Value unknown = { .type = INST_NOP, .operand = word_u64(numbering->values_size), .epoch = numbering->epoch };
+			result.value = easm_number_value(numbering, unknown);
+			result.start = -1;
+			easm_number_push(numbering, result);
+			continue;
+		} else if (inst.type == INST_LOCAL_SET || inst.type == INST_ARG_SET) {
+			// NOTE: any of the slots may be the one written, none of them is known any more
+			easm_number_pop(numbering);
+			for (size_t j = 0; j < numbering->stack_size; ++j) {
+				const Easm_Value unknown = { .type = INST_NOP, .operand = word_u64(numbering->values_size), .epoch = numbering->epoch };
+				numbering->stack[j] = (Easm_Slot) { .value = easm_number_value(numbering, unknown), .start = -1, .end = -1 };
+			}
+			continue;
+		} else if (inst.type == INST_NOP || easm_ends_block(inst.type) || !inst_stack_effect(inst.type, &pops, &pushes)) {
+			continue;
+		}
+
+		// Pure instructions and reads
+		assert(pushes == 1 && (pops == 1 || pops == 2));
+		const bool is_read = inst.type >= INST_READ8 && inst.type <= INST_READ64;
+		Easm_Value value = {
+			.type = inst.type,
+			.operand = inst_has_operand(inst.type) ? inst.operand : word_u64(0),
+			.reloc = reloc[i],
+			.epoch = is_read ? numbering->epoch : 0,
+		};
+
+		if (pops == 2) {
+			const Easm_Slot b = easm_number_pop(numbering);
+			const Easm_Slot a = easm_number_pop(numbering);
+
+			// NOTE: the push is numbered again with its new operand and the instruction once more
+			// as what it became
+			if (b.start == (int64_t) i - 1 && program[i - 1].type == INST_PUSH && reloc[i - 1] == EASM_NO_RELOC
+				&& easm_reduce_strength(&program[i - 1], &program[i])) {
+				const Easm_Value push = { .type = INST_PUSH, .operand = program[i - 1].operand, .reloc = EASM_NO_RELOC };
+				easm_number_push(numbering, a);
+				easm_number_push(numbering, (Easm_Slot) { .value = easm_number_value(numbering, push), .start = b.start, .end = b.end });
+				changed = true;
+				i -= 1;
+				continue;
+			}
+
+			value.args[0] = a.value;
+			value.args[1] = b.value;
+			const bool is_range = a.start >= 0 && b.start >= 0 && a.end + 1 == b.start && b.end + 1 == (int64_t) i;
+			result.start = is_range ? a.start : -1;
+		} else {
+			const Easm_Slot a = easm_number_pop(numbering);
+			value.args[0] = a.value;
+			result.start = a.start >= 0 && a.end + 1 == (int64_t) i ? a.start : -1;
+		}
+
+		result.value = easm_number_value(numbering, value);
+
+		// NOTE: the range only added this value on top of the stack, if the same value
+		// was already there it can be copied instead of computed again
+		if (result.start >= 0 && reloc[result.start] == EASM_NO_RELOC) {
+			for (size_t depth = 0; depth < numbering->stack_size; ++depth) {
+				if (numbering->stack[numbering->stack_size - 1 - depth].value == result.value) {
+					program[result.start] = (Inst) { .type = INST_DUP, .operand = word_u64(depth) };
+					for (uint64_t j = (uint64_t) result.start + 1; j <= i; ++j) removed[j] = true;
+					result.end = result.start;
+					changed = true;
+					break;
+				}
+			}
+		}
+
+		easm_number_push(numbering, result);
+	}
+
+	return changed;
+}
+
+// NOTE: returns whether the program changed
+static bool easm_number_values(EASM *easm) {
+	const uint64_t size = easm->program_size;
+	bool *removed = calloc(size + 1, sizeof(*removed));
+	bool *is_target = calloc(size + 1, sizeof(*is_target));
+	int *reloc = malloc(sizeof(*reloc) * (size + 1));
+	if (removed == NULL || is_target == NULL || reloc == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the optimizer: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	easm_find_targets(easm, reloc, is_target);
+
+	Easm_Numbering numbering = { 0 };
+	bool changed = false;
+	for (uint64_t start = 0; start < size;) {
+		const uint64_t end = easm_block_end(easm, is_target, start);
+		if (easm_number_block(easm, &numbering, reloc, start, end, removed)) changed = true;
+		start = end;
+	}
+
+	if (changed) easm_remove_insts(easm, removed);
+
+	free(numbering.values);
+	free(numbering.slots);
+	free(numbering.stack);
+	free(removed);
+	free(is_target);
+	free(reloc);
+	return changed;
+}
+
+void easm_optimize(EASM *easm) {
+	if (easm->has_label_arithmetic) {
+		fprintf(stderr, "WARNING: the program computes distances between labels, the optimizer can not move the code and is disabled\n");
+		return;
+	}
+
+	// NOTE: the callees are cleaned up first, so more of them fit under EASM_INLINE_MAX_INSTS
+	while (easm_optimize_once(easm) || easm_number_values(easm)) {}
+	if (easm_inline_calls(easm)) {
+		while (easm_optimize_once(easm) || easm_number_values(easm)) {}
+	}
+}
+
+// NOTE: amount of dead bytes of the memory that lie before the address
+static size_t easm_dead_bytes_before(const EASM *easm, const bool *live, Memory_Addr addr) {
+	size_t result = 0;
+	for (size_t i = 0; i < easm->strings_size; ++i) {
+		if (!live[i] && easm->strings[i].addr + easm->strings[i].size <= addr) {
+			result += easm->strings[i].size;
+		}
+	}
+	return result;
+}
+
+// NOTE: an address one past the end of a string keeps the string that follows it alive,
+// so writing right after a string never lands into another one
+static void easm_mark_live_string(const EASM *easm, bool *live, Memory_Addr addr) {
+	bool found = false;
+	for (size_t i = 0; i < easm->strings_size; ++i) {
+		if (easm->strings[i].addr == addr) {
+			live[i] = true;
+			found = true;
+		}
+	}
+	if (found) return;
+
+	for (size_t i = 0; i < easm->strings_size; ++i) {
+		if (easm->strings[i].addr < addr && addr <= easm->strings[i].addr + easm->strings[i].size) {
+			live[i] = true;
+		}
+	}
+}
+
+void easm_eliminate_dead_code(EASM *easm, size_t *removed_insts, size_t *removed_bytes) {
+	*removed_insts = 0;
+	*removed_bytes = 0;
+
+	// NOTE: everything in an object may be called by the other ones
+	if (easm->is_object || !easm->has_entry || easm->has_label_arithmetic) return;
+
+	const uint64_t size = easm->program_size;
+	bool *reachable = calloc(size + 1, sizeof(*reachable));
+	bool *removed = calloc(size + 1, sizeof(*removed));
+	bool *live = calloc(easm->strings_size + 1, sizeof(*live));
+	int *reloc = malloc(sizeof(*reloc) * (size + 1));
+	Inst_Addr *stack = malloc(sizeof(*stack) * (size + 1));
+	if (reachable == NULL || removed == NULL || live == NULL || reloc == NULL || stack == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the dead code elimination: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	for (uint64_t i = 0; i < size; ++i) reloc[i] = EASM_NO_RELOC;
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		reloc[easm->relocations[i].addr] = (int) easm->relocations[i].kind;
+	}
+
+	// Reachability
+	size_t stack_size = 0;
+	if (easm->entry < size) {
+		reachable[easm->entry] = true;
+		stack[stack_size++] = easm->entry;
+	}
+
+	while (stack_size > 0) {
+		const Inst_Addr i = stack[--stack_size];
+		const Inst inst = easm->program[i];
+
+		Inst_Addr next[2];
+		size_t next_size = 0;
+
+		// NOTE: a label pushed as data may be jumped to or called later
+		const bool is_code_addr = reloc[i] == RELOC_CODE
+			|| (easm_inst_has_code_operand(inst.type) && reloc[i] != RELOC_SYMBOL);
+		if (is_code_addr) next[next_size++] = inst.operand.as_u64;
+		if (inst.type != INST_JMP && inst.type != INST_RET && inst.type != INST_HALT) next[next_size++] = i + 1;
+
+		for (size_t j = 0; j < next_size; ++j) {
+			if (next[j] < size && !reachable[next[j]]) {
+				reachable[next[j]] = true;
+				stack[stack_size++] = next[j];
+			}
+		}
+	}
+
+	for (uint64_t i = 0; i < size; ++i) {
+		removed[i] = !reachable[i];
+		if (removed[i]) *removed_insts += 1;
+	}
+
+	// Strings used by the reachable code
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		const Relocation relocation = easm->relocations[i];
+		if (relocation.kind == RELOC_DATA && reachable[relocation.addr]) {
+			easm_mark_live_string(easm, live, easm->program[relocation.addr].operand.as_u64);
+		}
+	}
+
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		const Relocation relocation = easm->relocations[i];
+		if (relocation.kind == RELOC_DATA && reachable[relocation.addr]) {
+			Word *operand = &easm->program[relocation.addr].operand;
+			operand->as_u64 -= easm_dead_bytes_before(easm, live, operand->as_u64);
+		}
+	}
+
+	size_t bindings_size = 0;
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		Binding binding = easm->bindings[i];
+		// NOTE: keep .sym free of the names of the dropped code
+		if (binding.kind == BINDING_LABEL && binding.value.as_u64 < size && !reachable[binding.value.as_u64]) continue;
+		if (binding.kind == BINDING_DATA) {
+			bool is_dead = false;
+			for (size_t j = 0; j < easm->strings_size; ++j) {
+				if (easm->strings[j].addr == binding.value.as_u64 && easm->strings[j].size > 0) is_dead = !live[j];
+			}
+			if (is_dead) continue;
+			binding.value.as_u64 -= easm_dead_bytes_before(easm, live, binding.value.as_u64);
+		}
+		easm->bindings[bindings_size++] = binding;
+	}
+	easm->bindings_size = bindings_size;
+	easm_index_bindings(easm);
+
+	// NOTE: strings are laid out in the order they were pushed, so they only move down
+	size_t strings_size = 0;
+	for (size_t i = 0; i < easm->strings_size; ++i) {
+		Memory_Chunk chunk = easm->strings[i];
+		if (!live[i]) {
+			*removed_bytes += chunk.size;
+			continue;
+		}
+
+		memmove(easm->memory + chunk.addr - *removed_bytes, easm->memory + chunk.addr, chunk.size);
+		chunk.addr -= *removed_bytes;
+		easm->strings[strings_size++] = chunk;
+	}
+	easm->strings_size = strings_size;
+	easm->memory_size -= *removed_bytes;
+	easm->memory_capacity -= *removed_bytes;
+
+	if (*removed_insts > 0) easm_remove_insts(easm, removed);
+
+	free(reachable);
+	free(removed);
+	free(live);
+	free(reloc);
+	free(stack);
+}
+
+Word easm_push_string_to_memory(EASM *easm, String_View sv) {
+    EASM_TABLE_RESERVE(easm->memory, easm->memory_size, easm->memory_allocated, sv.count);
+
+    Word result = word_u64(easm->memory_size);
+    memcpy(easm->memory + easm->memory_size, sv.data, sv.count);
+    easm->memory_size += sv.count;
+
+    EASM_TABLE_RESERVE(easm->strings, easm->strings_size, easm->strings_capacity, 1);
+    easm->strings[easm->strings_size++] = (Memory_Chunk) {
+        .addr = result.as_u64,
+        .size = sv.count,
+    };
+
+    if (easm->memory_size > easm->memory_capacity) {
         easm->memory_capacity = easm->memory_size;
     }
 
     return result;
 }
 
+// NOTE: zeroed memory of #reserve, it is a chunk like a string so the optimizer drops it
+// when nothing refers to it
+Word easm_reserve_memory(EASM *easm, uint64_t size) {
+	EASM_TABLE_RESERVE(easm->memory, easm->memory_size, easm->memory_allocated, size);
+
+	Word result = word_u64(easm->memory_size);
+	memset(easm->memory + easm->memory_size, 0, size);
+	easm->memory_size += size;
+
+	EASM_TABLE_RESERVE(easm->strings, easm->strings_size, easm->strings_capacity, 1);
+	easm->strings[easm->strings_size++] = (Memory_Chunk) {
+		.addr = result.as_u64,
+		.size = size,
+	};
+
+	if (easm->memory_size > easm->memory_capacity) {
+		easm->memory_capacity = easm->memory_size;
+	}
+
+	return result;
+}
+
+void easm_load_profile_from_file(const EASM *easm, const char *file_path, Evm_Profile *profile) {
+	Arena arena = { 0 };
+	String_View content = arena_slurp_file(&arena, sv_from_cstr(file_path));
+	memset(profile, 0, sizeof(*profile));
+
+	String_View header = sv_trim(sv_chop_by_delim(&content, '\n'));
+	const String_View magic = sv_trim(sv_chop_by_delim(&header, ' '));
+	const uint64_t program_size = sv_to_u64(sv_trim(sv_chop_by_delim(&header, ' ')));
+	const uint64_t hash = strtoull(arena_sv_to_cstr(&arena, sv_trim(header)), NULL, 16);
+
+	if (!sv_eq(magic, sv_from_cstr(EVM_PROFILE_MAGIC))) {
+		fprintf(stderr, "ERROR: %s is not a profile recorded by evmi\n", file_path);
+		exit(1);
+	}
+
+	if (program_size != easm->program_size || hash != inst_program_hash(easm->program, easm->program_size)) {
+		fprintf(stderr, "ERROR: %s was recorded on a different program. Record it again on the output of this easm without -profile\n", file_path);
+		exit(1);
+	}
+
+	size_t line_number = 1;
+	while (content.count > 0) {
+		String_View line = sv_trim(sv_chop_by_delim(&content, '\n'));
+		line_number += 1;
+		if (line.count == 0) continue;
+
+		const uint64_t addr = sv_to_u64(sv_trim(sv_chop_by_delim(&line, ' ')));
+		const uint64_t count = sv_to_u64(sv_trim(sv_chop_by_delim(&line, ' ')));
+		const uint64_t taken = sv_to_u64(sv_trim(line));
+		if (addr >= program_size || taken > count) {
+			fprintf(stderr, "%s:%zu: ERROR: broken profile entry\n", file_path, line_number);
+			exit(1);
+		}
+
+		profile->counts[addr] = count;
+		profile->taken[addr] = taken;
+	}
+
+	arena_free(&arena);
+}
+
+#define EASM_NO_BLOCK ((size_t) -1)
+#define EASM_NO_ADDR ((Inst_Addr) -1)
+
+typedef struct {
+	Inst_Addr start;
+	Inst_Addr end;
+	size_t fall;		// block that runs next when the last instruction does not jump away
+	size_t jump;		// block the last instruction jumps to
+	size_t next;		// block placed right after this one
+	size_t prev;
+	size_t chain;
+	bool placed;
+} Easm_Block;
+
+typedef struct {
+	size_t from;
+	size_t to;
+	uint64_t weight;
+	bool is_fall;
+	bool is_required;
+} Easm_Edge;
+
+// NOTE: required edges go first, then the hot ones. Among equal weights falling through
+// wins, so the code that was never executed keeps its original order.
+static int easm_compare_edges(const void *a, const void *b) {
+	const Easm_Edge *x = a;
+	const Easm_Edge *y = b;
+	if (x->is_required != y->is_required) return x->is_required ? -1 : 1;
+	if (x->weight != y->weight) return x->weight > y->weight ? -1 : 1;
+	if (x->is_fall != y->is_fall) return x->is_fall ? -1 : 1;
+	if (x->from != y->from) return x->from < y->from ? -1 : 1;
+	return 0;
+}
+
+// NOTE: jmp_if_zero and jmp_lti have no opposites, their cold side gets an extra jmp instead
+static bool easm_is_invertible_jump(Inst_Type type) {
+	return type == INST_JMP_IF || type == INST_JMP_IF_NOT;
+}
+
+// NOTE: the blocks are chained along the hottest edges, so the common case falls through
+// instead of jumping. A call or a native has to be followed by the code it returns to.
+// Chains that never ran go to the end.
+void easm_layout_program(EASM *easm, const Evm_Profile *profile) {
+	if (easm->is_object || easm->has_label_arithmetic || easm->program_size == 0) return;
+
+	const uint64_t size = easm->program_size;
+	const Inst *program = easm->program;
+
+	bool *is_target = calloc(size + 1, sizeof(*is_target));
+	int *reloc = malloc(sizeof(*reloc) * (size + 1));
+	Easm_Block *blocks = malloc(sizeof(*blocks) * size);
+	size_t *block_of = malloc(sizeof(*block_of) * (size + 1));
+	Easm_Edge *edges = malloc(sizeof(*edges) * size * 2);
+	if (is_target == NULL || reloc == NULL || blocks == NULL || block_of == NULL || edges == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the code layout: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	easm_find_targets(easm, reloc, is_target);
+
+	size_t blocks_size = 0;
+	for (uint64_t start = 0; start < size;) {
+		const uint64_t end = easm_block_end(easm, is_target, start);
+		for (uint64_t i = start; i < end; ++i) block_of[i] = blocks_size;
+		blocks[blocks_size] = (Easm_Block) {
+			.start = start,
+			.end = end,
+			.fall = EASM_NO_BLOCK,
+			.jump = EASM_NO_BLOCK,
+			.next = EASM_NO_BLOCK,
+			.prev = EASM_NO_BLOCK,
+			.chain = blocks_size,
+		};
+		blocks_size += 1;
+		start = end;
+	}
+	block_of[size] = EASM_NO_BLOCK;
+
+	size_t edges_size = 0;
+	bool ok = true;
+	for (size_t b = 0; b < blocks_size; ++b) {
+		Easm_Block *block = &blocks[b];
+		const Inst_Addr last = block->end - 1;
+		const Inst inst = program[last];
+		const bool has_jump = (inst.type == INST_JMP || inst_is_conditional_jump(inst.type)) && reloc[last] != RELOC_SYMBOL;
+
+		if (has_jump && inst.operand.as_u64 < size) {
+			block->jump = block_of[inst.operand.as_u64];
+			// NOTE: placing the target of a jump that can not be inverted right after it
+			// only costs an extra jmp on the other side
+			if (inst.type == INST_JMP || easm_is_invertible_jump(inst.type)) {
+				edges[edges_size++] = (Easm_Edge) {
+					.from = b,
+					.to = block->jump,
+					.weight = inst.type == INST_JMP ? profile->counts[last] : profile->taken[last],
+				};
+			}
+		} else if (has_jump) {
+			// NOTE: jumping out of the program traps, better leave such code alone
+			ok = false;
+		}
+
+		if (inst.type != INST_JMP && inst.type != INST_RET && inst.type != INST_HALT) {
+			if (block->end == size) {
+				// NOTE: so does falling off the end
+				ok = false;
+				continue;
+			}
+			block->fall = b + 1;
+			edges[edges_size++] = (Easm_Edge) {
+				.from = b,
+				.to = b + 1,
+				.weight = profile->counts[last] - (inst_is_conditional_jump(inst.type) ? profile->taken[last] : 0),
+				.is_fall = true,
+				.is_required = inst.type == INST_CALL || inst.type == INST_NATIVE,
+			};
+		}
+	}
+
+	if (!ok) {
+		fprintf(stderr, "WARNING: the program may run off its code, the layout is left as it is\n");
+		free(is_target);
+		free(reloc);
+		free(blocks);
+		free(block_of);
+		free(edges);
+		return;
+	}
+
+	qsort(edges, edges_size, sizeof(*edges), easm_compare_edges);
+	for (size_t i = 0; i < edges_size; ++i) {
+		Easm_Block *from = &blocks[edges[i].from];
+		Easm_Block *to = &blocks[edges[i].to];
+		if (from->next != EASM_NO_BLOCK || to->prev != EASM_NO_BLOCK || from->chain == to->chain) continue;
+
+		from->next = edges[i].to;
+		to->prev = edges[i].from;
+		const size_t chain = to->chain;
+		for (size_t b = 0; b < blocks_size; ++b) {
+			if (blocks[b].chain == chain) blocks[b].chain = from->chain;
+		}
+	}
+
+	// Order of the chains: the one with the entry, the ones that ran, the rest
+	size_t *order = malloc(sizeof(*order) * blocks_size);
+	if (order == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the code layout: %s\n", strerror(errno));
+		exit(1);
+	}
+	size_t order_size = 0;
+	for (int pass = 0; pass < 3; ++pass) {
+		for (size_t b = 0; b < blocks_size; ++b) {
+			if (blocks[b].prev != EASM_NO_BLOCK || blocks[b].placed) continue;
+
+			bool has_entry = false;
+			bool has_run = false;
+			for (size_t c = b; c != EASM_NO_BLOCK; c = blocks[c].next) {
+				has_entry = has_entry || (easm->has_entry && easm->entry >= blocks[c].start && easm->entry < blocks[c].end);
+				has_run = has_run || profile->counts[blocks[c].start] > 0;
+			}
+			if ((pass == 0 && !has_entry) || (pass == 1 && !has_run)) continue;
+
+			for (size_t c = b; c != EASM_NO_BLOCK; c = blocks[c].next) {
+				blocks[c].placed = true;
+				order[order_size++] = c;
+			}
+		}
+	}
+	assert(order_size == blocks_size);
+
+	// NOTE: every block may grow by a `jmp`
+	Inst *new_program = malloc(sizeof(*new_program) * (size + blocks_size + 1));
+	bool *has_old_target = calloc(size + blocks_size + 1, sizeof(*has_old_target));
+	// NOTE: new_addr is where the control flow that reached an instruction goes now,
+	// moved_to is where the instruction itself went
+	Inst_Addr *new_addr = malloc(sizeof(*new_addr) * (size + 1));
+	Inst_Addr *moved_to = malloc(sizeof(*moved_to) * (size + 1));
+	if (new_program == NULL || has_old_target == NULL || new_addr == NULL || moved_to == NULL) {
+		fprintf(stderr, "ERROR: could not allocate memory for the code layout: %s\n", strerror(errno));
+		exit(1);
+	}
+
+	Inst_Addr next = 0;
+	for (size_t i = 0; i < order_size; ++i) {
+		const Easm_Block *block = &blocks[order[i]];
+		const size_t placed_next = i + 1 < order_size ? order[i + 1] : EASM_NO_BLOCK;
+		const Inst_Addr last = block->end - 1;
+
+		for (Inst_Addr addr = block->start; addr < block->end; ++addr) {
+			new_addr[addr] = next;
+			moved_to[addr] = EASM_NO_ADDR;
+			const Inst inst = program[addr];
+
+			// NOTE: the jump to the block that is placed right after is not needed anymore
+			if (addr == last && inst.type == INST_JMP && block->jump != EASM_NO_BLOCK && block->jump == placed_next) {
+				continue;
+			}
+
+			// NOTE: the hot path of a jmp_if has to fall through, so the condition is inverted
+			if (addr == last && easm_is_invertible_jump(inst.type) && block->jump == placed_next && block->fall != placed_next) {
+				moved_to[addr] = next;
+				new_program[next] = (Inst) {
+					.type = inst.type == INST_JMP_IF ? INST_JMP_IF_NOT : INST_JMP_IF,
+					.operand = word_u64(blocks[block->fall].start),
+				};
+				has_old_target[next++] = true;
+				continue;
+			}
+
+			const bool is_code_addr = reloc[addr] == RELOC_CODE
+				|| (easm_inst_has_code_operand(inst.type) && reloc[addr] != RELOC_SYMBOL);
+			has_old_target[next] = is_code_addr && inst.operand.as_u64 <= size;
+			moved_to[addr] = next;
+			new_program[next++] = inst;
+		}
+
+		if (block->fall != EASM_NO_BLOCK && block->fall != placed_next
+			&& !(easm_is_invertible_jump(program[last].type) && block->jump == placed_next)) {
+			assert(program[last].type != INST_CALL && program[last].type != INST_NATIVE);
+			new_program[next] = (Inst) { .type = INST_JMP, .operand = word_u64(blocks[block->fall].start) };
+			has_old_target[next++] = true;
+		}
+	}
+	new_addr[size] = next;
+
+	for (Inst_Addr i = 0; i < next; ++i) {
+		if (has_old_target[i]) new_program[i].operand.as_u64 = new_addr[new_program[i].operand.as_u64];
+	}
+
+	size_t relocations_size = 0;
+	for (size_t i = 0; i < easm->relocations_size; ++i) {
+		Relocation relocation = easm->relocations[i];
+		// NOTE: the jump that was dropped takes its relocation along
+		if (moved_to[relocation.addr] == EASM_NO_ADDR) continue;
+		relocation.addr = moved_to[relocation.addr];
+		easm->relocations[relocations_size++] = relocation;
+	}
+	easm->relocations_size = relocations_size;
+
+	size_t deferred_operands_size = 0;
+	for (size_t i = 0; i < easm->deferred_operands_size; ++i) {
+		Deferred_Operand operand = easm->deferred_operands[i];
+		if (moved_to[operand.addr] == EASM_NO_ADDR) continue;
+		operand.addr = moved_to[operand.addr];
+		easm->deferred_operands[deferred_operands_size++] = operand;
+	}
+	easm->deferred_operands_size = deferred_operands_size;
+
+	for (size_t i = 0; i < easm->bindings_size; ++i) {
+		Binding *binding = &easm->bindings[i];
+		if (binding->kind == BINDING_LABEL && binding->value.as_u64 <= size) {
+			binding->value.as_u64 = new_addr[binding->value.as_u64];
+		}
+	}
+
+	if (easm->has_entry && easm->entry <= size) {
+		easm->entry = new_addr[easm->entry];
+	}
+
+	free(easm->program);
+	easm->program = new_program;
+	easm->program_size = next;
+	easm->program_capacity = size + blocks_size + 1;
+
+	free(is_target);
+	free(reloc);
+	free(blocks);
+	free(block_of);
+	free(edges);
+	free(order);
+	free(has_old_target);
+	free(new_addr);
+	free(moved_to);
+}
+
+void easm_clean(EASM *easm) {
+	free(easm->bindings);
+	free(easm->binding_slots);
+	free(easm->deferred_operands);
+	free(easm->relocations);
+	free(easm->program);
+	free(easm->locations);
+	free(easm->memory);
+	free(easm->include_paths);
+	free(easm->included_files);
+	free(easm->macros);
+	free(easm->strings);
+	arena_free(&easm->arena);
+	memset(easm, 0, sizeof(*easm));
+}
+
 const char *binding_kind_as_cstr(Binding_Kind kind) {
     switch (kind) {
         case BINDING_CONST: return "const";
         case BINDING_LABEL: return "label";
         case BINDING_NATIVE: return "native";
+        case BINDING_DATA: return "data";
         default:
             UNREACHABLE("binding_kind_as_cstr: unreachable");
             exit(0);
@@ -1299,13 +4404,22 @@ bool easm_translate_literal(EASM *easm, String_View sv, Word *output) {
         	*output = word_u64((uint64_t) sv.data[1]);
 
         	return true;
-	} else if (sv.count >= 2 && *sv.data == '"' && sv.data[sv.count - 1] == '"') {
+	} else if (easm_is_string_literal(sv)) {
 		// TODO: string literals don't support escaped characters
         	sv.data += 1;
         	sv.count -= 2;
         	*output = easm_push_string_to_memory(easm, sv);
 	} else {
-		const char *cstr = arena_sv_to_cstr(&easm->arena, sv);
+		// NOTE: Most operands are short, keep them off the arena
+		char buffer[64];
+		const char *cstr = NULL;
+		if (sv.count < sizeof(buffer)) {
+			memcpy(buffer, sv.data, sv.count);
+			buffer[sv.count] = '\0';
+			cstr = buffer;
+		} else {
+			cstr = arena_sv_to_cstr(&easm->arena, sv);
+		}
 
 		char *endptr = 0;
 		Word result = { 0 };
@@ -1320,6 +4434,361 @@ bool easm_translate_literal(EASM *easm, String_View sv, Word *output) {
 	return true;
 }
 
+typedef struct {
+	EASM *easm;
+	String_View source;
+	File_Location location;
+} Expr_Parser;
+
+typedef struct {
+	const char *name;
+	int precedence;
+} Expr_Op;
+
+// NOTE: sorted so that `<<` and `>>` are matched before anything shorter
+static const Expr_Op expr_ops[] = {
+	{ "<<", 3 }, { ">>", 3 },
+	{ "|", 0 }, { "^", 1 }, { "&", 2 },
+	{ "+", 4 }, { "-", 4 },
+	{ "*", 5 }, { "/", 5 }, { "%", 5 },
+};
+
+static bool expr_is_name_char(char c) {
+	return isalnum((unsigned char) c) || c == '_' || c == '@' || c == '.';
+}
+
+static bool expr_accept(Expr_Parser *parser, const char *token) {
+	parser->source = sv_trim_left(parser->source);
+	const size_t n = strlen(token);
+	if (parser->source.count >= n && memcmp(parser->source.data, token, n) == 0) {
+		parser->source.count -= n;
+		parser->source.data += n;
+		return true;
+	}
+	return false;
+}
+
+static void expr_expect(Expr_Parser *parser, const char *token) {
+	if (!expr_accept(parser, token)) {
+		fprintf(stderr, FL_Fmt": ERROR: expected `%s` in constant expression\n", FL_Arg(parser->location), token);
+		exit(1);
+	}
+}
+
+static String_View expr_chop(Expr_Parser *parser, size_t n) {
+	String_View result = { .count = n, .data = parser->source.data };
+	parser->source.count -= n;
+	parser->source.data += n;
+	return result;
+}
+
+static double expr_as_f64(Expr_Value value) {
+	return value.is_float ? value.value.as_f64 : (double) value.value.as_i64;
+}
+
+static Expr_Value expr_parse_binary(Expr_Parser *parser, int precedence);
+
+static Expr_Value expr_parse_number(Expr_Parser *parser) {
+	const String_View source = parser->source;
+	size_t i = 0;
+	bool is_float = false;
+	int base = 10;
+
+	if (source.count > 2 && source.data[0] == '0' && (source.data[1] == 'x' || source.data[1] == 'X')) {
+		base = 16;
+		i = 2;
+		while (i < source.count && isxdigit((unsigned char) source.data[i])) i += 1;
+	} else {
+		while (i < source.count && isdigit((unsigned char) source.data[i])) i += 1;
+		if (i < source.count && source.data[i] == '.') {
+			is_float = true;
+			i += 1;
+			while (i < source.count && isdigit((unsigned char) source.data[i])) i += 1;
+		}
+		if (i < source.count && (source.data[i] == 'e' || source.data[i] == 'E')) {
+			is_float = true;
+			i += 1;
+			if (i < source.count && (source.data[i] == '+' || source.data[i] == '-')) i += 1;
+			while (i < source.count && isdigit((unsigned char) source.data[i])) i += 1;
+		}
+	}
+
+	const String_View number = expr_chop(parser, i);
+	char buffer[64];
+	if (number.count >= sizeof(buffer)) {
+		fprintf(stderr, FL_Fmt": ERROR: number `"SV_Fmt"` is too long\n", FL_Arg(parser->location), SV_Arg(number));
+		exit(1);
+	}
+	memcpy(buffer, number.data, number.count);
+	buffer[number.count] = '\0';
+
+	Expr_Value result = { .is_float = is_float };
+	char *endptr = NULL;
+	if (is_float) {
+		result.value.as_f64 = strtod(buffer, &endptr);
+	} else {
+		result.value.as_u64 = strtoull(buffer, &endptr, base);
+	}
+
+	if ((size_t) (endptr - buffer) != number.count) {
+		fprintf(stderr, FL_Fmt": ERROR: `"SV_Fmt"` is not a number\n", FL_Arg(parser->location), SV_Arg(number));
+		exit(1);
+	}
+
+	return result;
+}
+
+static Expr_Value expr_parse_sizeof(Expr_Parser *parser) {
+	expr_expect(parser, "(");
+	parser->source = sv_trim_left(parser->source);
+
+	Expr_Value result = { 0 };
+	if (parser->source.count > 0 && parser->source.data[0] == '"') {
+		const char *end = memchr(parser->source.data + 1, '"', parser->source.count - 1);
+		if (end == NULL) {
+			fprintf(stderr, FL_Fmt": ERROR: unterminated string literal\n", FL_Arg(parser->location));
+			exit(1);
+		}
+		result.value = word_u64((uint64_t) (end - parser->source.data - 1));
+		expr_chop(parser, (size_t) (end - parser->source.data + 1));
+	} else {
+		size_t n = 0;
+		while (n < parser->source.count && expr_is_name_char(parser->source.data[n])) n += 1;
+		const String_View name = expr_chop(parser, n);
+
+		Binding binding = { 0 };
+		if (!easm_resolve_binding(parser->easm, name, &binding)) {
+			fprintf(stderr, FL_Fmt": ERROR: unknown name `"SV_Fmt"` in constant expression\n", FL_Arg(parser->location), SV_Arg(name));
+			exit(1);
+		}
+		if (binding.kind != BINDING_DATA) {
+			fprintf(stderr, FL_Fmt": ERROR: sizeof expects a string, but `"SV_Fmt"` is %s\n", FL_Arg(parser->location), SV_Arg(name), binding_kind_as_cstr(binding.kind));
+			fprintf(stderr, FL_Fmt": NOTE: `"SV_Fmt"` is defined here\n", FL_Arg(binding.location), SV_Arg(name));
+			exit(1);
+		}
+		result.value = word_u64(binding.size);
+	}
+
+	expr_expect(parser, ")");
+	return result;
+}
+
+static Expr_Value expr_parse_primary(Expr_Parser *parser) {
+	parser->source = sv_trim_left(parser->source);
+	if (parser->source.count == 0) {
+		fprintf(stderr, FL_Fmt": ERROR: unexpected end of constant expression\n", FL_Arg(parser->location));
+		exit(1);
+	}
+
+	const char c = parser->source.data[0];
+	if (expr_accept(parser, "(")) {
+		Expr_Value result = expr_parse_binary(parser, 0);
+		expr_expect(parser, ")");
+		return result;
+	} else if (c == '\'' || c == '"') {
+		const char *end = parser->source.count > 1 ? memchr(parser->source.data + 1, c, parser->source.count - 1) : NULL;
+		if (end == NULL) {
+			fprintf(stderr, FL_Fmt": ERROR: unterminated literal in constant expression\n", FL_Arg(parser->location));
+			exit(1);
+		}
+
+		const String_View literal = expr_chop(parser, (size_t) (end - parser->source.data + 1));
+		Expr_Value result = { 0 };
+		if (!easm_translate_literal(parser->easm, literal, &result.value)) {
+			fprintf(stderr, FL_Fmt": ERROR: `"SV_Fmt"` is not a valid literal\n", FL_Arg(parser->location), SV_Arg(literal));
+			exit(1);
+		}
+		if (c == '"') {
+			result.data_refs = 1;
+			result.size = literal.count - 2;
+		}
+		return result;
+	} else if (isdigit((unsigned char) c) || c == '.') {
+		return expr_parse_number(parser);
+	} else if (expr_is_name_char(c)) {
+		size_t n = 0;
+		while (n < parser->source.count && expr_is_name_char(parser->source.data[n])) n += 1;
+		const String_View name = expr_chop(parser, n);
+
+		if (sv_eq(name, sv_from_cstr("sizeof"))) {
+			return expr_parse_sizeof(parser);
+		}
+
+		Binding binding = { 0 };
+		if (!easm_resolve_binding(parser->easm, name, &binding)) {
+			fprintf(stderr, FL_Fmt": ERROR: unknown name `"SV_Fmt"` in constant expression\n", FL_Arg(parser->location), SV_Arg(name));
+			exit(1);
+		}
+
+		Expr_Value result = { .value = binding.value, .is_float = binding.is_float };
+		switch (binding.kind) {
+			case BINDING_CONST: break;
+			case BINDING_LABEL:
+				result.code_refs = 1;
+				result.uses_labels = true;
+			break;
+			case BINDING_DATA:
+				result.data_refs = 1;
+				result.size = binding.size;
+			break;
+			case BINDING_NATIVE:
+				fprintf(stderr, FL_Fmt": ERROR: native `"SV_Fmt"` can not be used in constant expressions\n", FL_Arg(parser->location), SV_Arg(name));
+				exit(1);
+			default: UNREACHABLE("NOT EXISTING BINDING_KIND");
+		}
+		return result;
+	}
+
+	fprintf(stderr, FL_Fmt": ERROR: unexpected `%c` in constant expression\n", FL_Arg(parser->location), c);
+	exit(1);
+}
+
+static Expr_Value expr_parse_unary(Expr_Parser *parser) {
+	if (expr_accept(parser, "-")) {
+		Expr_Value result = expr_parse_unary(parser);
+		if (result.is_float) {
+			result.value.as_f64 = -result.value.as_f64;
+		} else {
+			result.value.as_u64 = 0 - result.value.as_u64;
+		}
+		result.code_refs = -result.code_refs;
+		result.data_refs = -result.data_refs;
+		result.size = 0;
+		return result;
+	} else if (expr_accept(parser, "~")) {
+		Expr_Value result = expr_parse_unary(parser);
+		if (result.is_float) {
+			fprintf(stderr, FL_Fmt": ERROR: operator `~` is not defined for floats\n", FL_Arg(parser->location));
+			exit(1);
+		}
+		result.value.as_u64 = ~result.value.as_u64;
+		result.is_scaled = result.is_scaled || result.code_refs != 0 || result.data_refs != 0;
+		result.size = 0;
+		return result;
+	} else if (expr_accept(parser, "+")) {
+		return expr_parse_unary(parser);
+	}
+
+	return expr_parse_primary(parser);
+}
+
+static Expr_Value expr_apply(Expr_Parser *parser, const char *op, Expr_Value a, Expr_Value b) {
+	Expr_Value result = {
+		.is_float = a.is_float || b.is_float,
+		.is_scaled = a.is_scaled || b.is_scaled,
+		.uses_labels = a.uses_labels || b.uses_labels,
+	};
+
+	if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0) {
+		const int64_t sign = op[0] == '+' ? 1 : -1;
+		result.code_refs = a.code_refs + sign * b.code_refs;
+		result.data_refs = a.data_refs + sign * b.data_refs;
+	} else if (a.code_refs != 0 || a.data_refs != 0 || b.code_refs != 0 || b.data_refs != 0) {
+		result.is_scaled = true;
+	}
+
+	if (result.is_float) {
+		const double x = expr_as_f64(a);
+		const double y = expr_as_f64(b);
+		switch (op[0]) {
+			case '+': result.value.as_f64 = x + y; break;
+			case '-': result.value.as_f64 = x - y; break;
+			case '*': result.value.as_f64 = x * y; break;
+			case '/': result.value.as_f64 = x / y; break;
+			default:
+				fprintf(stderr, FL_Fmt": ERROR: operator `%s` is not defined for floats\n", FL_Arg(parser->location), op);
+				exit(1);
+		}
+		return result;
+	}
+
+	const uint64_t x = a.value.as_u64;
+	const uint64_t y = b.value.as_u64;
+	if ((op[0] == '/' || op[0] == '%') && y == 0) {
+		fprintf(stderr, FL_Fmt": ERROR: division by zero in constant expression\n", FL_Arg(parser->location));
+		exit(1);
+	}
+	if ((op[0] == '/' || op[0] == '%') && a.value.as_i64 == INT64_MIN && b.value.as_i64 == -1) {
+		fprintf(stderr, FL_Fmt": ERROR: signed overflow of %ld %s -1 in constant expression\n", FL_Arg(parser->location), a.value.as_i64, op);
+		exit(1);
+	}
+
+	// NOTE: `/` and `%` are signed, just like divi/modi. `>>` is logical.
+	switch (op[0]) {
+		case '+': result.value.as_u64 = x + y; break;
+		case '-': result.value.as_u64 = x - y; break;
+		case '*': result.value.as_u64 = x * y; break;
+		case '/': result.value.as_i64 = a.value.as_i64 / b.value.as_i64; break;
+		case '%': result.value.as_i64 = a.value.as_i64 % b.value.as_i64; break;
+		case '&': result.value.as_u64 = x & y; break;
+		case '|': result.value.as_u64 = x | y; break;
+		case '^': result.value.as_u64 = x ^ y; break;
+		case '<': result.value.as_u64 = y < 64 ? x << y : 0; break;
+		case '>': result.value.as_u64 = y < 64 ? x >> y : 0; break;
+		default: UNREACHABLE("NOT EXISTING EXPRESSION OPERATOR");
+	}
+	return result;
+}
+
+static Expr_Value expr_parse_binary(Expr_Parser *parser, int precedence) {
+	Expr_Value lhs = expr_parse_unary(parser);
+
+	for (;;) {
+		const Expr_Op *op = NULL;
+		for (size_t i = 0; i < sizeof(expr_ops) / sizeof(expr_ops[0]); ++i) {
+			if (expr_ops[i].precedence >= precedence && expr_accept(parser, expr_ops[i].name)) {
+				op = &expr_ops[i];
+				break;
+			}
+		}
+		if (op == NULL) return lhs;
+
+		const Expr_Value rhs = expr_parse_binary(parser, op->precedence + 1);
+		lhs = expr_apply(parser, op->name, lhs, rhs);
+	}
+}
+
+Expr_Value easm_eval_expr(EASM *easm, String_View sv, File_Location location) {
+	Expr_Parser parser = {
+		.easm = easm,
+		.source = sv,
+		.location = location,
+	};
+
+	Expr_Value result = expr_parse_binary(&parser, 0);
+	parser.source = sv_trim(parser.source);
+	if (parser.source.count > 0) {
+		fprintf(stderr, FL_Fmt": ERROR: unexpected `"SV_Fmt"` in constant expression\n", FL_Arg(location), SV_Arg(parser.source));
+		exit(1);
+	}
+	return result;
+}
+
+bool easm_expr_relocation(EASM *easm, Expr_Value value, File_Location location, Reloc_Kind *kind) {
+	if (!value.is_scaled && value.code_refs == 0 && value.data_refs == 0) {
+		if (value.uses_labels) easm->has_label_arithmetic = true;
+		return false;
+	}
+
+	if (!value.is_scaled && value.code_refs == 1 && value.data_refs == 0) {
+		*kind = RELOC_CODE;
+		return true;
+	}
+
+	if (!value.is_scaled && value.code_refs == 0 && value.data_refs == 1) {
+		*kind = RELOC_DATA;
+		return true;
+	}
+
+	// NOTE: in an executable the layout is final, only the linker can not move such values
+	if (easm->is_object) {
+		fprintf(stderr, FL_Fmt": ERROR: the value of the expression can not be relocated by the linker\n", FL_Arg(location));
+		exit(1);
+	}
+	if (value.uses_labels) easm->has_label_arithmetic = true;
+	return false;
+}
+
 String_View arena_slurp_file(Arena *arena, String_View file_path) {
 	const char *file_path_cstr = arena_sv_to_cstr(arena, file_path);
 	FILE *f = fopen(file_path_cstr, "r");
@@ -1396,6 +4865,9 @@ String_View arena_sv_concat2(Arena *arena, const char *a, const char *b) {
 
 void evm_load_standard_natives(EVM *evm) {
 	evm_push_native(evm, evm_write);	// 0
+	evm_push_native(evm, evm_native_clock);	// 1
+	evm_push_native(evm, evm_native_insts);	// 2
+	evm_push_native(evm, evm_native_region);	// 3
 }
 
 Err evm_write(EVM *evm) {
@@ -1412,4 +4884,38 @@ Err evm_write(EVM *evm) {
 	return ERR_OK;
 }
 
+// NOTE: monotonic nanoseconds, only the difference of two readings means anything
+uint64_t evm_clock_ns(void) {
+	struct timespec ts;
+#ifdef _WIN32
+	timespec_get(&ts, TIME_UTC);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif // _WIN32
+	return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+Err evm_native_clock(EVM *evm) {
+	if (evm->stack_size >= EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	evm->stack[evm->stack_size++].as_u64 = evm_clock_ns();
+	return ERR_OK;
+}
+
+Err evm_native_insts(EVM *evm) {
+	if (evm->stack_size >= EVM_STACK_CAPACITY) return ERR_STACK_OVERFLOW;
+	evm->stack[evm->stack_size++].as_u64 = evm->insts;
+	return ERR_OK;
+}
+
+// NOTE: (ns insts) a timed region of the program took, printed one per line. `evmi -bench`
+// puts them into the json instead, its output is thrown away
+Err evm_native_region(EVM *evm) {
+	if (evm->stack_size < 2) return ERR_STACK_UNDERFLOW;
+	const uint64_t insts = evm->stack[evm->stack_size - 1].as_u64;
+	const uint64_t ns = evm->stack[evm->stack_size - 2].as_u64;
+	evm->stack_size -= 2;
+	printf("%lu\n%lu\n", insts, ns);
+	return ERR_OK;
+}
+
 #endif //EVM_IMPLEMENTATION
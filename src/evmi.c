@@ -1,14 +1,180 @@
-#define EVM_IMPLEMENTATION
 #include "./evm.h"
 
-int main(int argc, char **argv) {
-	if (argc < 2) {
-		fprintf(stderr, "Usage: ./evmi <input.evm>\n");
-		fprintf(stderr, "ERROR: expected input and output\n");
+#define BENCH_WARMUP_RUNS 1
+#define BENCH_DEFAULT_REPS 10
+
+static char *shift(int *argc, char ***argv) {
+	assert(*argc > 0);
+	char *result = **argv;
+	*argv += 1;
+	*argc -= 1;
+	return result;
+}
+
+static void usage(FILE *stream, const char *program) {
+	fprintf(stream, "Usage: %s [-profile <output.prof>] [-quiet] [-bench <output.json>] [-reps <n>] <input.evm>\n", program);
+	fprintf(stream, "  -profile <output.prof>\n");
+	fprintf(stream, "        count how many times every instruction runs, `easm -profile` lays the code out by it\n");
+	fprintf(stream, "  -quiet\n");
+	fprintf(stream, "        discard what the program writes\n");
+	fprintf(stream, "  -bench <output.json>\n");
+	fprintf(stream, "        run the program once to warm up and then -reps times with its output discarded,\n");
+	fprintf(stream, "        the wall time, ns/instruction and instructions/second go to the json along with\n");
+	fprintf(stream, "        the instructions and the time of what the program reported by `native region`\n");
+	fprintf(stream, "  -reps <n>\n");
+	fprintf(stream, "        how many timed runs -bench does (default %d)\n", BENCH_DEFAULT_REPS);
+}
+
+// NOTE: `native write` of the benchmarks, the terminal would be measured instead of the VM.
+// -quiet uses it too, a profile run is only after the counts
+static Err bench_write(EVM *evm) {
+	if (evm->stack_size < 2) return ERR_STACK_UNDERFLOW;
+	evm->stack_size -= 2;
+	return ERR_OK;
+}
+
+// NOTE: `native region` of the benchmarks, what the timed regions of a run took in total
+static uint64_t bench_region_insts = 0;
+static uint64_t bench_region_ns = 0;
+static bool bench_has_region = false;
+
+static Err bench_region(EVM *evm) {
+	if (evm->stack_size < 2) return ERR_STACK_UNDERFLOW;
+	bench_region_insts += evm->stack[evm->stack_size - 1].as_u64;
+	bench_region_ns += evm->stack[evm->stack_size - 2].as_u64;
+	bench_has_region = true;
+	evm->stack_size -= 2;
+	return ERR_OK;
+}
+
+static int compare_u64(const void *a, const void *b) {
+	const uint64_t x = *(const uint64_t *) a;
+	const uint64_t y = *(const uint64_t *) b;
+	return (x > y) - (x < y);
+}
+
+static void bench_program(const EVM *loaded, const char *input_file_path, const char *bench_file_path, size_t reps) {
+	static EVM evm = { 0 };
+	uint64_t *wall_ns = malloc(sizeof(wall_ns[0]) * reps);
+	uint64_t *region_ns = malloc(sizeof(region_ns[0]) * reps);
+	assert(wall_ns != NULL && region_ns != NULL);
+	uint64_t insts = 0;
+
+	for (size_t i = 0; i < reps + BENCH_WARMUP_RUNS; ++i) {
+		memcpy(&evm, loaded, sizeof(evm));
+		evm.natives[0] = bench_write;
+		evm.natives[3] = bench_region;
+		bench_region_insts = 0;
+		bench_region_ns = 0;
+
+		const uint64_t start = evm_clock_ns();
+		const Err err = evm_execute_program(&evm, -1);
+		const uint64_t end = evm_clock_ns();
+
+		if (err != ERR_OK) {
+			fprintf(stderr, "Trap activated: %s\n", err_as_cstr(err));
+			exit(1);
+		}
+
+		if (i >= BENCH_WARMUP_RUNS) {
+			wall_ns[i - BENCH_WARMUP_RUNS] = end - start;
+			region_ns[i - BENCH_WARMUP_RUNS] = bench_region_ns;
+		}
+		insts = evm.insts;
+	}
+
+	uint64_t total = 0;
+	for (size_t i = 0; i < reps; ++i) total += wall_ns[i];
+	qsort(wall_ns, reps, sizeof(wall_ns[0]), compare_u64);
+	qsort(region_ns, reps, sizeof(region_ns[0]), compare_u64);
+
+	// NOTE: the per instruction figures come from the fastest run, the others only add noise
+	const uint64_t min = wall_ns[0];
+	const double ns_per_inst = insts > 0 ? (double) min / (double) insts : 0.0;
+	const double insts_per_sec = min > 0 ? (double) insts * 1e9 / (double) min : 0.0;
+
+	FILE *f = fopen(bench_file_path, "w");
+	if (f == NULL) {
+		fprintf(stderr, "ERROR: Could not open file %s: %s\n", bench_file_path, strerror(errno));
 		exit(1);
 	}
 
-	const char *input_file_path = argv[1];
+	fprintf(f, "{\n");
+	fprintf(f, "  \"program\": \"%s\",\n", input_file_path);
+	fprintf(f, "  \"warmup\": %d,\n", BENCH_WARMUP_RUNS);
+	fprintf(f, "  \"reps\": %zu,\n", reps);
+	fprintf(f, "  \"insts\": %lu,\n", insts);
+	fprintf(f, "  \"wall_ns\": { \"min\": %lu, \"median\": %lu, \"mean\": %lu, \"max\": %lu },\n",
+		min, wall_ns[reps / 2], total / reps, wall_ns[reps - 1]);
+	fprintf(f, "  \"ns_per_inst\": %.3f,\n", ns_per_inst);
+	fprintf(f, "  \"insts_per_sec\": %.0f%s\n", insts_per_sec, bench_has_region ? "," : "");
+	// NOTE: the region leaves out the setup and the printing, it is what the program measures
+	if (bench_has_region) {
+		fprintf(f, "  \"region\": { \"insts\": %lu, \"wall_ns\": { \"min\": %lu, \"median\": %lu }, \"ns_per_inst\": %.3f }\n",
+			bench_region_insts, region_ns[0], region_ns[reps / 2],
+			bench_region_insts > 0 ? (double) region_ns[0] / (double) bench_region_insts : 0.0);
+	}
+	fprintf(f, "}\n");
+
+	fclose(f);
+	free(wall_ns);
+	free(region_ns);
+}
+
+int main(int argc, char **argv) {
+	const char *program = shift(&argc, &argv);
+	const char *input_file_path = NULL;
+	const char *profile_file_path = NULL;
+	const char *bench_file_path = NULL;
+	size_t reps = BENCH_DEFAULT_REPS;
+	bool quiet = false;
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+		if (strcmp(flag, "-profile") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			profile_file_path = shift(&argc, &argv);
+		} else if (strcmp(flag, "-quiet") == 0) {
+			quiet = true;
+		} else if (strcmp(flag, "-bench") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			bench_file_path = shift(&argc, &argv);
+		} else if (strcmp(flag, "-reps") == 0) {
+			if (argc == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: no value provided for flag `%s`\n", flag);
+				exit(1);
+			}
+			const char *value = shift(&argc, &argv);
+			char *end = NULL;
+			reps = strtoul(value, &end, 10);
+			if (*value == '\0' || *end != '\0' || reps == 0) {
+				usage(stderr, program);
+				fprintf(stderr, "ERROR: `%s` is not a positive number of repetitions\n", value);
+				exit(1);
+			}
+		} else if (input_file_path == NULL) {
+			input_file_path = flag;
+		} else {
+			usage(stderr, program);
+			fprintf(stderr, "ERROR: unexpected argument `%s`\n", flag);
+			exit(1);
+		}
+	}
+
+	if (input_file_path == NULL) {
+		usage(stderr, program);
+		fprintf(stderr, "ERROR: expected input\n");
+		exit(1);
+	}
 
 	int limit = -1; // NO LIMIT
 	// NOTE: The structure might be quite big due its arena. Better allocate it in the static memory.
@@ -16,8 +182,22 @@ int main(int argc, char **argv) {
 
 	evm_load_program_from_file(&evm, input_file_path);
 	evm_load_standard_natives(&evm);
+	if (quiet) evm.natives[0] = bench_write;
+
+	if (bench_file_path != NULL) {
+		bench_program(&evm, input_file_path, bench_file_path, reps);
+		return 0;
+	}
 
-	Err err = evm_execute_program(&evm , limit);
+	Err err = ERR_OK;
+	if (profile_file_path != NULL) {
+		static Evm_Profile profile = { 0 };
+		err = evm_execute_program_profiled(&evm, limit, &profile);
+		// NOTE: a trap is still worth a profile, it shows the way to it
+		evm_save_profile_to_file(&evm, &profile, profile_file_path);
+	} else {
+		err = evm_execute_program(&evm , limit);
+	}
 
 	if (err != ERR_OK) {
 		fprintf(stderr, "Trap activated: %s\n", err_as_cstr(err));
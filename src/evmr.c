@@ -1,7 +1,12 @@
-#define EVM_IMPLEMENTATION
 #include "./evm.h"
 
 #include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 static void panic(const char *fmt, ...) {
 	fprintf(stderr, "ERROR: ");
@@ -27,15 +32,70 @@ static void panic_errno(const char *fmt, ...) {
 	exit(1);
 }
 
-static Arena actual_arena = {0};
+// NOTE: the reports of the tests, they are printed only once all of them ran
+typedef struct {
+	char *data;
+	size_t size;
+	size_t capacity;
+} Output_Buffer;
+
+static void output_buffer_append(Output_Buffer *buffer, const void *data, size_t count) {
+	if (buffer->size + count > buffer->capacity) {
+		size_t new_capacity = buffer->capacity == 0 ? 1024 : buffer->capacity;
+		while (buffer->size + count > new_capacity) new_capacity *= 2;
+		buffer->data = realloc(buffer->data, new_capacity);
+		if (buffer->data == NULL) panic_errno("could not grow output buffer");
+		buffer->capacity = new_capacity;
+	}
 
-static String_View sv_from_arena(Arena *arena) {
-    	return (String_View) {
-        	.count = arena->size,
-        	.data = arena->buffer,
-    	};
+	memcpy(buffer->data + buffer->size, data, count);
+	buffer->size += count;
 }
 
+static void output_buffer_printf(Output_Buffer *buffer, const char *fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	const int n = vsnprintf(NULL, 0, fmt, args);
+	va_end(args);
+	assert(n >= 0);
+
+	char *line = malloc((size_t) n + 1);
+	if (line == NULL) panic_errno("could not allocate a report line");
+	va_start(args, fmt);
+	vsnprintf(line, (size_t) n + 1, fmt, args);
+	va_end(args);
+
+	output_buffer_append(buffer, line, (size_t) n);
+	free(line);
+}
+
+// NOTE: the expected output is mapped and every write is compared with it as it happens,
+// so the first wrong byte stops the program and the memory does not grow with the output
+typedef struct {
+	const char *file_path;
+	const char *expected;
+	size_t expected_size;
+	size_t position;
+	bool failed;
+} Output_Checker;
+
+// NOTE: a VM with where its output goes. The EVM comes first so evmr_write, which only gets
+// the EVM, finds the output of its own machine when many of them run at once.
+typedef struct {
+	EVM evm;
+	Output_Checker *checker;
+	FILE *actual_output;
+	Output_Buffer *report;
+} Evmr_Machine;
+
+// NOTE: what a single run takes, from the command line or from a line of -suite
+typedef struct {
+	const char *program_file_path;
+	const char *native_file_path;
+	const char *actual_output_file_path;
+	const char *expected_output_file_path;
+	const char *expected_error_file_path;
+} Evmr_Test;
 
 static char *shift(int *argc, char ***argv) {
     	assert(*argc > 0);
@@ -54,7 +114,154 @@ static const char *parse_cstr_value(const char *flag, int *argc, char ***argv) {
 }
 
 static void usage(FILE *stream) {
-    	fprintf(stream, "Usage: ./evmr -p <program.evm> [-ao <actual-output.txt>] [-eo <expected-output.txt>]\n");
+    	fprintf(stream, "Usage: ./evmr -p <program.evm> [-ao <actual-output.txt>] [-eo <expected-output.txt>] [-ee <expected-error.txt>]\n");
+    	fprintf(stream, "       ./evmr -x <native-executable> [-ao <actual-output.txt>] [-eo <expected-output.txt>] [-ee <expected-error.txt>]\n");
+    	fprintf(stream, "  -ee <expected-error.txt>\n");
+    	fprintf(stream, "        the Err the program has to stop with, like ERR_STACK_OVERFLOW. A native executable\n");
+    	fprintf(stream, "        reports it as its exit code\n");
+    	fprintf(stream, "       ./evmr -suite <tests.txt> [-j <threads>]\n");
+    	fprintf(stream, "  -suite <tests.txt>\n");
+    	fprintf(stream, "        every line holds the flags of one run, they all run at once on -j threads\n");
+    	fprintf(stream, "        (the number of CPUs by default) and the failures are reported at the end\n");
+}
+
+static const char **test_flag(Evmr_Test *test, const char *flag) {
+	if (strcmp(flag, "-p") == 0) return &test->program_file_path;
+	if (strcmp(flag, "-x") == 0) return &test->native_file_path;
+	if (strcmp(flag, "-ao") == 0) return &test->actual_output_file_path;
+	if (strcmp(flag, "-eo") == 0) return &test->expected_output_file_path;
+	if (strcmp(flag, "-ee") == 0) return &test->expected_error_file_path;
+	return NULL;
+}
+
+static const char *test_error(const Evmr_Test *test) {
+	if ((test->program_file_path == NULL) == (test->native_file_path == NULL)) {
+		return "exactly one of -p or -x is expected";
+	}
+
+	if (test->actual_output_file_path == NULL && test->expected_output_file_path == NULL) {
+		return "at least -ao or -eo is expected";
+	}
+
+	return NULL;
+}
+
+static bool output_checker_open(Output_Checker *checker, const char *file_path, Output_Buffer *report) {
+	memset(checker, 0, sizeof(*checker));
+	checker->file_path = file_path;
+
+	const int fd = open(file_path, O_RDONLY);
+	if (fd < 0) {
+		output_buffer_printf(report, "ERROR: could not open file `%s`: %s\n", file_path, strerror(errno));
+		return false;
+	}
+
+	struct stat statbuf = {0};
+	if (fstat(fd, &statbuf) < 0) {
+		output_buffer_printf(report, "ERROR: could not get the size of `%s`: %s\n", file_path, strerror(errno));
+		close(fd);
+		return false;
+	}
+
+	// NOTE: a mapping can not be empty, an empty output needs none
+	checker->expected_size = (size_t) statbuf.st_size;
+	if (checker->expected_size > 0) {
+		void *expected = mmap(NULL, checker->expected_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (expected == MAP_FAILED) {
+			output_buffer_printf(report, "ERROR: could not map `%s`: %s\n", file_path, strerror(errno));
+			close(fd);
+			return false;
+		}
+		// NOTE: read once from the start to the end, the pages behind can go
+		madvise(expected, checker->expected_size, MADV_SEQUENTIAL);
+		checker->expected = expected;
+	}
+
+	close(fd);
+	return true;
+}
+
+static void output_checker_close(Output_Checker *checker) {
+	if (checker->expected_size > 0) munmap((void *) checker->expected, checker->expected_size);
+}
+
+// NOTE: the line of the expected output around the position, 1 based
+static size_t output_checker_line(const Output_Checker *checker, size_t position, String_View *line) {
+	size_t line_number = 1;
+	size_t line_start = 0;
+	for (size_t i = 0; i < position && i < checker->expected_size; ++i) {
+		if (checker->expected[i] == '\n') {
+			line_number += 1;
+			line_start = i + 1;
+		}
+	}
+
+	size_t line_end = line_start;
+	while (line_end < checker->expected_size && checker->expected[line_end] != '\n') line_end += 1;
+
+	*line = (String_View) {
+		.count = line_end - line_start,
+		.data = checker->expected + line_start,
+	};
+	return line_number;
+}
+
+// NOTE: false as soon as a byte differs from the expected one, the report shows the line
+// it is in. The actual line is what matched of it followed by the rest of the chunk.
+static bool output_checker_feed(Output_Checker *checker, const char *data, size_t count, Output_Buffer *report) {
+	const size_t remaining = checker->expected_size - checker->position;
+	const size_t n = count < remaining ? count : remaining;
+	if (n == count && memcmp(checker->expected + checker->position, data, n) == 0) {
+		checker->position += n;
+		return true;
+	}
+
+	size_t i = 0;
+	while (i < n && checker->expected[checker->position + i] == data[i]) i += 1;
+
+	const size_t position = checker->position + i;
+	String_View expected_line = {0};
+	const size_t line_number = output_checker_line(checker, position, &expected_line);
+	const size_t matched = position - (size_t) (expected_line.data - checker->expected);
+
+	size_t rest = i;
+	while (rest < count && data[rest] != '\n') rest += 1;
+
+	if (position >= checker->expected_size) {
+		output_buffer_printf(report, "%s:%zu: ERROR: Actual output is bigger\n", checker->file_path, line_number);
+	} else {
+		output_buffer_printf(report, "%s:%zu: ERROR: Expected output differs from the actual one.\n", checker->file_path, line_number);
+	}
+	output_buffer_printf(report, "    Expected line: `"SV_Fmt"`\n", SV_Arg(expected_line));
+	output_buffer_printf(report, "    Actual   line: `%.*s%.*s`\n",
+		(int) matched, expected_line.data, (int) (rest - i), data + i);
+	output_buffer_printf(report, "    First wrong byte at offset %zu\n", position);
+
+	checker->position = position;
+	checker->failed = true;
+	return false;
+}
+
+// NOTE: at the end of the output all of the expected one has to be there
+static bool output_checker_finish(Output_Checker *checker, Output_Buffer *report) {
+	if (checker->failed) return false;
+	if (checker->position == checker->expected_size) return true;
+
+	String_View expected_line = {0};
+	const size_t line_number = output_checker_line(checker, checker->position, &expected_line);
+	output_buffer_printf(report, "%s:%zu: ERROR: Expected output is bigger\n", checker->file_path, line_number);
+	output_buffer_printf(report, "    Expected line: `"SV_Fmt"`\n", SV_Arg(expected_line));
+	checker->failed = true;
+	return false;
+}
+
+static bool write_actual_output(FILE *actual_output, const char *data, size_t count, Output_Buffer *report) {
+	fwrite(data, sizeof(data[0]), count, actual_output);
+	if (ferror(actual_output)) {
+		output_buffer_printf(report, "ERROR: could not save output: %s\n", strerror(errno));
+		return false;
+	}
+	return true;
 }
 
 static Err evmr_write(EVM *evm) {
@@ -66,102 +273,292 @@ static Err evmr_write(EVM *evm) {
     	if (addr >= EVM_MEMORY_CAPACITY) return ERR_ILLEGAL_MEMORY_ACCESS;
     	if (addr + count < addr || addr + count >= EVM_MEMORY_CAPACITY) return ERR_ILLEGAL_MEMORY_ACCESS;
 
-    	char *chunk = arena_alloc(&actual_arena, count);
-    	memcpy(chunk, &evm->memory[addr], count);
+    	Evmr_Machine *machine = (Evmr_Machine *) evm;
+    	const char *data = (const char *) &evm->memory[addr];
 
     	evm->stack_size -= 2;
 
+    	// NOTE: a write that went wrong halts the program right there, the report tells why
+    	if (machine->actual_output && !write_actual_output(machine->actual_output, data, count, machine->report)) {
+    		evm->halt = true;
+    		return ERR_OK;
+    	}
+
+    	if (machine->checker && !output_checker_feed(machine->checker, data, count, machine->report)) {
+    		output_buffer_printf(machine->report, "    Written by the instruction %lu", evm->ip);
+    		for (uint64_t i = evm->ret_stack_size; i > 0; --i) {
+    			output_buffer_printf(machine->report, ", called from %lu", evm->ret_stack[i - 1].ret - 1);
+    		}
+    		output_buffer_printf(machine->report, "\n");
+    		evm->halt = true;
+    	}
+
     	return ERR_OK;
 }
 
-static void compare_outputs(const char *file_path, String_View expected, String_View actual) {
-    	for (size_t line_number = 1; expected.count > 0 && actual.count > 0; ++line_number) {
-        	String_View expected_line = sv_chop_by_delim(&expected, '\n');
-        	String_View actual_line = sv_chop_by_delim(&actual, '\n');
+// NOTE: executables built by easm2nasm write straight to stdout, their output is taken
+// from a pipe and checked exactly like the one of the VM
+static bool run_native_executable(const char *file_path, Evmr_Machine *machine, Err *err) {
+	FILE *pipe = popen(file_path, "r");
+	if (pipe == NULL) {
+		output_buffer_printf(machine->report, "ERROR: could not run `%s`: %s\n", file_path, strerror(errno));
+		return false;
+	}
 
-        	if (!sv_eq(expected_line, actual_line)) {
-			fprintf(stderr, "%s:%zu: ERROR: Expected output differs from the actual one.\n", file_path, line_number);
-            		fprintf(stderr, "    Expected line: `"SV_Fmt"`\n", SV_Arg(expected_line));
-            		fprintf(stderr, "    Actual   line: `"SV_Fmt"`\n", SV_Arg(actual_line));
-	    		exit(1);
-        	}
-    	}
+	bool ok = true;
+	char chunk[4096];
+	size_t n = 0;
+	while (ok && (n = fread(chunk, sizeof(chunk[0]), sizeof(chunk), pipe)) > 0) {
+		if (machine->actual_output) ok = write_actual_output(machine->actual_output, chunk, n, machine->report);
+		if (ok && machine->checker) ok = output_checker_feed(machine->checker, chunk, n, machine->report);
+	}
 
-    	if (expected.count > 0) {
-        	panic("Expected output is bigger");
-    	}
+	// NOTE: after a mismatch the executable is not read any further and dies on the closed pipe.
+	// Otherwise its exit code is the Err it stopped with, like the VM would
+	const int status = pclose(pipe);
+	if (ok && status != 0) {
+		if (!WIFEXITED(status) || WEXITSTATUS(status) > ERR_BREAKPOINT) {
+			output_buffer_printf(machine->report, "ERROR: `%s` exited with status %d\n", file_path, status);
+			return false;
+		}
+		*err = (Err) WEXITSTATUS(status);
+	}
 
-    	if (actual.count > 0) {
-        	panic("Actual output is bigger");
-    	}
+	return ok;
 }
 
-int main(int argc, char **argv) {
-	shift(&argc, &argv);        // skip the program name
+// NOTE: the name of the Err in the file of -ee, ERR_OK when the program has to halt
+static bool read_expected_error(const char *file_path, char *name, size_t name_size, Output_Buffer *report) {
+	snprintf(name, name_size, "%s", err_as_cstr(ERR_OK));
+	if (file_path == NULL) return true;
+
+	FILE *f = fopen(file_path, "r");
+	if (f == NULL) {
+		output_buffer_printf(report, "ERROR: could not open file `%s`: %s\n", file_path, strerror(errno));
+		return false;
+	}
+	const bool has_name = fscanf(f, "%63s", name) == 1;
+	fclose(f);
+	if (!has_name) {
+		output_buffer_printf(report, "%s: ERROR: no Err in the file\n", file_path);
+		return false;
+	}
+	return true;
+}
 
-	const char *program_file_path = NULL;
-	const char *actual_output_file_path = NULL;
-	const char *expected_output_file_path = NULL;
+// NOTE: runs the test on the machine, whatever goes wrong is described in the report
+static bool run_test(const Evmr_Test *test, Evmr_Machine *machine, Output_Buffer *report) {
+	Output_Checker checker = {0};
+	machine->checker = NULL;
+	machine->actual_output = NULL;
+	machine->report = report;
 
-	while (argc > 0) {
-		const char *flag = shift(&argc, &argv);
+	if (test->expected_output_file_path) {
+		if (!output_checker_open(&checker, test->expected_output_file_path, report)) return false;
+		machine->checker = &checker;
+	}
 
-		if (strcmp(flag, "-p") == 0) {
-			program_file_path = parse_cstr_value(flag, &argc, &argv);
-		} else if(strcmp(flag, "-ao") == 0) {
-			actual_output_file_path = parse_cstr_value(flag, &argc, &argv);
-		} else if(strcmp(flag, "-eo") == 0) {
-			expected_output_file_path = parse_cstr_value(flag, &argc, &argv);
-		} else {
-			panic("unknown flag `%s`", flag);
+	if (test->actual_output_file_path) {
+		machine->actual_output = fopen(test->actual_output_file_path, "wb");
+		if (!machine->actual_output) {
+			output_buffer_printf(report, "ERROR: could not save output to file `%s`: %s\n",
+				test->actual_output_file_path, strerror(errno));
+			output_checker_close(&checker);
+			return false;
 		}
 	}
 
-	if (program_file_path == NULL) {
-		usage(stderr);
-		panic("program file path is not provided");
+	char expected_error[64];
+	if (!read_expected_error(test->expected_error_file_path, expected_error, sizeof(expected_error), report)) {
+		if (machine->actual_output) fclose(machine->actual_output);
+		output_checker_close(&checker);
+		return false;
 	}
 
-	if (actual_output_file_path == NULL && expected_output_file_path == NULL) {
-		usage(stderr);
-		panic("at least -ao or -eo is expected");
+	bool ok = true;
+	Err err = ERR_OK;
+	if (test->native_file_path) {
+		ok = run_native_executable(test->native_file_path, machine, &err);
+	} else {
+		memset(&machine->evm, 0, sizeof(machine->evm));
+		char error[1024];
+		if (!evm_try_load_program_from_file(&machine->evm, test->program_file_path, error, sizeof(error))) {
+			output_buffer_printf(report, "%s", error);
+			if (machine->actual_output) fclose(machine->actual_output);
+			output_checker_close(&checker);
+			return false;
+		}
+
+    		evm_push_native(&machine->evm, evmr_write); 	// 0
+    		evm_push_native(&machine->evm, evm_native_clock); 	// 1
+    		evm_push_native(&machine->evm, evm_native_insts); 	// 2
+
+		err = evm_execute_program(&machine->evm, -1);
+		// NOTE: evmr_write halts the program on the first wrong byte
+		if (machine->checker && machine->checker->failed) ok = false;
 	}
 
-	// NOTE: The structures might be quite big due its arena. Better allocate it in the static memory.
-	static EVM evm = {0};
+	if (ok && strcmp(err_as_cstr(err), expected_error) != 0) {
+		const char *file_path = test->native_file_path ? test->native_file_path : test->program_file_path;
+		if (err == ERR_OK) {
+			output_buffer_printf(report, "%s: ERROR: expected the program to stop with %s, but it halted\n", file_path, expected_error);
+		} else if (test->expected_error_file_path) {
+			output_buffer_printf(report, "%s: ERROR: %s, but %s was expected\n", file_path, err_as_cstr(err), expected_error);
+		} else {
+			output_buffer_printf(report, "%s: ERROR: %s\n", file_path, err_as_cstr(err));
+		}
+		ok = false;
+	}
+
+	if (ok && machine->checker) ok = output_checker_finish(machine->checker, report);
+
+	if (machine->actual_output) fclose(machine->actual_output);
+	output_checker_close(&checker);
+	return ok;
+}
+
+typedef struct {
+	Evmr_Test *tests;
+	size_t tests_size;
+	size_t tests_capacity;
+
+	bool *passed;
+	Output_Buffer *reports;
+
+	size_t next;
+	pthread_mutex_t next_lock;
+} Evmr_Suite;
+
+static void parse_suite(Arena *arena, Evmr_Suite *suite, const char *file_path) {
+	String_View source = arena_slurp_file(arena, sv_from_cstr(file_path));
+
+	for (size_t line_number = 1; source.count > 0; ++line_number) {
+		String_View line = sv_trim(sv_chop_by_delim(&source, '\n'));
+		if (line.count == 0) continue;
+
+		Evmr_Test test = {0};
+		while (line.count > 0) {
+			const char *flag = arena_sv_to_cstr(arena, sv_chop_by_delim(&line, ' '));
+			line = sv_trim_left(line);
+			const char **value = test_flag(&test, flag);
+			if (value == NULL) panic("%s:%zu: unknown flag `%s`", file_path, line_number, flag);
+			if (line.count == 0) panic("%s:%zu: no value provided for flag `%s`", file_path, line_number, flag);
+			*value = arena_sv_to_cstr(arena, sv_chop_by_delim(&line, ' '));
+			line = sv_trim_left(line);
+		}
 
-	evm_load_program_from_file(&evm, program_file_path);
+		const char *error = test_error(&test);
+		if (error) panic("%s:%zu: %s", file_path, line_number, error);
 
-    	evm_push_native(&evm, evmr_write); 	// 0
+		EASM_TABLE_RESERVE(suite->tests, suite->tests_size, suite->tests_capacity, 1);
+		suite->tests[suite->tests_size++] = test;
+	}
+}
+
+// NOTE: every thread takes the next test until there are none, with one machine of its own
+// that is reused by all the tests it runs
+static void *suite_worker(void *arg) {
+	Evmr_Suite *suite = arg;
+	Evmr_Machine *machine = calloc(1, sizeof(*machine));
+	if (machine == NULL) panic_errno("could not allocate a machine");
+
+	for (;;) {
+		pthread_mutex_lock(&suite->next_lock);
+		const size_t i = suite->next++;
+		pthread_mutex_unlock(&suite->next_lock);
+		if (i >= suite->tests_size) break;
 
-	Err err = evm_execute_program(&evm, -1);
-	if (err != ERR_OK) {
-		panic(err_as_cstr(err));
+		suite->passed[i] = run_test(&suite->tests[i], machine, &suite->reports[i]);
 	}
 
-	if (actual_output_file_path) {
-		FILE *output_file = fopen(actual_output_file_path, "wb");
-		if (!output_file) {
-			panic_errno("could not save output to file `%s`", output_file);
+	free(machine);
+	return NULL;
+}
+
+static int run_suite(const char *file_path, size_t threads_count) {
+	static Arena suite_arena = {0};
+	static Evmr_Suite suite = {0};
+	parse_suite(&suite_arena, &suite, file_path);
+
+	suite.passed = calloc(suite.tests_size + 1, sizeof(suite.passed[0]));
+	suite.reports = calloc(suite.tests_size + 1, sizeof(suite.reports[0]));
+	if (suite.passed == NULL || suite.reports == NULL) panic_errno("could not allocate the results");
+	pthread_mutex_init(&suite.next_lock, NULL);
+
+	if (threads_count > suite.tests_size) threads_count = suite.tests_size;
+	if (threads_count == 0) threads_count = 1;
+	pthread_t *threads = malloc(sizeof(threads[0]) * threads_count);
+	if (threads == NULL) panic_errno("could not allocate the threads");
+
+	for (size_t i = 0; i < threads_count; ++i) {
+		const int err = pthread_create(&threads[i], NULL, suite_worker, &suite);
+		if (err != 0) {
+			errno = err;
+			panic_errno("could not create a thread");
 		}
+	}
+
+	for (size_t i = 0; i < threads_count; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+
+	size_t failed = 0;
+	for (size_t i = 0; i < suite.tests_size; ++i) {
+		if (suite.passed[i]) continue;
+		failed += 1;
+		const Evmr_Test *test = &suite.tests[i];
+		fprintf(stderr, "FAILED: %s\n", test->program_file_path ? test->program_file_path : test->native_file_path);
+		fwrite(suite.reports[i].data, sizeof(char), suite.reports[i].size, stderr);
+	}
+
+	printf("%zu of %zu tests passed\n", suite.tests_size - failed, suite.tests_size);
+
+	return failed == 0 ? 0 : 1;
+}
 
-		fwrite(actual_arena.buffer, sizeof(actual_arena.buffer[0]),
-		actual_arena.size,
-		output_file);
+int main(int argc, char **argv) {
+	shift(&argc, &argv);        // skip the program name
 
-		if (ferror(output_file)) {
-			panic_errno("could not save output to file `%s`", output_file);
+	Evmr_Test test = {0};
+	const char *suite_file_path = NULL;
+	long threads_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	while (argc > 0) {
+		const char *flag = shift(&argc, &argv);
+		const char **value = test_flag(&test, flag);
+
+		if (value != NULL) {
+			*value = parse_cstr_value(flag, &argc, &argv);
+		} else if (strcmp(flag, "-suite") == 0) {
+			suite_file_path = parse_cstr_value(flag, &argc, &argv);
+		} else if (strcmp(flag, "-j") == 0) {
+			threads_count = atol(parse_cstr_value(flag, &argc, &argv));
+			if (threads_count < 1) panic("-j expects a positive number of threads");
+		} else {
+			panic("unknown flag `%s`", flag);
 		}
+	}
+
+	if (suite_file_path != NULL) {
+		return run_suite(suite_file_path, threads_count > 0 ? (size_t) threads_count : 1);
+	}
 
-		fclose(output_file);
+	const char *error = test_error(&test);
+	if (error) {
+		usage(stderr);
+		panic("%s", error);
 	}
 
-	if (expected_output_file_path) {
-		static Arena expected_arena = {0};
-		String_View expected_output = arena_slurp_file(&expected_arena, sv_from_cstr(expected_output_file_path));
-		String_View actual_output = sv_from_arena(&actual_arena);
+	// NOTE: The structures might be quite big due its arena. Better allocate it in the static memory.
+	static Evmr_Machine machine = {0};
+	Output_Buffer report = {0};
+
+	if (!run_test(&test, &machine, &report)) {
+		fwrite(report.data, sizeof(char), report.size, stderr);
+		exit(1);
+	}
 
-        	compare_outputs(expected_output_file_path, expected_output, actual_output);
+	if (test.expected_output_file_path) {
         	printf("Expected output\n");
 	}
 